@@ -0,0 +1,488 @@
+#include <pthread.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "assetcache.h"
+#include "utils.h"
+#include "pixelbuffer.h"
+#include "resample.h"
+#include "overlayspans.h"
+#include "core.h"
+
+#define DISK_CACHE_MAGIC "IFOVL02"    // Kennung & Version der Dateien im Festplatten-Cache
+
+/**
+ * @brief Identifiziert eine Overlay-Datei in einem bestimmten Zustand & die Zielgröße
+ */
+typedef struct {
+    char path[MAX_FILE_PATH_LEN];
+    int64_t mtimeSeconds;
+    int64_t mtimeNanoseconds;
+    int64_t fileSize;
+    uint32_t width;     // Zielgröße, 0 x 0 für das unskalierte Bild
+    uint32_t height;
+    int32_t skip;       // -1 für das Bild, sonst ausgelassener Wert der Abschnitte eines Rahmens
+} asset_key_t;
+
+typedef struct asset_entry {
+    asset_key_t key;
+    picture_t picture;
+    overlay_spans_t spans;      // Nur bei `key.skip >= 0`, das Bild bleibt dann leer
+    unsigned references;        // Anzahl der ausgegebenen, noch nicht zurückgegebenen Zeiger
+    uint64_t lastUse;
+    struct asset_entry *next;
+} asset_entry_t;
+
+struct asset_cache {
+    pthread_mutex_t lock;
+    asset_entry_t *entries;
+    size_t bytes;               // Summe der Pixeldaten & Abschnitte aller Einträge
+    uint64_t clock;             // Zeitstempel für die LRU-Verdrängung
+    char *diskDirectory;
+    asset_cache_stats_t stats;
+};
+
+/**
+ * @brief Kopf einer Datei im Festplatten-Cache, danach folgen x * y Pixel als color_t
+ */
+typedef struct {
+    char magic[8];
+    asset_key_t key;
+    uint32_t maxColorValue;
+    uint32_t x;
+    uint32_t y;
+    uint8_t format[4];
+} disk_header_t;
+
+static size_t picture_bytes(const picture_t *picture) {
+    return picture_buffer_size(picture) * sizeof(color_t);
+}
+
+static size_t entry_bytes(const asset_entry_t *entry) {
+    return entry->key.skip >= 0 ? overlay_spans_bytes(&entry->spans) : picture_bytes(&entry->picture);
+}
+
+static void free_entry(asset_entry_t *entry) {
+    pixel_buffer_free(entry->picture.pixels);
+    overlay_spans_free(&entry->spans);
+    free(entry);
+}
+
+static bool same_key(const asset_key_t *a, const asset_key_t *b) {
+    return a->mtimeSeconds == b->mtimeSeconds && a->mtimeNanoseconds == b->mtimeNanoseconds
+        && a->fileSize == b->fileSize && a->width == b->width && a->height == b->height && a->skip == b->skip
+        && strcmp(a->path, b->path) == 0;
+}
+
+/**
+ * @brief Bestimmt den Schlüssel einer Datei über stat()
+ *
+ * @return int 0 bei Erfolg, -1 wenn der Pfad zu lang oder die Datei nicht lesbar ist
+ */
+static int make_key(const char *path, uint32_t width, uint32_t height, int32_t skip, asset_key_t *key) {
+    struct stat info;
+    if (strlen(path) >= MAX_FILE_PATH_LEN || stat(path, &info) != 0) {
+        return -1;
+    }
+    memset(key, 0, sizeof(*key));    // Auch die Füllbytes, der Schlüssel wird so in den Festplatten-Cache geschrieben
+    strcpy(key->path, path);
+    key->mtimeSeconds = (int64_t)info.st_mtim.tv_sec;
+    key->mtimeNanoseconds = (int64_t)info.st_mtim.tv_nsec;
+    key->fileSize = (int64_t)info.st_size;
+    key->width = width;
+    key->height = height;
+    key->skip = skip;
+    return 0;
+}
+
+/**
+ * @brief Sucht einen Eintrag & reserviert ihn. Muss mit gehaltenem Lock aufgerufen werden
+ */
+static asset_entry_t *find_entry(asset_cache_t *cache, const asset_key_t *key) {
+    for (asset_entry_t *entry = cache->entries; entry; entry = entry->next) {
+        if (same_key(&entry->key, key)) {
+            entry->references++;
+            entry->lastUse = ++cache->clock;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Verdrängt die am längsten unbenutzten, nicht reservierten Einträge, bis das Budget eingehalten wird
+ *
+ * Muss mit gehaltenem Lock aufgerufen werden.
+ */
+static void evict_entries(asset_cache_t *cache) {
+    while (cache->bytes > ASSET_CACHE_MAX_BYTES) {
+        asset_entry_t **oldest = NULL;
+        for (asset_entry_t **link = &cache->entries; *link; link = &(*link)->next) {
+            if ((*link)->references == 0 && (!oldest || (*link)->lastUse < (*oldest)->lastUse)) {
+                oldest = link;
+            }
+        }
+        if (!oldest) {
+            return;    // Alle Einträge sind in Benutzung
+        }
+        asset_entry_t *entry = *oldest;
+        *oldest = entry->next;
+        cache->bytes -= entry_bytes(entry);
+        free_entry(entry);
+    }
+}
+
+/**
+ * @brief Übernimmt ein Bild oder die Abschnitte eines Rahmens als neuen, reservierten Eintrag
+ *
+ * Haben zwei Threads dasselbe Bild gleichzeitig geladen, wird der vorhandene Eintrag verwendet
+ * & das neue Bild freigegeben.
+ *
+ * @param picture Das Bild (bei `key->skip < 0`)
+ * @param spans Die Abschnitte (bei `key->skip >= 0`)
+ * @return asset_entry_t* Der Eintrag oder NULL bei Speicherproblemen (Bild & Abschnitte werden dann freigegeben)
+ */
+static asset_entry_t *insert_entry(asset_cache_t *cache, const asset_key_t *key, picture_t *picture, overlay_spans_t *spans) {
+    pthread_mutex_lock(&cache->lock);
+    asset_entry_t *entry = find_entry(cache, key);
+    if (entry) {
+        pthread_mutex_unlock(&cache->lock);
+        pixel_buffer_free(picture ? picture->pixels : NULL);
+        overlay_spans_free(spans);
+        return entry;
+    }
+
+    entry = calloc(1, sizeof(asset_entry_t));
+    if (!entry) {
+        pthread_mutex_unlock(&cache->lock);
+        pixel_buffer_free(picture ? picture->pixels : NULL);
+        overlay_spans_free(spans);
+        return NULL;
+    }
+    entry->key = *key;
+    if (picture) {
+        entry->picture = *picture;
+    }
+    if (spans) {
+        entry->spans = *spans;
+    }
+    entry->references = 1;
+    entry->lastUse = ++cache->clock;
+    entry->next = cache->entries;
+    cache->entries = entry;
+    cache->bytes += entry_bytes(entry);
+    evict_entries(cache);
+    pthread_mutex_unlock(&cache->lock);
+    return entry;
+}
+
+static void release_entry(asset_cache_t *cache, asset_entry_t *entry) {
+    pthread_mutex_lock(&cache->lock);
+    entry->references--;
+    evict_entries(cache);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+/**
+ * @brief Dateiname eines Eintrags im Festplatten-Cache (FNV-1a über den Schlüssel)
+ */
+static int disk_cache_path(const asset_cache_t *cache, const asset_key_t *key, char *path, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    const uint8_t *bytes = (const uint8_t *)key;
+    for (size_t i = 0; i < sizeof(*key); i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    int length = snprintf(path, size, "%s/overlay-%016llx-%ux%u.raw", cache->diskDirectory,
+                          (unsigned long long)hash, key->width, key->height);
+    return (length < 0 || (size_t)length >= size) ? -1 : 0;
+}
+
+/**
+ * @brief Liest ein skaliertes Overlay aus dem Festplatten-Cache
+ *
+ * @return int 0 bei Erfolg, -1 wenn kein passender Eintrag existiert, -3 bei Speicherproblemen
+ */
+static int read_disk_cache(const asset_cache_t *cache, const asset_key_t *key, picture_t *picture) {
+    char path[2 * MAX_FILE_PATH_LEN];
+    if (disk_cache_path(cache, key, path, sizeof(path)) != 0) {
+        return -1;
+    }
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return -1;
+    }
+
+    // Der vollständige Schlüssel steht im Kopf, Kollisionen des Dateinamens werden so erkannt
+    disk_header_t header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1;
+    header.key.path[MAX_FILE_PATH_LEN - 1] = '\0';
+    if (!valid || memcmp(header.magic, DISK_CACHE_MAGIC, sizeof(header.magic)) != 0
+        || !same_key(&header.key, key) || header.x == 0 || header.y == 0) {
+        fclose(file);
+        return -1;
+    }
+
+    picture->maxColorValue = header.maxColorValue;
+    memcpy(picture->format, header.format, sizeof(picture->format));
+    picture->x = header.x;
+    picture->y = header.y;
+
+    size_t bufferSize = picture_buffer_size(picture);
+    color_t *pixels = pixel_buffer_alloc(bufferSize);
+    if (!pixels) {
+        fclose(file);
+        return -3;
+    }
+    if (fread(pixels, sizeof(color_t), bufferSize, file) != bufferSize) {
+        pixel_buffer_free(pixels);
+        fclose(file);
+        return -1;
+    }
+    fclose(file);
+    picture->pixels = pixels;
+    return 0;
+}
+
+/**
+ * @brief Schreibt ein skaliertes Overlay in den Festplatten-Cache
+ *
+ * Die Datei wird unter einem temporären Namen geschrieben & dann umbenannt, sodass parallel
+ * laufende Prozesse nie eine halb geschriebene Datei lesen. Fehler werden ignoriert.
+ */
+static void write_disk_cache(const asset_cache_t *cache, const asset_key_t *key, const picture_t *picture) {
+    char path[2 * MAX_FILE_PATH_LEN];
+    char temporaryPath[2 * MAX_FILE_PATH_LEN + 32];
+    if (disk_cache_path(cache, key, path, sizeof(path)) != 0) {
+        return;
+    }
+    snprintf(temporaryPath, sizeof(temporaryPath), "%s.%ld.tmp", path, (long)getpid());
+
+    FILE *file = fopen(temporaryPath, "wb");
+    if (!file) {
+        return;
+    }
+    disk_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DISK_CACHE_MAGIC, sizeof(header.magic));
+    header.key = *key;
+    header.maxColorValue = picture->maxColorValue;
+    header.x = picture->x;
+    header.y = picture->y;
+    memcpy(header.format, picture->format, sizeof(picture->format));
+
+    size_t bufferSize = picture_buffer_size(picture);
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1
+                && fwrite(picture->pixels, sizeof(color_t), bufferSize, file) == bufferSize;
+    if (fclose(file) != 0 || !written || rename(temporaryPath, path) != 0) {
+        remove(temporaryPath);
+    }
+}
+
+/**
+ * @brief Liefert das unskalierte Overlay, lädt es bei Bedarf von der Festplatte
+ */
+static int acquire_decoded(asset_cache_t *cache, const asset_key_t *scaledKey, asset_entry_t **decoded) {
+    asset_key_t key = *scaledKey;
+    key.width = 0;
+    key.height = 0;
+    key.skip = -1;
+
+    pthread_mutex_lock(&cache->lock);
+    *decoded = find_entry(cache, &key);
+    if (*decoded) {
+        pthread_mutex_unlock(&cache->lock);
+        return 0;
+    }
+    cache->stats.decodes++;
+    pthread_mutex_unlock(&cache->lock);
+
+    picture_t picture = {0};
+    int status = load_overlay_from_path(key.path, &picture);
+    if (status) {
+        pixel_buffer_free(picture.pixels);
+        return status;
+    }
+    *decoded = insert_entry(cache, &key, &picture, NULL);
+    return *decoded ? 0 : -3;
+}
+
+asset_cache_t *asset_cache_create(const char *diskDirectory) {
+    asset_cache_t *cache = calloc(1, sizeof(asset_cache_t));
+    if (!cache) {
+        return NULL;
+    }
+    if (diskDirectory && *diskDirectory) {
+        cache->diskDirectory = malloc(strlen(diskDirectory) + 1);
+        if (!cache->diskDirectory) {
+            free(cache);
+            return NULL;
+        }
+        strcpy(cache->diskDirectory, diskDirectory);
+    }
+    if (pthread_mutex_init(&cache->lock, NULL) != 0) {
+        free(cache->diskDirectory);
+        free(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+void asset_cache_destroy(asset_cache_t *cache) {
+    if (!cache) {
+        return;
+    }
+    asset_entry_t *entry = cache->entries;
+    while (entry) {
+        asset_entry_t *next = entry->next;
+        free_entry(entry);
+        entry = next;
+    }
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->diskDirectory);
+    free(cache);
+}
+
+int asset_cache_acquire(asset_cache_t *cache, const char *path, uint32_t width, uint32_t height, const picture_t **overlay) {
+    if (!cache || !path || !overlay || width == 0 || height == 0) {
+        return -1;
+    }
+    asset_key_t key;
+    if (make_key(path, width, height, -1, &key) != 0) {
+        return -1;
+    }
+
+    // 1. Skaliertes Overlay im Speicher
+    pthread_mutex_lock(&cache->lock);
+    asset_entry_t *entry = find_entry(cache, &key);
+    if (entry) {
+        cache->stats.hits++;
+        pthread_mutex_unlock(&cache->lock);
+        *overlay = &entry->picture;
+        return 0;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    // 2. Skaliertes Overlay im Festplatten-Cache
+    picture_t picture = {0};
+    if (cache->diskDirectory && read_disk_cache(cache, &key, &picture) == 0) {
+        entry = insert_entry(cache, &key, &picture, NULL);
+        if (!entry) {
+            return -3;
+        }
+        pthread_mutex_lock(&cache->lock);
+        cache->stats.diskHits++;
+        pthread_mutex_unlock(&cache->lock);
+        *overlay = &entry->picture;
+        return 0;
+    }
+
+    // 3. Dekodiertes Overlay auf die Zielgröße skalieren (nächster Nachbar)
+    asset_entry_t *decoded;
+    int status = acquire_decoded(cache, &key, &decoded);
+    if (status) {
+        return status;
+    }
+    picture = (picture_t){ .x = width, .y = height };
+    status = resample_picture(NULL, SIMD_AUTO, &decoded->picture, &picture, RESAMPLE_NEAREST);
+    release_entry(cache, decoded);
+    if (status) {
+        return status;
+    }
+    if (cache->diskDirectory) {
+        write_disk_cache(cache, &key, &picture);
+    }
+
+    entry = insert_entry(cache, &key, &picture, NULL);
+    if (!entry) {
+        return -3;
+    }
+    pthread_mutex_lock(&cache->lock);
+    cache->stats.misses++;
+    pthread_mutex_unlock(&cache->lock);
+    *overlay = &entry->picture;
+    return 0;
+}
+
+int asset_cache_acquire_spans(asset_cache_t *cache, const char *path, uint32_t width, uint32_t height, uint8_t skip,
+                              const overlay_spans_t **spans) {
+    if (!cache || !path || !spans || width == 0 || height == 0) {
+        return -1;
+    }
+    asset_key_t key;
+    if (make_key(path, width, height, skip, &key) != 0) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    asset_entry_t *entry = find_entry(cache, &key);
+    if (entry) {
+        cache->stats.hits++;
+        pthread_mutex_unlock(&cache->lock);
+        *spans = &entry->spans;
+        return 0;
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    // Die Abschnitte entstehen direkt aus dem unskalierten Overlay, das skalierte Bild wird nicht gebraucht
+    asset_entry_t *decoded;
+    int status = acquire_decoded(cache, &key, &decoded);
+    if (status) {
+        return status;
+    }
+    overlay_spans_t built;
+    status = overlay_spans_build(&decoded->picture, width, height, skip, &built);
+    release_entry(cache, decoded);
+    if (status) {
+        return status;
+    }
+
+    entry = insert_entry(cache, &key, NULL, &built);
+    if (!entry) {
+        return -3;
+    }
+    pthread_mutex_lock(&cache->lock);
+    cache->stats.misses++;
+    pthread_mutex_unlock(&cache->lock);
+    *spans = &entry->spans;
+    return 0;
+}
+
+/**
+ * @brief Gibt den Eintrag zurück, zu dem das Bild oder die Abschnitte `payload` gehören
+ */
+static void release_payload(asset_cache_t *cache, const void *payload) {
+    if (!cache || !payload) {
+        return;
+    }
+    pthread_mutex_lock(&cache->lock);
+    for (asset_entry_t *entry = cache->entries; entry; entry = entry->next) {
+        if ((const void *)&entry->picture == payload || (const void *)&entry->spans == payload) {
+            entry->references--;
+            break;
+        }
+    }
+    evict_entries(cache);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+void asset_cache_release(asset_cache_t *cache, const picture_t *overlay) {
+    release_payload(cache, overlay);
+}
+
+void asset_cache_release_spans(asset_cache_t *cache, const overlay_spans_t *spans) {
+    release_payload(cache, spans);
+}
+
+void asset_cache_get_stats(asset_cache_t *cache, asset_cache_stats_t *stats) {
+    if (!cache || !stats) {
+        return;
+    }
+    pthread_mutex_lock(&cache->lock);
+    *stats = cache->stats;
+    pthread_mutex_unlock(&cache->lock);
+}
\ No newline at end of file
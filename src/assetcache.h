@@ -0,0 +1,99 @@
+#ifndef ASSETCACHE_H
+#define ASSETCACHE_H
+
+#include "core.h"
+#include "overlayspans.h"
+
+#define ASSET_CACHE_MAX_BYTES ((size_t)512 << 20)    // Speicherbudget des Caches, darüber werden alte Einträge verdrängt
+
+typedef struct asset_cache asset_cache_t;
+
+/**
+ * @brief Zähler eines Asset-Caches
+ */
+typedef struct {
+    uint64_t hits;        // Skaliertes Overlay lag bereits im Speicher
+    uint64_t diskHits;    // Skaliertes Overlay wurde aus dem Festplatten-Cache gelesen
+    uint64_t misses;      // Overlay musste skaliert werden
+    uint64_t decodes;     // Overlay-Datei musste geladen & dekodiert werden
+} asset_cache_stats_t;
+
+/**
+ * @brief Erstellt einen Cache für dekodierte & skalierte Overlay-Bilder
+ *
+ * Einträge werden über (Pfad, Änderungszeit, Dateigröße, Zielgröße) gefunden, eine geänderte
+ * Datei wird also automatisch neu geladen. Optional werden skalierte Overlays zusätzlich als
+ * Rohdaten in `diskDirectory` abgelegt & von späteren Prozessen wiederverwendet.
+ *
+ * @param diskDirectory Verzeichnis für den Festplatten-Cache (muss existieren), NULL deaktiviert ihn
+ * @return asset_cache_t* Der neue Cache oder NULL bei Speicherproblemen
+ */
+asset_cache_t *asset_cache_create(const char *diskDirectory);
+
+/**
+ * @brief Gibt den Cache & alle Einträge frei
+ *
+ * @param cache Der Cache, NULL wird ignoriert
+ */
+void asset_cache_destroy(asset_cache_t *cache);
+
+/**
+ * @brief Liefert das Overlay-Bild `path`, skaliert auf ein Zielbild der Größe width x height
+ *
+ * Das Bild gehört dem Cache & bleibt gültig, bis es mit `asset_cache_release()` zurückgegeben wird.
+ * Der Cache ist threadsicher, zurückgegebene Bilder werden nicht verdrängt.
+ *
+ * @param cache Der Cache
+ * @param path Pfad der Overlay-Datei (PPM)
+ * @param width Breite des Zielbildes
+ * @param height Höhe des Zielbildes
+ * @param overlay Erhält das skalierte Overlay-Bild
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben oder nicht lesbarer Datei,
+ *             sonst Fehlercode von `load_picture_from_path()` oder `resample_picture()`
+ */
+int asset_cache_acquire(asset_cache_t *cache, const char *path, uint32_t width, uint32_t height, const picture_t **overlay);
+
+/**
+ * @brief Gibt ein mit `asset_cache_acquire()` geholtes Bild zurück
+ *
+ * @param cache Der Cache
+ * @param overlay Das Bild, NULL wird ignoriert
+ */
+void asset_cache_release(asset_cache_t *cache, const picture_t *overlay);
+
+/**
+ * @brief Liefert die Abschnitte eines Rahmens `path` für ein Zielbild der Größe width x height
+ *
+ * Die Abschnitte werden einmal pro Zielgröße & ausgelassenem Wert aus dem unskalierten Overlay
+ * berechnet (siehe `overlay_spans_build()`), das skalierte Bild wird dafür nicht angelegt. Sie gehören
+ * dem Cache & bleiben gültig, bis sie mit `asset_cache_release_spans()` zurückgegeben werden.
+ *
+ * @param cache Der Cache
+ * @param path Pfad der Overlay-Datei (PPM)
+ * @param width Breite des Zielbildes
+ * @param height Höhe des Zielbildes
+ * @param skip Ausgelassener Wert (0x00 für whiteframe, 0xff für blackframe)
+ * @param spans Erhält die Abschnitte
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben oder nicht lesbarer Datei,
+ *             sonst Fehlercode von `load_picture_from_path()` oder `overlay_spans_build()`
+ */
+int asset_cache_acquire_spans(asset_cache_t *cache, const char *path, uint32_t width, uint32_t height, uint8_t skip,
+                              const overlay_spans_t **spans);
+
+/**
+ * @brief Gibt mit `asset_cache_acquire_spans()` geholte Abschnitte zurück
+ *
+ * @param cache Der Cache
+ * @param spans Die Abschnitte, NULL wird ignoriert
+ */
+void asset_cache_release_spans(asset_cache_t *cache, const overlay_spans_t *spans);
+
+/**
+ * @brief Liest die Zähler des Caches
+ *
+ * @param cache Der Cache
+ * @param stats Erhält die Zähler
+ */
+void asset_cache_get_stats(asset_cache_t *cache, asset_cache_stats_t *stats);
+
+#endif      /* ASSETCACHE_H */
\ No newline at end of file
@@ -0,0 +1,396 @@
+#include <pthread.h>
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "batch.h"
+#include "filters.h"
+#include "utils.h"
+#include "pixelbuffer.h"
+#include "core.h"
+
+/**
+ * @brief Ein Bild des Batch-Laufs mit Pfaden, Ergebnis & Zeiten
+ */
+typedef struct {
+    char *input;
+    char *output;
+    uint32_t x;
+    uint32_t y;
+    int status;                 // 0 bei Erfolg, sonst Fehlercode der Stufe `failedStage`
+    const char *failedStage;
+    double decodeSeconds;
+    double filterSeconds;
+    double encodeSeconds;
+} batch_item_t;
+
+/**
+ * @brief Platz in der Pipeline, der Pixelpuffer wird von Bild zu Bild weitergereicht
+ */
+typedef struct {
+    picture_t picture;
+    size_t capacity;            // Größe von `picture.pixels` in `color_t`-Einheiten
+    batch_item_t *item;
+} batch_slot_t;
+
+/**
+ * @brief Blockierende FIFO-Warteschlange von Pipeline-Plätzen
+ *
+ * Es gibt nur BATCH_SLOTS Plätze, eine Warteschlange kann also nie überlaufen.
+ */
+typedef struct {
+    batch_slot_t *slots[BATCH_SLOTS];
+    unsigned head;
+    unsigned count;
+    bool closed;                // Keine weiteren Plätze, `queue_pop()` liefert danach NULL
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} slot_queue_t;
+
+/**
+ * @brief Gemeinsame Daten der Pipeline-Threads
+ */
+typedef struct {
+    batch_item_t *items;
+    size_t itemCount;
+    slot_queue_t free;          // Leere Plätze für den Decoder
+    slot_queue_t decoded;       // Geladene Bilder für den Filter
+    slot_queue_t filtered;      // Gefilterte Bilder für den Encoder
+} batch_pipeline_t;
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+static int queue_init(slot_queue_t *queue) {
+    memset(queue, 0, sizeof(*queue));
+    if (pthread_mutex_init(&queue->lock, NULL) != 0) {
+        return -3;
+    }
+    if (pthread_cond_init(&queue->changed, NULL) != 0) {
+        pthread_mutex_destroy(&queue->lock);
+        return -3;
+    }
+    return 0;
+}
+
+static void queue_destroy(slot_queue_t *queue) {
+    pthread_cond_destroy(&queue->changed);
+    pthread_mutex_destroy(&queue->lock);
+}
+
+static void queue_push(slot_queue_t *queue, batch_slot_t *slot) {
+    pthread_mutex_lock(&queue->lock);
+    queue->slots[(queue->head + queue->count) % BATCH_SLOTS] = slot;
+    queue->count++;
+    pthread_cond_signal(&queue->changed);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static void queue_close(slot_queue_t *queue) {
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = true;
+    pthread_cond_broadcast(&queue->changed);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * @brief Wartet auf den nächsten Platz
+ *
+ * @return batch_slot_t* Der Platz oder NULL, wenn die Warteschlange geschlossen & leer ist
+ */
+static batch_slot_t *queue_pop(slot_queue_t *queue) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && !queue->closed) {
+        pthread_cond_wait(&queue->changed, &queue->lock);
+    }
+    batch_slot_t *slot = NULL;
+    if (queue->count > 0) {
+        slot = queue->slots[queue->head];
+        queue->head = (queue->head + 1) % BATCH_SLOTS;
+        queue->count--;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return slot;
+}
+
+static void *decode_main(void *argument) {
+    batch_pipeline_t *pipeline = argument;
+    for (size_t i = 0; i < pipeline->itemCount; i++) {
+        batch_slot_t *slot = queue_pop(&pipeline->free);
+        if (!slot) {
+            break;
+        }
+        batch_item_t *item = &pipeline->items[i];
+        slot->item = item;
+
+        double start = now_seconds();
+        item->status = load_picture_reusing(item->input, &slot->picture, &slot->capacity);
+        item->decodeSeconds = now_seconds() - start;
+        if (item->status) {
+            item->failedStage = "decode";
+        }
+        else {
+            item->x = slot->picture.x;
+            item->y = slot->picture.y;
+        }
+        queue_push(&pipeline->decoded, slot);
+    }
+    queue_close(&pipeline->decoded);
+    return NULL;
+}
+
+static void *encode_main(void *argument) {
+    batch_pipeline_t *pipeline = argument;
+    batch_slot_t *slot;
+    while ((slot = queue_pop(&pipeline->filtered)) != NULL) {
+        batch_item_t *item = slot->item;
+        if (item->status == 0) {
+            double start = now_seconds();
+            item->status = generate_file_from_picture(item->output, &slot->picture);
+            item->encodeSeconds = now_seconds() - start;
+            if (item->status) {
+                item->failedStage = "encode";
+            }
+        }
+        queue_push(&pipeline->free, slot);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Verbindet Verzeichnis & Dateiname, `prefix` wird vor den Dateinamen gesetzt
+ */
+static char *join_path(const char *directory, const char *prefix, const char *name) {
+    size_t length = (directory ? strlen(directory) + 1 : 0) + strlen(prefix) + strlen(name) + 1;
+    char *path = malloc(length);
+    if (path) {
+        snprintf(path, length, "%s%s%s%s", directory ? directory : "", directory ? "/" : "", prefix, name);
+    }
+    return path;
+}
+
+/**
+ * @brief Hängt ein Bild an die Liste an & leitet den Ausgabepfad ab
+ *
+ * @return int 0 bei Erfolg, -3 bei Speicherproblemen
+ */
+static int add_item(batch_item_t **items, size_t *count, size_t *capacity, char *input, const char *outputDirectory) {
+    if (*count == *capacity) {
+        size_t newCapacity = *capacity ? *capacity * 2 : 64;
+        batch_item_t *grown = realloc(*items, newCapacity * sizeof(batch_item_t));
+        if (!grown) {
+            free(input);
+            return -3;
+        }
+        *items = grown;
+        *capacity = newCapacity;
+    }
+
+    const char *lastSlash = strrchr(input, '/');
+    const char *name = lastSlash ? lastSlash + 1 : input;
+    char *output = join_path(outputDirectory, outputDirectory ? "" : "new-", name);
+    if (!output) {
+        free(input);
+        return -3;
+    }
+
+    batch_item_t *item = &(*items)[(*count)++];
+    memset(item, 0, sizeof(*item));
+    item->input = input;
+    item->output = output;
+    return 0;
+}
+
+static int compare_items(const void *a, const void *b) {
+    return strcmp(((const batch_item_t *)a)->input, ((const batch_item_t *)b)->input);
+}
+
+/**
+ * @brief Sammelt alle *.ppm-Dateien eines Verzeichnisses, sortiert nach Namen
+ *
+ * @return int 0 bei Erfolg, -2 wenn das Verzeichnis nicht geöffnet werden kann, -3 bei Speicherproblemen
+ */
+static int list_directory(const char *directory, const char *outputDirectory, batch_item_t **items, size_t *count) {
+    DIR *handle = opendir(directory);
+    if (!handle) {
+        return -2;
+    }
+
+    size_t capacity = 0;
+    int status = 0;
+    struct dirent *entry;
+    while (status == 0 && (entry = readdir(handle)) != NULL) {
+        size_t length = strlen(entry->d_name);
+        if (entry->d_name[0] == '.' || length < 5 || strcmp(entry->d_name + length - 4, ".ppm") != 0) {
+            continue;
+        }
+        char *input = join_path(directory, "", entry->d_name);
+        status = input ? add_item(items, count, &capacity, input, outputDirectory) : -3;
+    }
+    closedir(handle);
+
+    if (status == 0 && *count > 1) {
+        qsort(*items, *count, sizeof(batch_item_t), compare_items);
+    }
+    return status;
+}
+
+/**
+ * @brief Liest die Eingabepfade zeilenweise von stdin, leere Zeilen werden übersprungen
+ *
+ * @return int 0 bei Erfolg, -3 bei Speicherproblemen
+ */
+static int list_stdin(const char *outputDirectory, batch_item_t **items, size_t *count) {
+    size_t capacity = 0;
+    char *line = NULL;
+    size_t lineCapacity = 0;
+    ssize_t length;
+    int status = 0;
+
+    while (status == 0 && (length = getline(&line, &lineCapacity, stdin)) != -1) {
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) {
+            line[--length] = '\0';
+        }
+        if (length == 0) {
+            continue;
+        }
+        char *input = join_path(NULL, "", line);
+        status = input ? add_item(items, count, &capacity, input, outputDirectory) : -3;
+    }
+    free(line);
+    return status;
+}
+
+static void print_batch_stats(const batch_item_t *items, size_t count, double wallSeconds) {
+    double decodeSeconds = 0;
+    double filterSeconds = 0;
+    double encodeSeconds = 0;
+    double megapixels = 0;
+    size_t failed = 0;
+
+    printf("\nPer image (decode / filter / encode):\n");
+    for (size_t i = 0; i < count; i++) {
+        const batch_item_t *item = &items[i];
+        if (item->status) {
+            failed++;
+            printf("  %s: FAILED in %s (%d)\n", item->input, item->failedStage, item->status);
+            continue;
+        }
+        printf("  %s -> %s: %ux%u, %.1f / %.1f / %.1f ms\n", item->input, item->output, item->x, item->y,
+               item->decodeSeconds * 1e3, item->filterSeconds * 1e3, item->encodeSeconds * 1e3);
+        decodeSeconds += item->decodeSeconds;
+        filterSeconds += item->filterSeconds;
+        encodeSeconds += item->encodeSeconds;
+        megapixels += (double)item->x * item->y / 1e6;
+    }
+
+    size_t succeeded = count - failed;
+    printf("\nBatch: %zu images, %zu failed, %.1f MP in %.3f s\n", count, failed, megapixels, wallSeconds);
+    if (wallSeconds > 0) {
+        printf("Throughput: %.2f images/s, %.2f MP/s\n", succeeded / wallSeconds, megapixels / wallSeconds);
+    }
+    printf("Stage totals: decode %.3f s, filter %.3f s, encode %.3f s\n", decodeSeconds, filterSeconds, encodeSeconds);
+}
+
+/**
+ * @brief Führt die Pipeline über alle Bilder aus, der aufrufende Thread filtert
+ */
+static int run_pipeline(filter_context_t *context, filter_chain_t *chain, batch_pipeline_t *pipeline, batch_slot_t *slots) {
+    for (unsigned i = 0; i < BATCH_SLOTS; i++) {
+        queue_push(&pipeline->free, &slots[i]);
+    }
+
+    pthread_t decoder;
+    pthread_t encoder;
+    if (pthread_create(&decoder, NULL, decode_main, pipeline) != 0) {
+        return -3;
+    }
+    if (pthread_create(&encoder, NULL, encode_main, pipeline) != 0) {
+        queue_close(&pipeline->free);    // Decoder beenden
+        pthread_join(decoder, NULL);
+        return -3;
+    }
+
+    batch_slot_t *slot;
+    while ((slot = queue_pop(&pipeline->decoded)) != NULL) {
+        batch_item_t *item = slot->item;
+        if (item->status == 0) {
+            color_t *pixels = slot->picture.pixels;
+            double start = now_seconds();
+            item->status = apply_filter_chain(context, chain, &slot->picture);
+            item->filterSeconds = now_seconds() - start;
+            if (item->status) {
+                item->failedStage = "filter";
+            }
+            // Der Filter kann den Puffer mit dem Scratch-Puffer getauscht oder das Bild skaliert haben (resize)
+            if (slot->picture.pixels != pixels) {
+                slot->capacity = pixel_buffer_capacity(slot->picture.pixels);
+            }
+        }
+        queue_push(&pipeline->filtered, slot);
+    }
+    queue_close(&pipeline->filtered);
+
+    pthread_join(decoder, NULL);
+    pthread_join(encoder, NULL);
+    return 0;
+}
+
+int run_batch(filter_context_t *context, filter_chain_t *chain, const batch_options_t *options) {
+    if (!chain || !options) {
+        return -1;
+    }
+    if (options->outputDirectory && mkdir(options->outputDirectory, 0777) != 0 && errno != EEXIST) {
+        return -2;
+    }
+
+    batch_item_t *items = NULL;
+    size_t itemCount = 0;
+    int status = options->inputDirectory
+               ? list_directory(options->inputDirectory, options->outputDirectory, &items, &itemCount)
+               : list_stdin(options->outputDirectory, &items, &itemCount);
+
+    batch_pipeline_t pipeline = { .items = items, .itemCount = itemCount };
+    batch_slot_t slots[BATCH_SLOTS];
+    memset(slots, 0, sizeof(slots));
+    double start = now_seconds();
+
+    if (status == 0 && (status = queue_init(&pipeline.free)) == 0) {
+        if ((status = queue_init(&pipeline.decoded)) == 0) {
+            if ((status = queue_init(&pipeline.filtered)) == 0) {
+                status = run_pipeline(context, chain, &pipeline, slots);
+                queue_destroy(&pipeline.filtered);
+            }
+            queue_destroy(&pipeline.decoded);
+        }
+        queue_destroy(&pipeline.free);
+    }
+
+    if (status == 0) {
+        print_batch_stats(items, itemCount, now_seconds() - start);
+        for (size_t i = 0; i < itemCount; i++) {
+            if (items[i].status) {
+                status = -1;
+            }
+        }
+    }
+
+    for (unsigned i = 0; i < BATCH_SLOTS; i++) {
+        pixel_buffer_free(slots[i].picture.pixels);
+    }
+    for (size_t i = 0; i < itemCount; i++) {
+        free(items[i].input);
+        free(items[i].output);
+    }
+    free(items);
+    return status;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "core.h"
+#include "filters.h"
+
+#define BATCH_SLOTS 4    // Bilder, die gleichzeitig in der Pipeline sein dürfen (Dekodieren, Filtern, Kodieren + 1 Puffer)
+
+/**
+ * @brief Quelle & Ziel eines Batch-Laufs
+ */
+typedef struct {
+    const char *inputDirectory;     // Alle *.ppm-Dateien dieses Verzeichnisses, NULL liest die Pfade zeilenweise von stdin
+    const char *outputDirectory;    // Zielverzeichnis (wird bei Bedarf angelegt), NULL schreibt "new-<name>" ins aktuelle Verzeichnis
+} batch_options_t;
+
+/**
+ * @brief Wendet eine Filterkette auf viele Bilder in einem Prozess an
+ *
+ * Dekodieren, Filtern & Kodieren laufen als Pipeline in drei Threads: während Bild N gefiltert wird,
+ * wird Bild N+1 bereits geladen & Bild N-1 geschrieben. Die Pipeline hält höchstens BATCH_SLOTS Bilder,
+ * deren Pixelpuffer für alle Bilder wiederverwendet werden. Gefiltert wird im aufrufenden Thread mit
+ * dem Kontext (Thread-Pool, Scratch-Puffer, Asset-Cache). Am Ende werden Zeiten pro Bild & der
+ * Gesamtdurchsatz ausgegeben.
+ *
+ * @param context Ausführungsumgebung der Filter, darf NULL sein
+ * @param chain Die Filterkette, die auf jedes Bild angewendet wird
+ * @param options Quelle & Ziel
+ * @return int 0 wenn alle Bilder verarbeitet wurden, -1 bei ungültigen Eingaben oder wenn einzelne Bilder
+ *             fehlgeschlagen sind, -2 wenn das Eingabe- oder Ausgabeverzeichnis nicht geöffnet werden kann,
+ *             -3 bei Speicherproblemen
+ */
+int run_batch(filter_context_t *context, filter_chain_t *chain, const batch_options_t *options);
+
+#endif      /* BATCH_H */
\ No newline at end of file
@@ -0,0 +1,404 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "filters.h"
+#include "utils.h"
+#include "pixelbuffer.h"
+#include "core.h"
+
+#define BENCH_MAX_SIZES 8
+#define BENCH_MAX_RUNS 1000
+
+/**
+ * @brief Ein Messfall: Name, Format & Bildgröße, dazu die gemessenen Laufzeiten
+ */
+typedef struct {
+    const char *name;        // load, encode oder Filtername
+    const char *format;      // P3, P6 oder P6-16 (16 Bit pro Kanal)
+    uint32_t width;
+    uint32_t height;
+    size_t bytes;            // Pro Durchlauf gelesene & geschriebene Bytes (Datei & Pixelpuffer)
+    double *seconds;         // Laufzeit jedes Durchlaufs
+    uint32_t runs;
+} bench_case_t;
+
+typedef struct {
+    uint32_t warmup;         // Nicht gezählte Durchläufe vor der Messung
+    uint32_t runs;           // Gezählte Durchläufe
+    uint32_t sizes[BENCH_MAX_SIZES][2];
+    uint32_t sizeCount;
+    const char *directory;   // Verzeichnis für die erzeugten Testbilder
+    const char *output;      // Ergebnisdatei, "-" für stdout
+    bool json;
+} bench_options_t;
+
+/**
+ * @brief Filter, die gemessen werden, mit den Optionen, die sie brauchen
+ */
+static const char *const benchFilters[] = {
+    "emboss", "blur-median", "blur-light", "blur-medium", "blur-box", "blur-gaussian",
+    "whiteframe", "blackframe", "snowflakes", "hearts", "stars", "overlay", "resize",
+};
+
+static double now_seconds(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+static int compare_seconds(const void *a, const void *b) {
+    double first = *(const double *)a;
+    double second = *(const double *)b;
+    return (first > second) - (first < second);
+}
+
+static size_t file_size(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size > 0 ? (size_t)size : 0;
+}
+
+/**
+ * @brief Füllt ein Bild mit einem reproduzierbaren Muster aus Verläufen & Rauschen
+ *
+ * Reine Verläufe wären für den Median- & Overlay-Pfad zu gutmütig, reines Rauschen für die P3-Kodierung
+ * (immer dreistellige Zahlen), daher eine Mischung aus beidem.
+ */
+static void fill_synthetic(picture_t *picture) {
+    uint32_t state = 0x9e3779b9u;
+    for (uint32_t y = 0; y < picture->y; y++) {
+        for (uint32_t x = 0; x < picture->x; x++) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            uint32_t noise = state & 0x1f;
+            uint32_t red = (x * 255 / picture->x + noise) & 0xff;
+            uint32_t green = (y * 255 / picture->y + (noise >> 1)) & 0xff;
+            uint32_t blue = ((x + y) * 127 / (picture->x + picture->y) + (state >> 27)) & 0xff;
+            if (picture_is_16bit(picture)) {
+                color16_t *pixel = picture_row16(picture, y) + x;
+                pixel->red = (uint16_t)(red * 257 + (state >> 24));
+                pixel->green = (uint16_t)(green * 257);
+                pixel->blue = (uint16_t)(blue * 257);
+                pixel->alpha = 0;
+            }
+            else {
+                color_t *pixel = picture_row(picture, y) + x;
+                pixel->red = (uint8_t)red;
+                pixel->green = (uint8_t)green;
+                pixel->blue = (uint8_t)blue;
+                pixel->alpha = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Erzeugt das Testbild einer Größe im gewünschten Format & schreibt es nach `path`
+ */
+static int write_synthetic(const char *path, const char *format, uint32_t maxColorValue, uint32_t width, uint32_t height) {
+    picture_t picture = { .maxColorValue = maxColorValue, .x = width, .y = height };
+    memcpy(picture.format, format, 2);
+    picture.pixels = pixel_buffer_alloc(picture_buffer_size(&picture));
+    if (!picture.pixels) {
+        return -3;
+    }
+    fill_synthetic(&picture);
+    int status = generate_file_from_picture(path, &picture);
+    pixel_buffer_free(picture.pixels);
+    return status;
+}
+
+/**
+ * @brief Nimmt die Laufzeit eines Durchlaufs auf, Aufwärmdurchläufe werden verworfen
+ */
+static void record(bench_case_t *benchCase, const bench_options_t *options, uint32_t run, double seconds) {
+    if (run >= options->warmup) {
+        benchCase->seconds[benchCase->runs++] = seconds;
+    }
+}
+
+static int bench_load(bench_case_t *benchCase, const bench_options_t *options, const char *path) {
+    for (uint32_t run = 0; run < options->warmup + options->runs; run++) {
+        picture_t picture = {0};
+        double start = now_seconds();
+        int status = load_picture_from_path(path, &picture);
+        record(benchCase, options, run, now_seconds() - start);
+        benchCase->bytes = file_size(path) + picture_buffer_size(&picture) * sizeof(color_t);
+        pixel_buffer_free(picture.pixels);
+        if (status) {
+            return status;
+        }
+    }
+    return 0;
+}
+
+static int bench_encode(bench_case_t *benchCase, const bench_options_t *options, picture_t *picture, const char *path) {
+    for (uint32_t run = 0; run < options->warmup + options->runs; run++) {
+        double start = now_seconds();
+        int status = generate_file_from_picture(path, picture);
+        record(benchCase, options, run, now_seconds() - start);
+        if (status) {
+            return status;
+        }
+    }
+    benchCase->bytes = file_size(path) + picture_buffer_size(picture) * sizeof(color_t);
+    remove(path);
+    return 0;
+}
+
+/**
+ * @brief Misst `apply_filter()` für ein Preset, jeder Durchlauf arbeitet auf einer frischen Kopie des Bildes
+ */
+static int bench_filter(bench_case_t *benchCase, const bench_options_t *options, filter_context_t *context,
+                        const picture_t *source) {
+    filter_descriptor_t filter = { .radius = 4, .sigma = 3.0, .width = 256, .method = RESAMPLE_AREA };
+    set_filter_from_name(&filter, benchCase->name);
+    if (filter.preset == OVERLAY) {
+        strcpy(filter.path, "assets/stars.ppm");
+        set_filter_color(&filter, "blue");
+        filter.useColor = true;
+    }
+
+    size_t bytes = picture_buffer_size(source) * sizeof(color_t);
+    for (uint32_t run = 0; run < options->warmup + options->runs; run++) {
+        picture_t target = *source;
+        target.pixels = pixel_buffer_alloc(picture_buffer_size(source));
+        if (!target.pixels) {
+            return -3;
+        }
+        memcpy(target.pixels, source->pixels, bytes);
+
+        double start = now_seconds();
+        int status = apply_filter(context, &filter, &target);
+        record(benchCase, options, run, now_seconds() - start);
+        benchCase->bytes = bytes + picture_buffer_size(&target) * sizeof(color_t);
+        pixel_buffer_free(target.pixels);
+        if (status) {
+            return status;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Gibt Median, p95 & Durchsatz eines Messfalls als CSV-Zeile oder JSON-Objekt aus
+ */
+static void report(FILE *output, bench_case_t *benchCase, bool json, bool first) {
+    qsort(benchCase->seconds, benchCase->runs, sizeof(double), compare_seconds);
+    double median = benchCase->seconds[benchCase->runs / 2];
+    if (benchCase->runs % 2 == 0) {
+        median = (median + benchCase->seconds[benchCase->runs / 2 - 1]) / 2.0;
+    }
+    uint32_t rank = (benchCase->runs * 95 + 99) / 100;    // Nearest-Rank
+    double p95 = benchCase->seconds[rank > 0 ? rank - 1 : 0];
+    double megapixels = (double)benchCase->width * benchCase->height / 1e6;
+    double mpPerSecond = median > 0 ? megapixels / median : 0.0;
+    double gbPerSecond = median > 0 ? (double)benchCase->bytes / 1e9 / median : 0.0;
+
+    if (json) {
+        fprintf(output, "%s\n  {\"case\": \"%s\", \"format\": \"%s\", \"width\": %u, \"height\": %u, \"runs\": %u, "
+                "\"median_s\": %.6f, \"p95_s\": %.6f, \"mp_per_s\": %.2f, \"gb_per_s\": %.3f}",
+                first ? "" : ",", benchCase->name, benchCase->format, benchCase->width, benchCase->height,
+                benchCase->runs, median, p95, mpPerSecond, gbPerSecond);
+    }
+    else {
+        fprintf(output, "%s,%s,%u,%u,%u,%.6f,%.6f,%.2f,%.3f\n", benchCase->name, benchCase->format,
+                benchCase->width, benchCase->height, benchCase->runs, median, p95, mpPerSecond, gbPerSecond);
+    }
+    fprintf(stderr, "%-14s %-6s %5ux%-5u median %8.4f s  p95 %8.4f s  %8.2f MP/s  %6.3f GB/s\n", benchCase->name,
+            benchCase->format, benchCase->width, benchCase->height, median, p95, mpPerSecond, gbPerSecond);
+}
+
+/**
+ * @brief Misst alle Fälle für eine Bildgröße: Laden & Kodieren je Format, danach jeden Filter auf dem P6-Bild
+ *
+ * @return int 0 bei Erfolg, sonst Fehlercode des ersten fehlgeschlagenen Falls
+ */
+static int bench_size(FILE *output, const bench_options_t *options, filter_context_t *context, uint32_t width,
+                      uint32_t height, bool *first) {
+    static const struct { const char *name; const char *magic; uint32_t maxColorValue; } formats[] = {
+        { "P6", "P6", 255 }, { "P3", "P3", 255 }, { "P6-16", "P6", 65535 },
+    };
+    double *seconds = malloc((options->warmup + options->runs) * sizeof(double));
+    char path[MAX_FILE_PATH_LEN];
+    char outPath[MAX_FILE_PATH_LEN];
+    picture_t picture = {0};
+    int status = seconds ? 0 : -3;
+
+    for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]) && status == 0; i++) {
+        snprintf(path, sizeof(path), "%s/bench-%ux%u-%s.ppm", options->directory, width, height, formats[i].name);
+        snprintf(outPath, sizeof(outPath), "%s/bench-%ux%u-%s-out.ppm", options->directory, width, height, formats[i].name);
+        status = write_synthetic(path, formats[i].magic, formats[i].maxColorValue, width, height);
+
+        bench_case_t load = { .name = "load", .format = formats[i].name, .width = width, .height = height, .seconds = seconds };
+        if (status == 0) {
+            status = bench_load(&load, options, path);
+        }
+        if (status == 0) {
+            report(output, &load, options->json, *first);
+            *first = false;
+            status = load_picture_from_path(path, &picture);
+        }
+
+        bench_case_t encode = { .name = "encode", .format = formats[i].name, .width = width, .height = height, .seconds = seconds };
+        if (status == 0) {
+            status = bench_encode(&encode, options, &picture, outPath);
+        }
+        if (status == 0) {
+            report(output, &encode, options->json, false);
+        }
+
+        // Filter auf dem 8-Bit-Bild aus der P6-Datei
+        for (size_t f = 0; i == 0 && f < sizeof(benchFilters) / sizeof(benchFilters[0]) && status == 0; f++) {
+            bench_case_t filter = { .name = benchFilters[f], .format = formats[i].name, .width = width, .height = height, .seconds = seconds };
+            status = bench_filter(&filter, options, context, &picture);
+            if (status == 0) {
+                report(output, &filter, options->json, false);
+            }
+        }
+        pixel_buffer_free(picture.pixels);
+        picture.pixels = NULL;
+        remove(path);
+    }
+    free(seconds);
+    return status;
+}
+
+/**
+ * @brief Liest eine Liste von Bildgrößen (z.B. "512x512,2048x1536")
+ */
+static int parse_sizes(const char *list, bench_options_t *options) {
+    options->sizeCount = 0;
+    while (*list) {
+        char *end;
+        unsigned long width = strtoul(list, &end, 10);
+        if (*end != 'x' || options->sizeCount == BENCH_MAX_SIZES) {
+            return -1;
+        }
+        unsigned long height = strtoul(end + 1, &end, 10);
+        if (width == 0 || height == 0 || width > UINT32_MAX || height > UINT32_MAX) {
+            return -1;
+        }
+        options->sizes[options->sizeCount][0] = (uint32_t)width;
+        options->sizes[options->sizeCount][1] = (uint32_t)height;
+        options->sizeCount++;
+        list = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') {
+            return -1;
+        }
+    }
+    return options->sizeCount > 0 ? 0 : -1;
+}
+
+static void print_help(void) {
+    printf("\nBenchmark for the codec and filter paths (run from the repository root for the overlay assets)\n");
+    printf("\nOptions:\n");
+    printf("  sizes=<list>     Image sizes, e.g. sizes=512x512,2048x2048 (default: 256x256,1024x1024,4096x4096)\n");
+    printf("  runs=<n>         Measured runs per case (default: 5)\n");
+    printf("  warmup=<n>       Runs before measuring, not counted (default: 1)\n");
+    printf("  threads=<n>      Number of worker threads, 0 uses all CPU cores (default: 1)\n");
+    printf("  simd=<level>     Instruction set for the filter kernels: auto, scalar, sse4, avx2 (default: auto)\n");
+    printf("  format=<format>  Result format: csv or json (default: csv)\n");
+    printf("  out=<filename>   Result file, - for stdout (default: bench.csv or bench.json)\n");
+    printf("  dir=<dir>        Directory for the generated test images (default: /tmp)\n\n");
+}
+
+/**
+ * @brief Hauptfunktion des Benchmarks (`make bench`)
+ *
+ * Erzeugt synthetische P3-, P6- & 16-Bit-P6-Bilder in mehreren Größen & misst Laden, Kodieren & jeden
+ * Filter mit Aufwärm- & Messdurchläufen. Die Ergebnisse (Median, p95, MP/s, GB/s) gehen als CSV oder JSON
+ * in eine Datei, eine Übersicht auf stderr.
+ */
+int main(int argc, char *argv[]) {
+    bench_options_t options = { .warmup = 1, .runs = 5, .directory = "/tmp",
+                                .sizes = { { 256, 256 }, { 1024, 1024 }, { 4096, 4096 } }, .sizeCount = 3 };
+    filter_context_t context = {0};
+    unsigned threads = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (starts_with(arg, "sizes=") == 1) {
+            if (parse_sizes(arg+6, &options) != 0) {
+                printf("Invalid size list: %s\n", arg+6);
+                return -1;
+            }
+        }
+        else if (starts_with(arg, "runs=") == 1) {
+            options.runs = (uint32_t)strtoul(arg+5, NULL, 10);
+        }
+        else if (starts_with(arg, "warmup=") == 1) {
+            options.warmup = (uint32_t)strtoul(arg+7, NULL, 10);
+        }
+        else if (starts_with(arg, "threads=") == 1) {
+            threads = (unsigned)strtoul(arg+8, NULL, 10);
+        }
+        else if (starts_with(arg, "simd=") == 1) {
+            if (simd_level_from_name(arg+5, &context.simd) != 0) {
+                printf("Unknown SIMD level: %s\n", arg+5);
+            }
+        }
+        else if (starts_with(arg, "format=") == 1) {
+            options.json = strcmp(arg+7, "json") == 0;
+        }
+        else if (starts_with(arg, "out=") == 1) {
+            options.output = arg+4;
+        }
+        else if (starts_with(arg, "dir=") == 1) {
+            options.directory = arg+4;
+        }
+        else if (starts_with(arg, "help") == 1) {
+            print_help();
+            return 0;
+        }
+        else {
+            printf("Unknown argument: %s\n", arg);
+        }
+    }
+    if (options.runs == 0 || options.runs > BENCH_MAX_RUNS || options.warmup > BENCH_MAX_RUNS) {
+        printf("runs must be between 1 and %d, warmup at most %d\n", BENCH_MAX_RUNS, BENCH_MAX_RUNS);
+        return -1;
+    }
+    if (!options.output) {
+        options.output = options.json ? "bench.json" : "bench.csv";
+    }
+
+    FILE *output = strcmp(options.output, "-") == 0 ? stdout : fopen(options.output, "w");
+    if (!output) {
+        perror("ERROR opening result file!\n");
+        return -1;
+    }
+    if (threads != 1) {
+        context.pool = thread_pool_create(threads);
+    }
+    context.assets = asset_cache_create(NULL);    // Wie im Programm: Overlays werden nur einmal geladen & skaliert
+
+    fprintf(output, options.json ? "[" : "case,format,width,height,runs,median_s,p95_s,mp_per_s,gb_per_s\n");
+    bool first = true;
+    int status = 0;
+    for (uint32_t i = 0; i < options.sizeCount && status == 0; i++) {
+        status = bench_size(output, &options, &context, options.sizes[i][0], options.sizes[i][1], &first);
+    }
+    if (options.json) {
+        fprintf(output, "\n]\n");
+    }
+    if (status != 0) {
+        fprintf(stderr, "Benchmark failed: %d\n", status);
+    }
+
+    if (output != stdout && fclose(output) != 0 && status == 0) {
+        status = -3;
+    }
+    filter_context_release(&context);
+    return status;
+}
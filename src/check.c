@@ -0,0 +1,372 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "filters.h"
+#include "kernels.h"
+#include "threadpool.h"
+#include "assetcache.h"
+#include "utils.h"
+#include "pixelbuffer.h"
+#include "core.h"
+
+#define CHECK_ALPHA_OVERLAY "/tmp/imagefilter-check-overlay.pam"
+
+/**
+ * @brief Ein Prüffall: Filterkette mit den Optionen, die sie braucht
+ */
+typedef struct {
+    const char *filters;     // Kommagetrennte Filternamen wie bei `filter=`
+    const char *color;       // color=, NULL ohne Farbe
+    const char *overlay;     // ff=, NULL für die Presets
+    resample_method_t method;
+} check_case_t;
+
+static const check_case_t checkCases[] = {
+    { "emboss", NULL, NULL, RESAMPLE_AREA },
+    { "blur-light", NULL, NULL, RESAMPLE_AREA },
+    { "blur-medium", NULL, NULL, RESAMPLE_AREA },
+    { "blur-median", NULL, NULL, RESAMPLE_AREA },
+    { "blur-box", NULL, NULL, RESAMPLE_AREA },
+    { "blur-gaussian", NULL, NULL, RESAMPLE_AREA },
+    { "whiteframe", NULL, NULL, RESAMPLE_AREA },
+    { "blackframe", NULL, NULL, RESAMPLE_AREA },
+    { "hearts", NULL, NULL, RESAMPLE_AREA },
+    { "stars", "red", NULL, RESAMPLE_AREA },
+    { "snowflakes", "blue", NULL, RESAMPLE_AREA },
+    { "overlay", "green", "assets/stars.ppm", RESAMPLE_AREA },
+    { "overlay", NULL, CHECK_ALPHA_OVERLAY, RESAMPLE_AREA },
+    { "overlay", "red", CHECK_ALPHA_OVERLAY, RESAMPLE_AREA },
+    { "emboss,whiteframe,hearts", NULL, NULL, RESAMPLE_AREA },
+    { "blackframe,stars", "blue", NULL, RESAMPLE_AREA },
+    { "resize", NULL, NULL, RESAMPLE_NEAREST },
+    { "resize", NULL, NULL, RESAMPLE_BILINEAR },
+    { "resize", NULL, NULL, RESAMPLE_AREA },
+    { "resize", NULL, NULL, RESAMPLE_LANCZOS3 },
+};
+
+/**
+ * @brief Ungerade Größen, damit jeder SIMD-Kernel seinen skalaren Rest & die Bildränder durchläuft
+ */
+static const uint32_t checkSizes[][2] = { { 37, 23 }, { 1, 9 }, { 70, 1 } };
+
+static const simd_level_t checkLevels[] = { SIMD_SCALAR, SIMD_SSE41, SIMD_AVX2 };
+
+typedef struct {
+    uint32_t cases;
+    uint32_t failed;
+    uint32_t skipped;
+} check_totals_t;
+
+/**
+ * @brief Füllt ein Bild mit reproduzierbarem Rauschen, bei Bildern mit Alphakanal auch Alpha
+ *
+ * Ein Teil der Pixel ist rein weiß oder schwarz, damit die Rahmen & die Sprünge der Overlays
+ * auch innerhalb eines SIMD-Blocks wechseln.
+ */
+static void fill_noise(picture_t *picture, uint32_t seed) {
+    uint32_t state = 0x9e3779b9u ^ seed;
+    for (uint32_t y = 0; y < picture->y; y++) {
+        for (uint32_t x = 0; x < picture->x; x++) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            if (picture_is_16bit(picture)) {
+                color16_t *pixel = picture_row16(picture, y) + x;
+                pixel->red = (uint16_t)(state % (picture->maxColorValue + 1));
+                pixel->green = (uint16_t)((state >> 7) % (picture->maxColorValue + 1));
+                pixel->blue = (uint16_t)((state >> 13) % (picture->maxColorValue + 1));
+                pixel->alpha = 0;
+                continue;
+            }
+            color_t *pixel = picture_row(picture, y) + x;
+            uint8_t level = (state & 0x300) == 0 ? 0x00 : (state & 0x300) == 0x100 ? 0xff : 0;
+            bool flat = (state & 0x300) != 0x300 && (state & 0x400);
+            pixel->red = flat ? level : (uint8_t)state;
+            pixel->green = flat ? level : (uint8_t)(state >> 8);
+            pixel->blue = flat ? level : (uint8_t)(state >> 16);
+            uint8_t alpha = (uint8_t)(state >> 24);
+            pixel->alpha = !picture_has_alpha(picture) ? 0xff : (state & 0x800) ? 0x00 : (state & 0x1000) ? 0xff : alpha;
+        }
+    }
+}
+
+static int create_picture(picture_t *picture, const char *format, uint32_t maxColorValue, uint32_t width, uint32_t height) {
+    *picture = (picture_t){ .maxColorValue = maxColorValue, .x = width, .y = height };
+    memcpy(picture->format, format, 2);
+    picture->pixels = pixel_buffer_alloc(picture_buffer_size(picture));
+    return picture->pixels ? 0 : -3;
+}
+
+static int copy_picture(const picture_t *source, picture_t *copy) {
+    *copy = *source;
+    copy->pixels = pixel_buffer_alloc(picture_buffer_size(source));
+    if (!copy->pixels) {
+        return -3;
+    }
+    memcpy(copy->pixels, source->pixels, picture_buffer_size(source) * sizeof(color_t));
+    return 0;
+}
+
+static bool same_pixels(const picture_t *a, const picture_t *b) {
+    return a->x == b->x && a->y == b->y
+           && memcmp(a->pixels, b->pixels, picture_buffer_size(a) * sizeof(color_t)) == 0;
+}
+
+/**
+ * @brief Farbkanäle zweier 8-Bit-Bilder gleich, Alpha wird nicht verglichen
+ */
+static bool same_colors(const picture_t *a, const picture_t *b) {
+    if (a->x != b->x || a->y != b->y) {
+        return false;
+    }
+    for (size_t i = 0; i < (size_t)a->x * a->y; i++) {
+        if (a->pixels[i].red != b->pixels[i].red || a->pixels[i].green != b->pixels[i].green
+            || a->pixels[i].blue != b->pixels[i].blue) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Wendet einen Prüffall auf eine Kopie von `source` an
+ */
+static int run_chain(filter_context_t *context, const check_case_t *check, const picture_t *source, picture_t *result) {
+    filter_descriptor_t options = { .radius = 2, .sigma = 1.5, .width = 19, .height = 11, .method = check->method };
+    if (check->color) {
+        set_filter_color(&options, check->color);
+        options.useColor = true;
+    }
+    if (check->overlay) {
+        strcpy(options.path, check->overlay);
+    }
+    filter_chain_t chain;
+    if (build_filter_chain(&chain, &options, check->filters) != 0 || copy_picture(source, result) != 0) {
+        return -1;
+    }
+    int status = apply_filter_chain(context, &chain, result);
+    if (status != 0) {
+        pixel_buffer_free(result->pixels);
+        result->pixels = NULL;
+    }
+    return status;
+}
+
+/**
+ * @brief Wie `run_chain()`, aber auf einem planaren Bild, das Ergebnis wird wieder gepackt
+ *
+ * @return int 0 bei Erfolg, -2 wenn die Kette nicht planar ausgeführt werden kann, sonst Fehlercode
+ */
+static int run_chain_planar(filter_context_t *context, const check_case_t *check, const picture_t *source, picture_t *result) {
+    filter_descriptor_t options = { .radius = 2, .sigma = 1.5, .method = check->method };
+    if (check->color) {
+        set_filter_color(&options, check->color);
+        options.useColor = true;
+    }
+    if (check->overlay) {
+        strcpy(options.path, check->overlay);
+    }
+    filter_chain_t chain;
+    if (build_filter_chain(&chain, &options, check->filters) != 0) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < chain.count; i++) {
+        if (chain.stages[i].preset == RESIZE) {
+            return -2;
+        }
+    }
+
+    planar_t planar = { .maxColorValue = source->maxColorValue, .x = source->x, .y = source->y };
+    size_t count;
+    if (planar_buffer_size(source->x, source->y, &count) != 0) {
+        return -1;
+    }
+    color_t *buffer = pixel_buffer_alloc(count);
+    if (!buffer) {
+        return -3;
+    }
+    planar_attach(&planar, buffer);
+    for (uint32_t y = 0; y < source->y; y++) {
+        const color_t *in = picture_row(source, y);
+        for (uint32_t x = 0; x < source->x; x++) {
+            planar_row(&planar, 0, y)[x] = in[x].red;
+            planar_row(&planar, 1, y)[x] = in[x].green;
+            planar_row(&planar, 2, y)[x] = in[x].blue;
+        }
+    }
+
+    int status = apply_filter_chain_planar(context, &chain, &planar);
+    if (status == 0) {
+        status = copy_picture(source, result);
+    }
+    for (uint32_t y = 0; status == 0 && y < source->y; y++) {
+        color_t *out = picture_row(result, y);
+        for (uint32_t x = 0; x < source->x; x++) {
+            out[x].red = planar_row(&planar, 0, y)[x];
+            out[x].green = planar_row(&planar, 1, y)[x];
+            out[x].blue = planar_row(&planar, 2, y)[x];
+        }
+    }
+    pixel_buffer_free(planar.buffer);
+    return status;
+}
+
+static const char *method_name(resample_method_t method) {
+    switch (method) {
+        case RESAMPLE_NEAREST:
+            return "nearest";
+        case RESAMPLE_BILINEAR:
+            return "bilinear";
+        case RESAMPLE_LANCZOS3:
+            return "lanczos3";
+        default:
+            return "area";
+    }
+}
+
+static void report(check_totals_t *totals, bool passed, const char *what, const check_case_t *check, const picture_t *source) {
+    totals->cases++;
+    if (!passed) {
+        totals->failed++;
+        printf("FAIL %s: filter=%s%s%s%s%s method=%s on %s %ux%u (max %u)\n", what, check->filters,
+               check->color ? " color=" : "", check->color ? check->color : "",
+               check->overlay ? " ff=" : "", check->overlay ? check->overlay : "",
+               method_name(check->method), source->format, source->x, source->y, source->maxColorValue);
+    }
+}
+
+/**
+ * @brief Prüft einen Fall auf einem Bild: alle Befehlssätze, Threads, Asset-Cache & Layouts gegen die skalare Referenz
+ *
+ * Die Referenz läuft skalar, seriell & ohne Asset-Cache (Rahmen über die Zeilenkernel statt über die
+ * Abschnitte). Bilder mit Alphakanal müssen ihren Alphakanal behalten & dieselben Farben liefern
+ * wie dasselbe Bild als P6.
+ */
+static void check_picture(check_totals_t *totals, const check_case_t *check, const picture_t *source,
+                          thread_pool_t *pool, asset_cache_t *assets) {
+    filter_context_t reference = { .simd = SIMD_SCALAR };
+    picture_t expected;
+    if (run_chain(&reference, check, source, &expected) != 0) {
+        report(totals, false, "scalar reference", check, source);
+        filter_context_release(&reference);
+        return;
+    }
+
+    for (size_t l = 0; l < sizeof(checkLevels) / sizeof(checkLevels[0]); l++) {
+        if (get_row_kernels(checkLevels[l])->level != checkLevels[l]) {
+            totals->skipped++;    // Vom Prozessor nicht unterstützt
+            continue;
+        }
+        for (int variant = 0; variant < 4; variant++) {
+            filter_context_t context = { .simd = checkLevels[l], .pool = (variant & 1) ? pool : NULL,
+                                         .assets = (variant & 2) ? assets : NULL };
+            char what[64];
+            snprintf(what, sizeof(what), "simd=%s%s%s", simd_level_name(checkLevels[l]),
+                     (variant & 1) ? " threads=3" : "", (variant & 2) ? " asset cache" : "");
+            picture_t result;
+            int status = run_chain(&context, check, source, &result);
+            report(totals, status == 0 && same_pixels(&expected, &result), what, check, source);
+            pixel_buffer_free(result.pixels);
+
+            // layout=planar gilt nur für RGB-Bilder mit 8 Bit pro Kanal
+            if (!picture_is_16bit(source) && !picture_has_alpha(source)) {
+                status = run_chain_planar(&context, check, source, &result);
+                if (status != -2) {
+                    snprintf(what, sizeof(what), "layout=planar simd=%s%s%s", simd_level_name(checkLevels[l]),
+                             (variant & 1) ? " threads=3" : "", (variant & 2) ? " asset cache" : "");
+                    report(totals, status == 0 && same_colors(&expected, &result), what, check, source);
+                    pixel_buffer_free(result.pixels);
+                }
+            }
+            context.pool = NULL;
+            context.assets = NULL;
+            filter_context_release(&context);
+        }
+    }
+
+    if (picture_has_alpha(source)) {
+        picture_t opaque;
+        picture_t colors;
+        bool passed = copy_picture(source, &opaque) == 0;
+        if (passed) {
+            memcpy(opaque.format, "P6", 2);
+            passed = run_chain(&reference, check, &opaque, &colors) == 0;
+            pixel_buffer_free(opaque.pixels);
+        }
+        if (passed) {
+            passed = same_colors(&expected, &colors);
+            pixel_buffer_free(colors.pixels);
+        }
+        // resize erzeugt neue Pixel, dort wird nur die Farbe verglichen
+        for (size_t i = 0; passed && expected.x == source->x && expected.y == source->y
+                           && i < (size_t)source->x * source->y; i++) {
+            passed = expected.pixels[i].alpha == source->pixels[i].alpha;
+        }
+        report(totals, passed, "alpha kept, colors as P6", check, source);
+    }
+    pixel_buffer_free(expected.pixels);
+    filter_context_release(&reference);
+}
+
+/**
+ * @brief Schreibt ein Overlay mit Alphakanal (durchsichtige, halbdurchsichtige & deckende Pixel)
+ */
+static int write_alpha_overlay(const char *path) {
+    picture_t overlay;
+    if (create_picture(&overlay, "P7", 255, 29, 13) != 0) {
+        return -3;
+    }
+    fill_noise(&overlay, 7);
+    int status = generate_file_from_picture(path, &overlay);
+    pixel_buffer_free(overlay.pixels);
+    return status;
+}
+
+/**
+ * @brief Hauptfunktion der Prüfung (`make check`)
+ *
+ * Wendet jeden Filter auf Bilder ungerader Größe (P6, PAM mit Alphakanal, 16 Bit) mit jedem vom
+ * Prozessor unterstützten Befehlssatz, seriell & mit Threads, mit & ohne Asset-Cache sowie planar an
+ * & vergleicht die Ergebnisse bitgenau mit der skalaren Ausführung. Muss aus dem Wurzelverzeichnis
+ * laufen, damit die Overlay-Vorlagen gefunden werden.
+ *
+ * @return int 0 wenn alle Fälle übereinstimmen, sonst 1
+ */
+int main(void) {
+    if (write_alpha_overlay(CHECK_ALPHA_OVERLAY) != 0) {
+        printf("Could not write %s\n", CHECK_ALPHA_OVERLAY);
+        return 1;
+    }
+    thread_pool_t *pool = thread_pool_create(3);
+    asset_cache_t *assets = asset_cache_create(NULL);
+    check_totals_t totals = {0};
+
+    const struct {
+        const char *format;
+        uint32_t maxColorValue;
+    } formats[] = { { "P6", 255 }, { "P7", 255 }, { "P6", 1023 } };
+    for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        for (size_t s = 0; s < sizeof(checkSizes) / sizeof(checkSizes[0]); s++) {
+            picture_t source;
+            if (create_picture(&source, formats[f].format, formats[f].maxColorValue, checkSizes[s][0], checkSizes[s][1]) != 0) {
+                totals.failed++;
+                continue;
+            }
+            fill_noise(&source, (uint32_t)(f * 31 + s));
+            for (size_t c = 0; c < sizeof(checkCases) / sizeof(checkCases[0]); c++) {
+                check_picture(&totals, &checkCases[c], &source, pool, assets);
+            }
+            pixel_buffer_free(source.pixels);
+        }
+    }
+
+    asset_cache_destroy(assets);
+    thread_pool_destroy(pool);
+    remove(CHECK_ALPHA_OVERLAY);
+    pixel_buffer_trim();
+    printf("%u cases, %u failed, %u skipped (instruction set not supported)\n", totals.cases, totals.failed, totals.skipped);
+    return totals.failed ? 1 : 0;
+}
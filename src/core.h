@@ -9,6 +9,7 @@
 
 #define MAX_FILE_PATH_LEN 512
 #define EPSILON 0.0001
+#define IO_CHUNK_PIXELS 65536    // Pixel pro Block beim Lesen/Schreiben von Bilddaten
 
 typedef struct {
     uint8_t red;
@@ -17,17 +18,64 @@ typedef struct {
     uint8_t alpha;
 } color_t; 
 
+/**
+ * @brief Pixel mit 16 Bit pro Kanal für Bilder mit maxColorValue > 255
+ */
+typedef struct {
+    uint16_t red;
+    uint16_t green;
+    uint16_t blue;
+    uint16_t alpha;
+} color16_t;
+
 typedef struct {
     uint32_t maxColorValue; 
     uint8_t format[3];
     uint32_t x;         // Breite 
     uint32_t y;         // Höhe
-    color_t *pixels;    
+    color_t *pixels;    // Bei maxColorValue > 255 liegen hier color16_t-Pixel, siehe `picture_row16()`
 } picture_t; 
 
+/**
+ * @brief Bild mit getrennten Farbebenen (planar) für Bilder mit 8 Bit pro Kanal
+ *
+ * Rot, Grün & Blau liegen jeweils als eigene Ebene mit `stride` Bytes pro Zeile vor. `stride` ist 
+ * auf eine Cachezeile aufgerundet, damit jede Zeile jeder Ebene ausgerichtet beginnt. Alle drei Ebenen 
+ * liegen hintereinander in einem Puffer von `pixel_buffer_alloc()`, siehe `planar_attach()`.
+ */
 typedef struct {
-    float x; 
-    float y; 
-} scale_t;
+    uint32_t maxColorValue;
+    uint8_t format[3];
+    uint32_t x;             // Breite
+    uint32_t y;             // Höhe
+    size_t stride;          // Bytes pro Zeile einer Ebene
+    uint8_t *planes[3];     // Rot, Grün, Blau
+    color_t *buffer;        // Gemeinsamer Puffer der Ebenen
+} planar_t;
+
+/**
+ * @brief Gepackte RGB-Pixel mit 8 Bit pro Kanal, z.B. die Pixeldaten einer in den Speicher abgebildeten P6-Datei
+ *
+ * Jede Zeile besteht aus `x` RGB-Tripeln ohne Abstand, der Speicher gehört dem Aufrufer.
+ */
+typedef struct {
+    uint32_t maxColorValue;
+    uint32_t x;             // Breite
+    uint32_t y;             // Höhe
+    uint8_t *bytes;         // 3 * x * y Bytes
+} packed_t;
+
+/**
+ * @brief Art einer Diagnosemeldung
+ */
+typedef enum {
+    LOG_INFO,       // Fortschritt, z.B. angelegte Puffer
+    LOG_ERROR       // Ursache eines Fehlers, der zusätzlich als Rückgabewert gemeldet wird
+} log_level_t;
+
+/**
+ * @brief Empfänger der Diagnosemeldungen, `message` endet mit einem Zeilenumbruch
+ */
+typedef void (*log_handler_t)(log_level_t level, const char *message);
 
 #endif      /* CORE_H */
\ No newline at end of file
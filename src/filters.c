@@ -2,297 +2,2553 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <math.h>
 
 #include "filters.h"
+#include "kernels.h"
+#include "overlayspans.h"
+#include "threadpool.h"
 #include "utils.h"
+#include "pixelbuffer.h"
+#include "stats.h"
 #include "core.h"
 
-int apply_emboss(const filter_descriptor_t *filter, picture_t *target) {    
+#define BAND_ROWS 16           // Zeilen pro Teilauftrag für den Thread-Pool
+#define PLANAR_BAND_ROWS 64    // Bänder der planaren separierbaren Blurs: eine volle Cachezeile pro transponierter Spalte
+
+typedef struct band_job band_job_t;
+
+#define BOX_PASSES_MAX 3    // Anzahl Boxfilter, mit denen der Gauß-Filter angenähert wird
+
+/**
+ * @brief Folge von Boxfiltern, die nacheinander auf jede Zeile angewendet werden
+ */
+typedef struct {
+    uint32_t passes;
+    uint32_t radius[BOX_PASSES_MAX];
+} box_plan_t;
+
+/**
+ * @brief Pixelweise Stufe einer Filterkette, die mit anderen Stufen in einem Durchlauf ausgeführt wird
+ */
+typedef struct {
+    filter_descriptor_t *filter;
+    const picture_t *overlay;    // Skaliertes Overlay-Bild der Stufe (aus dem Asset-Cache oder `owned`)
+    const overlay_spans_t *spans;    // Stattdessen die Abschnitte eines Rahmens aus dem Asset-Cache
+    picture_t owned;
+} pixel_stage_t;
+
+/**
+ * @brief Bearbeitet die Zeilen [rowStart, rowEnd) eines Bildes
+ *
+ * `thread` ist die Nummer des ausführenden Threads & wählt den threadlokalen Arbeitsspeicher `job->workspace`.
+ */
+typedef void (*band_kernel_t)(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread);
+
+/**
+ * @brief Gemeinsame Daten aller Zeilenbänder eines Filterdurchlaufs
+ */
+struct band_job {
+    band_kernel_t kernel;
+    const picture_t *source;              // Unverändertes Eingabebild (liefert auch die Halo-Zeilen)
+    picture_t *target;                    // Zielbild, jedes Band schreibt alle Pixel seiner eigenen Zeilen
+    const filter_descriptor_t *filter;
+    const picture_t *overlay;             // Skaliertes Overlay-Bild (nur für apply_overlay)
+    const overlay_spans_t *spans;         // Oder die Abschnitte eines Rahmens (nur für apply_overlay)
+    const row_kernels_t *kernels;         // Zeilenkernel (Skalar, SSE4.1 oder AVX2) für das Bildinnere
+    const box_plan_t *boxPlan;            // Boxfilter der separierbaren Blurs
+    color_t *workspace;                   // Threadlokaler Arbeitsspeicher, `workspaceStride` Pixel pro Thread
+    size_t workspaceStride;
+    const pixel_stage_t *stages;          // Zusammengelegte Overlay-Stufen (nur für Filterketten)
+    uint32_t stageCount;
+    const planar_t *planarSource;         // Planare Variante von `source` & `target` (nur planare Kernel)
+    planar_t *planarTarget;
+    const packed_t *packedTarget;         // Gepackte RGB-Zeilen (nur `apply_filter_chain_packed()`)
+    uint32_t bandRows;                    // Zeilen pro Band, 0 für BAND_ROWS
+    uint32_t firstRow;                    // Erste zu bearbeitende Zeile (Streaming), sonst 0
+    uint32_t rows;                        // Ende des zu bearbeitenden Zeilenbereichs
+};
+
+static void run_band(void *argument, uint32_t index, unsigned thread) {
+    const band_job_t *job = argument;
+    uint32_t bandRows = job->bandRows ? job->bandRows : BAND_ROWS;
+    uint32_t rowStart = job->firstRow + index * bandRows;
+    uint32_t rowEnd = rowStart + bandRows;
+    if (rowEnd > job->rows) {
+        rowEnd = job->rows;
+    }
+    job->kernel(job, rowStart, rowEnd, thread);
+}
+
+/**
+ * @brief Teilt das Bild in Bänder zu BAND_ROWS (oder `job->bandRows`) Zeilen & verteilt sie auf den Thread-Pool des Kontexts
+ *
+ * Die Bandgrenzen hängen nicht von der Threadanzahl ab. Da Nachbarschaftsfilter aus `job->source` 
+ * lesen und nur ihre eigenen Zeilen in `job->target` schreiben, ist das Ergebnis für jede 
+ * Threadanzahl identisch zur seriellen Ausführung.
+ *
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben
+ */
+static int run_in_bands(filter_context_t *context, band_job_t *job) {
+    uint32_t bandRows = job->bandRows ? job->bandRows : BAND_ROWS;
+    uint32_t bandCount = (job->rows - job->firstRow + bandRows - 1) / bandRows;
+    return thread_pool_run(context ? context->pool : NULL, bandCount, run_band, job);
+}
+
+/**
+ * @brief Vergrößert den Scratch-Puffer des Kontexts bei Bedarf auf mindestens `numPixels` Pixel
+ *
+ * @return int 0 bei Erfolg, -3 bei Speicherproblemen
+ */
+static int reserve_scratch(filter_context_t *context, size_t numPixels) {
+    if (context->scratchCapacity >= numPixels) {
+        return 0;
+    }
+    return pixel_buffer_reserve(&context->scratch, &context->scratchCapacity, numPixels);
+}
+
+/**
+ * @brief Führt einen vorbereiteten Job von `target` in den Scratch-Puffer aus & tauscht danach die Puffer
+ *
+ * Setzt `source`, `target`, `kernels` & `rows` des Jobs, die übrigen Felder kommen vom Aufrufer.
+ *
+ * @return int 0 bei Erfolg, -3 bei Speicherproblemen
+ */
+static int run_into_scratch(filter_context_t *context, band_job_t *job, picture_t *target) {
+    size_t numPixels = picture_buffer_size(target);
+    filter_context_t local = {0};
+    if (!context) {
+        context = &local;    // Ohne Kontext wird ein temporärer Scratch-Puffer verwendet
+    }
+    if (reserve_scratch(context, numPixels) != 0) {
+        return -3;
+    }
+
+    picture_t destination = *target;
+    destination.pixels = context->scratch;
+    job->source = target;
+    job->target = &destination;
+    job->kernels = get_row_kernels(context->simd);
+    job->rows = target->y;
+    int status = run_in_bands(context, job);
+    if (status) {
+        pixel_buffer_free(local.scratch);
+        return status;
+    }
+
+    // Puffer tauschen
+    context->scratch = target->pixels;
+    context->scratchCapacity = numPixels;
+    target->pixels = destination.pixels;
+    pixel_buffer_free(local.scratch);
+    return 0;
+}
+
+/**
+ * @brief Führt einen Nachbarschaftsfilter außerhalb des Bildes aus (Double-Buffering)
+ *
+ * Der Kernel liest aus dem unveränderten `target` & schreibt in den Scratch-Puffer des Kontexts.
+ * Anschließend werden die Puffer getauscht: das Ergebnis wird zum Bild, der alte Eingabepuffer 
+ * zum Scratch-Puffer für den nächsten Filter. Im Modus `legacyInPlace` läuft der Kernel wie früher 
+ * seriell direkt auf `target`, wobei er bereits überschriebene Nachbarn liest (nur bei `allowInPlace`, 
+ * 16-Bit-Bilder werden immer außerhalb des Bildes gefiltert).
+ *
+ * @return int 0 bei Erfolg, -3 bei Speicherproblemen
+ */
+static int run_out_of_place(filter_context_t *context, band_kernel_t kernel, const filter_descriptor_t *filter, 
+                            bool allowInPlace, picture_t *target) {
+    if (context && context->legacyInPlace && allowInPlace && !picture_is_16bit(target)) {
+        band_job_t job = { .kernel = kernel, .source = target, .target = target, .filter = filter, 
+                           .kernels = get_row_kernels(SIMD_SCALAR), .rows = target->y };
+        kernel(&job, 0, job.rows, 0);    // Ein einziges Band, damit die Scanreihenfolge erhalten bleibt
+        return 0;
+    }
+
+    band_job_t job = { .kernel = kernel, .filter = filter };
+    return run_into_scratch(context, &job, target);
+}
+
+/**
+ * @brief Emboss-Wert eines Kanals im Wertebereich 0..maxColorValue
+ *
+ * Entspricht `(uint8_t)(next - prev + 128)` bei 8 Bit: der Versatz ist der halbe Wertebereich, 
+ * Über- & Unterläufe werden modulo `range` umgebrochen.
+ */
+static inline uint16_t emboss_sample16(int32_t next, int32_t prev, int32_t range) {
+    int32_t value = next - prev + range / 2;
+    value += range & -(int32_t)(value < 0);         // ohne Sprünge, damit die Schleife vektorisiert wird
+    value -= range & -(int32_t)(value >= range);
+    return (uint16_t)value;
+}
+
+/**
+ * @brief Emboss für 16-Bit-Bilder, immer außerhalb des Bildes (`job->source` != `job->target`)
+ */
+static void emboss_band16(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd) {
+    const color16_t *source = picture_row16(job->source, 0);
+    color16_t *target = picture_row16(job->target, 0);
+    int32_t range = (int32_t)job->target->maxColorValue + 1;
+
+    size_t numPixels = (size_t)job->target->x * job->target->y;
+    size_t start = (size_t)rowStart * job->target->x;
+    size_t end = (size_t)rowEnd * job->target->x;
+    if (start < 1) {
+        target[0] = source[0];
+        start = 1;
+    }
+    if (end > numPixels - 1) {
+        target[numPixels - 1] = source[numPixels - 1];
+        end = numPixels - 1;
+    }
+
+    for (size_t i = start; i < end; i++) {
+        target[i].red = emboss_sample16(source[i + 1].red, source[i - 1].red, range);
+        target[i].green = emboss_sample16(source[i + 1].green, source[i - 1].green, range);
+        target[i].blue = emboss_sample16(source[i + 1].blue, source[i - 1].blue, range);
+        target[i].alpha = source[i].alpha;
+    }
+}
+
+static void emboss_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    if (picture_is_16bit(job->target)) {
+        emboss_band16(job, rowStart, rowEnd);
+        return;
+    }
+    const color_t *source = job->source->pixels;
+    color_t *target = job->target->pixels;
+
+    // Emboss arbeitet auf dem linearen Pixelindex, das erste & letzte Pixel werden unverändert übernommen
+    size_t numPixels = (size_t)job->target->x * job->target->y;
+    size_t start = (size_t)rowStart * job->target->x;
+    size_t end = (size_t)rowEnd * job->target->x;
+    if (start < 1) {
+        target[0] = source[0];
+        start = 1;
+    }
+    if (end > numPixels - 1) {
+        target[numPixels - 1] = source[numPixels - 1];
+        end = numPixels - 1;
+    }
+
+    if (job->source != job->target) {
+        if (start < end) {
+            job->kernels->embossSpan(source + start, target + start, end - start);
+        }
+        return;
+    }
+
+    // In-Place-Modus: pixelweise, der Vorgänger ist dabei bereits überschrieben
+    for (size_t i = start; i < end; i++) {
+        color_t pixel = source[i];
+        color_t pixelPrev = source[i - 1];
+        color_t pixelNext = source[i + 1];
+
+        int sumRed = pixelNext.red - pixelPrev.red + 128;
+        int sumGreen = pixelNext.green - pixelPrev.green + 128;
+        int sumBlue = pixelNext.blue - pixelPrev.blue + 128;
+
+        pixel.red = (uint8_t)sumRed;
+        pixel.green = (uint8_t)sumGreen;
+        pixel.blue = (uint8_t)sumBlue;
+
+        target[i] = pixel; 
+    }
+}
+
+int apply_emboss(filter_context_t *context, const filter_descriptor_t *filter, picture_t *target) {    
     if (!filter || !target) {
         return -1;   
     }
 
-    for (uint32_t i = 1; i < target->x * target->y - 1; i++) {
-        color_t pixel = target->pixels[i];
-        color_t pixelPrev = target->pixels[i - 1];
-        color_t pixelNext = target->pixels[i + 1];
+    return run_out_of_place(context, emboss_band, filter, true, target);
+}  
+
+/**
+ * @brief Sortiert höchstens 8 Werte aufsteigend (Insertion Sort, ohne Funktionszeiger-Vergleich)
+ */
+static void sort_small(uint8_t *values, size_t count) {
+    for (size_t i = 1; i < count; i++) {
+        uint8_t value = values[i];
+        size_t j = i;
+        while (j > 0 && values[j - 1] > value) {
+            values[j] = values[j - 1];
+            j--;
+        }
+        values[j] = value;
+    }
+}
+
+void apply_median_blur(color_t *neighbor[8], color_t *currentPixel) {
+    uint8_t red[8];
+    uint8_t green[8];
+    uint8_t blue[8];
+
+    size_t redCount = 0;
+    size_t greenCount = 0;
+    size_t blueCount = 0;
+
+    for (size_t i = 0; i < 8; i++) {
+        if (neighbor[i] != NULL) {
+            red[redCount++] = neighbor[i]->red;
+            green[greenCount++] = neighbor[i]->green;
+            blue[blueCount++] = neighbor[i]->blue;
+        }
+    }
+
+    // Sortieren der Farbkanäle
+    sort_small(red, redCount);
+    sort_small(green, greenCount);
+    sort_small(blue, blueCount);
+
+    // Median anwenden
+    currentPixel->red = red[redCount / 2];    // redCount enthält die Anzahl der gültigen Pixel für rot 
+    currentPixel->green = green[greenCount / 2];
+    currentPixel->blue = blue[blueCount / 2];
+}
+
+/**
+ * @brief Berechnet den Median eines einzelnen Pixels über `get_pixel()` (Bildrand & In-Place-Modus)
+ */
+static void median_blur_pixel(const picture_t *source, picture_t *target, uint32_t x, uint32_t y) {
+    color_t *neighbor[8];
+
+    // Nachbarn speichern
+    neighbor[0] = get_pixel(source, x, y+1);    
+    neighbor[1] = get_pixel(source, x+1, y+1);
+    neighbor[2] = get_pixel(source, x+1, y);
+    neighbor[3] = get_pixel(source, x+1, y-1);
+    neighbor[4] = get_pixel(source, x, y-1);
+    neighbor[5] = get_pixel(source, x-1, y-1);
+    neighbor[6] = get_pixel(source, x-1, y);
+    neighbor[7] = get_pixel(source, x-1, y+1);
+
+    color_t *currentPixel = get_pixel(target, x, y);    // Zentrum
+    currentPixel->alpha = get_pixel(source, x, y)->alpha;
+    apply_median_blur(neighbor, currentPixel);    
+}
+
+#define MEDIAN_LANES 16    // Benachbarte Pixel, die das Sortiernetz gleichzeitig bearbeitet
+
+// Vergleicher des Sortiernetzes, jeweils für alle Lanes. Die Schleifen ohne Sprünge werden vom 
+// Compiler zu min/max-Vektorbefehlen übersetzt. Wird nur eine Seite weiterverwendet, wird nur diese berechnet.
+// `median_lane_t` ist der Werttyp der aufrufenden Funktion (8 oder 16 Bit).
+#define MEDIAN_SORT(a, b) \
+    for (int l = 0; l < MEDIAN_LANES; l++) { \
+        median_lane_t lo = v[a][l] < v[b][l] ? v[a][l] : v[b][l]; \
+        median_lane_t hi = v[a][l] < v[b][l] ? v[b][l] : v[a][l]; \
+        v[a][l] = lo; \
+        v[b][l] = hi; \
+    }
+#define MEDIAN_MIN(a, b) \
+    for (int l = 0; l < MEDIAN_LANES; l++) { \
+        v[a][l] = v[a][l] < v[b][l] ? v[a][l] : v[b][l]; \
+    }
+#define MEDIAN_MAX(a, b) \
+    for (int l = 0; l < MEDIAN_LANES; l++) { \
+        v[b][l] = v[a][l] < v[b][l] ? v[b][l] : v[a][l]; \
+    }
+
+/**
+ * @brief Bestimmt für jede Lane den 5. kleinsten von 8 Werten (entspricht `sorted[8 / 2]`)
+ * 
+ * Auf das Element 4 reduziertes optimales Sortiernetz für 8 Eingänge (17 statt 19 Vergleicher).
+ *
+ * @param v Je 8 Werte für MEDIAN_LANES Pixel, wird dabei überschrieben
+ * @param median Ergebnis pro Lane
+ */
+static void median_of_8(uint8_t v[8][MEDIAN_LANES], uint8_t median[MEDIAN_LANES]) {
+    typedef uint8_t median_lane_t;
+    MEDIAN_SORT(0, 2) MEDIAN_SORT(1, 3) MEDIAN_SORT(4, 6) MEDIAN_SORT(5, 7)
+    MEDIAN_SORT(0, 4) MEDIAN_SORT(1, 5) MEDIAN_SORT(2, 6) MEDIAN_SORT(3, 7)
+    MEDIAN_MAX(0, 1)  MEDIAN_SORT(2, 3) MEDIAN_SORT(4, 5) MEDIAN_MIN(6, 7)
+    MEDIAN_MAX(2, 4)  MEDIAN_MIN(3, 5)
+    MEDIAN_MAX(1, 4)  MEDIAN_MIN(3, 6)
+    MEDIAN_MAX(3, 4)
+    memcpy(median, v[4], MEDIAN_LANES);
+}
+
+/**
+ * @brief `median_of_8()` für 16-Bit-Kanäle
+ */
+static void median_of_8_16(uint16_t v[8][MEDIAN_LANES], uint16_t median[MEDIAN_LANES]) {
+    typedef uint16_t median_lane_t;
+    MEDIAN_SORT(0, 2) MEDIAN_SORT(1, 3) MEDIAN_SORT(4, 6) MEDIAN_SORT(5, 7)
+    MEDIAN_SORT(0, 4) MEDIAN_SORT(1, 5) MEDIAN_SORT(2, 6) MEDIAN_SORT(3, 7)
+    MEDIAN_MAX(0, 1)  MEDIAN_SORT(2, 3) MEDIAN_SORT(4, 5) MEDIAN_MIN(6, 7)
+    MEDIAN_MAX(2, 4)  MEDIAN_MIN(3, 5)
+    MEDIAN_MAX(1, 4)  MEDIAN_MIN(3, 6)
+    MEDIAN_MAX(3, 4)
+    memcpy(median, v[4], sizeof(uint16_t) * MEDIAN_LANES);
+}
+
+/**
+ * @brief Sortiert höchstens 8 16-Bit-Werte aufsteigend, wie `sort_small()`
+ */
+static void sort_small16(uint16_t *values, size_t count) {
+    for (size_t i = 1; i < count; i++) {
+        uint16_t value = values[i];
+        size_t j = i;
+        while (j > 0 && values[j - 1] > value) {
+            values[j] = values[j - 1];
+            j--;
+        }
+        values[j] = value;
+    }
+}
+
+/**
+ * @brief Median eines 16-Bit-Pixels über die vorhandenen Nachbarn (Bildrand), wie `median_blur_pixel()`
+ */
+static void median_blur_pixel16(const picture_t *source, picture_t *target, uint32_t x, uint32_t y) {
+    static const int offsets[8][2] = { {0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1} };
+    uint16_t red[8];
+    uint16_t green[8];
+    uint16_t blue[8];
+    size_t count = 0;
+
+    for (int i = 0; i < 8; i++) {
+        int64_t nx = (int64_t)x + offsets[i][0];
+        int64_t ny = (int64_t)y + offsets[i][1];
+        if (nx < 0 || ny < 0 || nx >= target->x || ny >= target->y) {
+            continue;
+        }
+        const color16_t *neighbor = &picture_row16(source, (uint32_t)ny)[nx];
+        red[count] = neighbor->red;
+        green[count] = neighbor->green;
+        blue[count] = neighbor->blue;
+        count++;
+    }
+
+    color16_t *out = &picture_row16(target, y)[x];
+    *out = picture_row16(source, y)[x];
+    if (count == 0) {
+        return;
+    }
+    sort_small16(red, count);
+    sort_small16(green, count);
+    sort_small16(blue, count);
+    out->red = red[count / 2];
+    out->green = green[count / 2];
+    out->blue = blue[count / 2];
+}
+
+/**
+ * @brief 3x3-Median für 16-Bit-Bilder, das Bildinnere über das Sortiernetz
+ */
+static void median_blur_band16(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd) {
+    const picture_t *source = job->source;
+    picture_t *target = job->target;
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        if (y == 0 || y + 1 >= target->y || target->x < 3) {
+            for (uint32_t x = 0; x < target->x; x++) {
+                median_blur_pixel16(source, target, x, y);
+            }
+            continue;
+        }
+
+        const color16_t *above = picture_row16(source, y - 1);
+        const color16_t *current = picture_row16(source, y);
+        const color16_t *below = picture_row16(source, y + 1);
+        color16_t *out = picture_row16(target, y);
+
+        median_blur_pixel16(source, target, 0, y);
+        uint32_t x = 1;
+        for (; x + MEDIAN_LANES < target->x; x += MEDIAN_LANES) {
+            uint16_t red[8][MEDIAN_LANES];
+            uint16_t green[8][MEDIAN_LANES];
+            uint16_t blue[8][MEDIAN_LANES];
+            uint16_t median[3][MEDIAN_LANES];
+
+            for (int l = 0; l < MEDIAN_LANES; l++) {
+                const color16_t *n[8] = {
+                    &above[x + l - 1], &above[x + l], &above[x + l + 1],
+                    &current[x + l - 1], &current[x + l + 1],
+                    &below[x + l - 1], &below[x + l], &below[x + l + 1],
+                };
+                for (int i = 0; i < 8; i++) {
+                    red[i][l] = n[i]->red;
+                    green[i][l] = n[i]->green;
+                    blue[i][l] = n[i]->blue;
+                }
+            }
+            median_of_8_16(red, median[0]);
+            median_of_8_16(green, median[1]);
+            median_of_8_16(blue, median[2]);
+
+            for (int l = 0; l < MEDIAN_LANES; l++) {
+                out[x + l].red = median[0][l];
+                out[x + l].green = median[1][l];
+                out[x + l].blue = median[2][l];
+                out[x + l].alpha = current[x + l].alpha;
+            }
+        }
+        for (; x < target->x; x++) {
+            median_blur_pixel16(source, target, x, y);
+        }
+    }
+}
+
+static void median_blur_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    if (picture_is_16bit(job->target)) {
+        median_blur_band16(job, rowStart, rowEnd);
+        return;
+    }
+    const picture_t *source = job->source;
+    picture_t *target = job->target;
+    bool inPlace = (source == target);
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        // Randzeilen & In-Place-Modus pixelweise, damit die Scanreihenfolge erhalten bleibt
+        if (inPlace || y == 0 || y + 1 >= target->y || target->x < 3) {
+            for (uint32_t x = 0; x < target->x; x++) {
+                median_blur_pixel(source, target, x, y);
+            }
+            continue;
+        }
+
+        const color_t *above = picture_row(source, y - 1);
+        const color_t *current = picture_row(source, y);
+        const color_t *below = picture_row(source, y + 1);
+        color_t *out = picture_row(target, y);
+
+        median_blur_pixel(source, target, 0, y);
+        uint32_t x = 1;
+        for (; x + MEDIAN_LANES < target->x; x += MEDIAN_LANES) {
+            uint8_t red[8][MEDIAN_LANES];
+            uint8_t green[8][MEDIAN_LANES];
+            uint8_t blue[8][MEDIAN_LANES];
+            uint8_t median[3][MEDIAN_LANES];
+
+            // Die 8 Nachbarn von MEDIAN_LANES benachbarten Pixeln kanalweise einsammeln
+            for (int l = 0; l < MEDIAN_LANES; l++) {
+                const color_t *n[8] = {
+                    &above[x + l - 1], &above[x + l], &above[x + l + 1],
+                    &current[x + l - 1], &current[x + l + 1],
+                    &below[x + l - 1], &below[x + l], &below[x + l + 1],
+                };
+                for (int i = 0; i < 8; i++) {
+                    red[i][l] = n[i]->red;
+                    green[i][l] = n[i]->green;
+                    blue[i][l] = n[i]->blue;
+                }
+            }
+            median_of_8(red, median[0]);
+            median_of_8(green, median[1]);
+            median_of_8(blue, median[2]);
+
+            for (int l = 0; l < MEDIAN_LANES; l++) {
+                out[x + l].red = median[0][l];
+                out[x + l].green = median[1][l];
+                out[x + l].blue = median[2][l];
+                out[x + l].alpha = current[x + l].alpha;
+            }
+        }
+        for (; x < target->x; x++) {
+            median_blur_pixel(source, target, x, y);
+        }
+    }   
+}
+
+/**
+ * @brief Histogramm eines Farbkanals mit grober (16 Klassen) & feiner (256 Klassen) Stufe
+ */
+typedef struct {
+    uint32_t coarse[16];
+    uint32_t fine[256];
+} median_histogram_t;
+
+static inline void histogram_add(median_histogram_t *histogram, uint8_t value) {
+    histogram->coarse[value >> 4]++;
+    histogram->fine[value]++;
+}
+
+static inline void histogram_remove(median_histogram_t *histogram, uint8_t value) {
+    histogram->coarse[value >> 4]--;
+    histogram->fine[value]--;
+}
+
+/**
+ * @brief Gibt den k-kleinsten Wert (ab 0) zurück, erst über die groben, dann über die feinen Klassen
+ */
+static inline uint8_t histogram_kth(const median_histogram_t *histogram, uint32_t k) {
+    unsigned bin = 0;
+    while (k >= histogram->coarse[bin]) {
+        k -= histogram->coarse[bin];
+        bin++;
+    }
+    bin <<= 4;
+    while (k >= histogram->fine[bin]) {
+        k -= histogram->fine[bin];
+        bin++;
+    }
+    return (uint8_t)bin;
+}
+
+/**
+ * @brief Fügt eine Spalte des Fensters zu den drei Kanalhistogrammen hinzu oder entfernt sie
+ */
+static void histogram_column(median_histogram_t histogram[3], const picture_t *source, uint32_t x, 
+                             uint32_t yStart, uint32_t yEnd, bool add) {
+    for (uint32_t y = yStart; y <= yEnd; y++) {
+        const color_t *pixel = &picture_row(source, y)[x];
+        if (add) {
+            histogram_add(&histogram[0], pixel->red);
+            histogram_add(&histogram[1], pixel->green);
+            histogram_add(&histogram[2], pixel->blue);
+        }
+        else {
+            histogram_remove(&histogram[0], pixel->red);
+            histogram_remove(&histogram[1], pixel->green);
+            histogram_remove(&histogram[2], pixel->blue);
+        }
+    }
+}
+
+/**
+ * @brief Histogramm eines 16-Bit-Farbkanals mit vier Stufen zu je 16 Unterklassen
+ *
+ * Wie beim 8-Bit-Histogramm wird zuerst über die groben Klassen gesucht, mit vier Stufen 
+ * kostet die Suche höchstens 64 statt 512 Schritte.
+ */
+typedef struct {
+    uint32_t level0[16];       // Wert >> 12
+    uint32_t level1[256];      // Wert >> 8
+    uint32_t level2[4096];     // Wert >> 4
+    uint32_t fine[65536];
+} median_histogram16_t;
+
+static inline void histogram16_update(median_histogram16_t *histogram, uint16_t value, int32_t delta) {
+    histogram->level0[value >> 12] += (uint32_t)delta;
+    histogram->level1[value >> 8] += (uint32_t)delta;
+    histogram->level2[value >> 4] += (uint32_t)delta;
+    histogram->fine[value] += (uint32_t)delta;
+}
+
+static inline uint16_t histogram16_kth(const median_histogram16_t *histogram, uint32_t k) {
+    const uint32_t *levels[4] = { histogram->level0, histogram->level1, histogram->level2, histogram->fine };
+    unsigned bin = 0;
+    for (int level = 0; level < 4; level++) {
+        while (k >= levels[level][bin]) {
+            k -= levels[level][bin];
+            bin++;
+        }
+        if (level < 3) {
+            bin <<= 4;    // Erste Unterklasse der gefundenen Klasse
+        }
+    }
+    return (uint16_t)bin;
+}
+
+static void histogram16_column(median_histogram16_t histogram[3], const picture_t *source, uint32_t x, 
+                               uint32_t yStart, uint32_t yEnd, int32_t delta) {
+    for (uint32_t y = yStart; y <= yEnd; y++) {
+        const color16_t *pixel = &picture_row16(source, y)[x];
+        histogram16_update(&histogram[0], pixel->red, delta);
+        histogram16_update(&histogram[1], pixel->green, delta);
+        histogram16_update(&histogram[2], pixel->blue, delta);
+    }
+}
+
+// Arbeitsspeicher pro Thread für die drei Kanalhistogramme in color_t-Einheiten
+#define HISTOGRAM16_STRIDE (3 * sizeof(median_histogram16_t) / sizeof(color_t))
+
+/**
+ * @brief Legt für jeden Thread drei leere 16-Bit-Histogramme als `job->workspace` an
+ *
+ * @return int 0 bei Erfolg, -3 bei Speicherproblemen
+ */
+static int attach_histograms16(const filter_context_t *context, band_job_t *job) {
+    job->workspaceStride = HISTOGRAM16_STRIDE;
+    job->workspace = calloc(thread_pool_size(context ? context->pool : NULL), HISTOGRAM16_STRIDE * sizeof(color_t));
+    return job->workspace ? 0 : -3;
+}
+
+/**
+ * @brief Median mit gleitendem Histogramm für 16-Bit-Bilder, wie `median_histogram_band()`
+ *
+ * Die Histogramme (gut 800 kB pro Thread) kommen aus `attach_histograms16()`. Statt sie pro Zeile 
+ * zu löschen, werden am Zeilenende die verbliebenen Fensterspalten wieder entfernt.
+ */
+static void median_histogram_band16(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    const picture_t *source = job->source;
+    picture_t *target = job->target;
+    uint32_t radius = job->filter->radius;
+    median_histogram16_t *histogram = (median_histogram16_t *)(job->workspace + thread * job->workspaceStride);
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        uint32_t yStart = y > radius ? y - radius : 0;
+        uint32_t yEnd = y + radius < target->y ? y + radius : target->y - 1;
+        uint32_t windowRows = yEnd - yStart + 1;
+
+        for (uint32_t x = 0; x <= radius && x < target->x; x++) {
+            histogram16_column(histogram, source, x, yStart, yEnd, 1);
+        }
+
+        const color16_t *current = picture_row16(source, y);
+        color16_t *out = picture_row16(target, y);
+        for (uint32_t x = 0; x < target->x; x++) {
+            if (x > radius) {
+                histogram16_column(histogram, source, x - radius - 1, yStart, yEnd, -1);
+            }
+            if (x > 0 && x + radius < target->x) {
+                histogram16_column(histogram, source, x + radius, yStart, yEnd, 1);
+            }
+            uint32_t xStart = x > radius ? x - radius : 0;
+            uint32_t xEnd = x + radius < target->x ? x + radius : target->x - 1;
+            uint32_t count = windowRows * (xEnd - xStart + 1) - 1;
+
+            out[x] = current[x];
+            if (count == 0) {
+                continue;
+            }
+            histogram16_update(&histogram[0], current[x].red, -1);
+            histogram16_update(&histogram[1], current[x].green, -1);
+            histogram16_update(&histogram[2], current[x].blue, -1);
+            out[x].red = histogram16_kth(&histogram[0], count / 2);
+            out[x].green = histogram16_kth(&histogram[1], count / 2);
+            out[x].blue = histogram16_kth(&histogram[2], count / 2);
+            histogram16_update(&histogram[0], current[x].red, 1);
+            histogram16_update(&histogram[1], current[x].green, 1);
+            histogram16_update(&histogram[2], current[x].blue, 1);
+        }
+
+        // Histogramme für die nächste Zeile leeren
+        uint32_t last = target->x - 1;
+        for (uint32_t x = last > radius ? last - radius : 0; x <= last; x++) {
+            histogram16_column(histogram, source, x, yStart, yEnd, -1);
+        }
+    }
+}
+
+/**
+ * @brief Median über ein (2r+1)x(2r+1)-Fenster mit gleitendem Histogramm (Huang)
+ *
+ * Pro Zeile wandert das Fenster nach rechts, dabei wird je eine Spalte entfernt & eine hinzugefügt. 
+ * Wie beim 3x3-Filter zählt das Zentrum nicht zu den Nachbarn & der Median ist `sorted[count / 2]`.
+ * Die Suche im Histogramm kostet unabhängig vom Radius höchstens 32 Schritte.
+ */
+static void median_histogram_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    if (picture_is_16bit(job->target)) {
+        median_histogram_band16(job, rowStart, rowEnd, thread);
+        return;
+    }
+    const picture_t *source = job->source;
+    picture_t *target = job->target;
+    uint32_t radius = job->filter->radius;
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        uint32_t yStart = y > radius ? y - radius : 0;
+        uint32_t yEnd = y + radius < target->y ? y + radius : target->y - 1;
+        uint32_t windowRows = yEnd - yStart + 1;
+
+        median_histogram_t histogram[3];
+        memset(histogram, 0, sizeof(histogram));
+        for (uint32_t x = 0; x <= radius && x < target->x; x++) {
+            histogram_column(histogram, source, x, yStart, yEnd, true);
+        }
+
+        const color_t *current = picture_row(source, y);
+        color_t *out = picture_row(target, y);
+        for (uint32_t x = 0; x < target->x; x++) {
+            if (x > radius) {
+                histogram_column(histogram, source, x - radius - 1, yStart, yEnd, false);
+            }
+            if (x > 0 && x + radius < target->x) {
+                histogram_column(histogram, source, x + radius, yStart, yEnd, true);
+            }
+            uint32_t xStart = x > radius ? x - radius : 0;
+            uint32_t xEnd = x + radius < target->x ? x + radius : target->x - 1;
+            uint32_t count = windowRows * (xEnd - xStart + 1) - 1;    // ohne Zentrum
+
+            out[x] = current[x];
+            if (count == 0) {
+                continue;
+            }
+
+            // Zentrum kurz aus dem Fenster nehmen
+            histogram_remove(&histogram[0], current[x].red);
+            histogram_remove(&histogram[1], current[x].green);
+            histogram_remove(&histogram[2], current[x].blue);
+            out[x].red = histogram_kth(&histogram[0], count / 2);
+            out[x].green = histogram_kth(&histogram[1], count / 2);
+            out[x].blue = histogram_kth(&histogram[2], count / 2);
+            histogram_add(&histogram[0], current[x].red);
+            histogram_add(&histogram[1], current[x].green);
+            histogram_add(&histogram[2], current[x].blue);
+        }
+    }
+}
+
+int median_blur_filter(filter_context_t *context, const filter_descriptor_t *filter, picture_t *target) {
+    if (!filter || !target) {
+        return -1; 
+    }
+    if (filter->radius > MEDIAN_MAX_RADIUS) {
+        return -1;
+    }
+
+    if (filter->radius > 1 && picture_is_16bit(target)) {
+        band_job_t job = { .kernel = median_histogram_band, .filter = filter };
+        if (attach_histograms16(context, &job) != 0) {
+            return -3;
+        }
+        int status = run_into_scratch(context, &job, target);
+        free(job.workspace);
+        return status;
+    }
+    if (filter->radius > 1) {
+        return run_out_of_place(context, median_histogram_band, filter, false, target);
+    }
+    return run_out_of_place(context, median_blur_band, filter, true, target);
+}
+
+/**
+ * @brief Prüft, ob ein Preset eine reine Pixeloperation (Overlay) ist
+ */
+static bool is_overlay_preset(enum filter_preset_t preset) {
+    switch (preset) {
+        case OVERLAY:
+        case WHITEFRAME:
+        case BLACKFRAME:
+        case HEARTS:
+        case STARS:
+        case SNOWFLAKES:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Kanäle, die ein Overlay verändert: ohne color= alle drei, sonst die von Null verschiedenen der Farbe
+ *
+ * Rahmen übernehmen immer das ganze Overlay-Pixel.
+ */
+static unsigned overlay_channel_mask(const filter_descriptor_t *filter) {
+    if (!filter->useColor || get_frame_skip(filter) >= 0) {
+        return OVERLAY_MASK_RED | OVERLAY_MASK_GREEN | OVERLAY_MASK_BLUE;
+    }
+    return (filter->color.red ? OVERLAY_MASK_RED : 0u) | (filter->color.green ? OVERLAY_MASK_GREEN : 0u)
+           | (filter->color.blue ? OVERLAY_MASK_BLUE : 0u);
+}
+
+/**
+ * @brief `overlay_rows()` für 16-Bit-Zielbilder
+ *
+ * Das Overlay-Bild hat immer 8 Bit pro Kanal, seine Werte werden auf 0..maxColorValue des Zielbildes 
+ * gestreckt. Die Rahmen erkennen weiße & schwarze Stellen weiterhin an den 8-Bit-Werten.
+ */
+static void overlay_rows16(const filter_descriptor_t *filter, const picture_t *overlay, picture_t *target, 
+                           uint32_t rowStart, uint32_t rowEnd) {
+    uint16_t expand[256];
+    for (uint32_t v = 0; v < 256; v++) {
+        expand[v] = (uint16_t)((v * target->maxColorValue + 127) / 255);
+    }
+
+    uint32_t width = target->x < overlay->x ? target->x : overlay->x;
+    if (rowEnd > overlay->y) {
+        rowEnd = overlay->y;
+    }
+    bool alpha = picture_has_alpha(overlay);
+    unsigned mask = overlay_channel_mask(filter);
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        color16_t *targetRow = picture_row16(target, y);
+        const color_t *overlayRow = picture_row(overlay, y);
+
+        for (uint32_t x = 0; x < width; x++) {
+            color16_t *currentPixel = &targetRow[x];
+            const color_t *frame = &overlayRow[x];
+            uint32_t frameRed = expand[frame->red];
+            uint32_t frameGreen = expand[frame->green];
+            uint32_t frameBlue = expand[frame->blue];
+
+            // Alphakanal: vormultipliziertes Overlay über das Pixel legen
+            if (alpha) {
+                if (frame->alpha != 0) {
+                    uint16_t *channels[3] = { &currentPixel->red, &currentPixel->green, &currentPixel->blue };
+                    const uint32_t values[3] = { frameRed, frameGreen, frameBlue };
+                    for (unsigned c = 0; c < 3; c++) {
+                        if (mask & (1u << c)) {
+                            *channels[c] = composite_channel16(*channels[c], (uint16_t)values[c], frame->alpha, target->maxColorValue);
+                        }
+                    }
+                }
+                continue;
+            }
+
+            if (filter->preset == BLACKFRAME) {
+                if (frame->red == 0xff && frame->green == 0xff && frame->blue == 0xff) {
+                    continue;
+                }
+                currentPixel->red = (uint16_t)frameRed;
+                currentPixel->green = (uint16_t)frameGreen;
+                currentPixel->blue = (uint16_t)frameBlue;
+            }
+            else if (filter->preset == WHITEFRAME) {
+                if (frame->red == 0x00 && frame->green == 0x00 && frame->blue == 0x00) {
+                    continue;
+                }
+                currentPixel->red = (uint16_t)frameRed;
+                currentPixel->green = (uint16_t)frameGreen;
+                currentPixel->blue = (uint16_t)frameBlue;
+            }
+
+            // Mittelwert, mit Farbe nur für die gewählten Kanäle
+            if (!filter->useColor || filter->color.red) {
+                currentPixel->red = (uint16_t)((currentPixel->red + frameRed) / 2);
+            }
+            if (!filter->useColor || filter->color.green) {
+                currentPixel->green = (uint16_t)((currentPixel->green + frameGreen) / 2);
+            }
+            if (!filter->useColor || filter->color.blue) {
+                currentPixel->blue = (uint16_t)((currentPixel->blue + frameBlue) / 2);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Wählt den Zeilenkernel eines Overlays: Overlays mit Alphakanal werden über das Bild gelegt, sonst 
+ *        übernehmen Rahmen das Overlay-Pixel & die übrigen Presets mitteln die Kanäle der Farbmaske
+ */
+static overlay_row_t select_overlay_row(const row_kernels_t *kernels, const filter_descriptor_t *filter, const picture_t *overlay) {
+    if (picture_has_alpha(overlay)) {
+        return kernels->overlayCompositeRow[overlay_channel_mask(filter)];
+    }
+    if (filter->preset == BLACKFRAME || filter->preset == WHITEFRAME) {
+        return kernels->overlayFrameRow[filter->preset == BLACKFRAME ? OVERLAY_FRAME_BLACK : OVERLAY_FRAME_WHITE];
+    }
+    return kernels->overlayBlendRow[overlay_channel_mask(filter)];
+}
+
+/**
+ * @brief Blendet die Zeilen [rowStart, rowEnd) des skalierten Overlays direkt in das Zielbild
+ *
+ * 8-Bit-Bilder laufen zeilenweise durch die Overlay-Kernel aus `kernels`, ohne Abfragen pro Pixel.
+ * Rahmen mit Abschnitten (`spans`) berühren nur die abgedeckten Pixel, `overlay` wird dann nicht gelesen.
+ */
+static void overlay_rows(const row_kernels_t *kernels, const filter_descriptor_t *filter, const picture_t *overlay,
+                         const overlay_spans_t *spans, picture_t *target, uint32_t rowStart, uint32_t rowEnd) {
+    if (spans) {
+        overlay_spans_apply(spans, target, 0, rowStart, rowEnd);
+        return;
+    }
+    if (picture_is_16bit(target)) {
+        overlay_rows16(filter, overlay, target, rowStart, rowEnd);
+        return;
+    }
+
+    // Das skalierte Overlay kann durch Rundung etwas kleiner sein, dort bleibt das Zielbild unverändert
+    uint32_t width = target->x < overlay->x ? target->x : overlay->x;
+    if (rowEnd > overlay->y) {
+        rowEnd = overlay->y;
+    }
+    overlay_row_t blendRow = select_overlay_row(kernels, filter, overlay);
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        blendRow(picture_row(target, y), picture_row(overlay, y), width);
+    }
+}
+
+static void overlay_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    overlay_rows(job->kernels, job->filter, job->overlay, job->spans, job->target, rowStart, rowEnd);
+}
+
+const char *get_overlay_path(const filter_descriptor_t *filter) {
+    if (!filter) {
+        return NULL;
+    }
+    // Filterpfad basierend auf Preset setzen
+    switch(filter->preset) {
+        case SNOWFLAKES:
+            return "assets/snowflakes.ppm";
+        case HEARTS: 
+            return "assets/hearts.ppm";
+        case STARS: 
+            return "assets/stars.ppm";
+        case BLACKFRAME:
+            return "assets/blackframe.ppm";
+        case WHITEFRAME:
+            return "assets/whiteframe.ppm";
+        case OVERLAY:
+            return filter->path; 
+        default: 
+            return NULL; 
+    }
+}
+
+int get_frame_skip(const filter_descriptor_t *filter) {
+    if (!filter) {
+        return -1;
+    }
+    // Schwarzer Rahmen: weiße Stellen ignorieren, weißer Rahmen: schwarze Stellen ignorieren
+    switch (filter->preset) {
+        case BLACKFRAME:
+            return 0xff;
+        case WHITEFRAME:
+            return 0x00;
+        default:
+            return -1;
+    }
+}
+
+/**
+ * @brief Liefert das Overlay-Bild eines Overlay-Presets, skaliert auf die Größe des Zielbildes
+ *
+ * Mit Asset-Cache im Kontext stammt das Bild aus dem Cache, sonst wird es in `stage->owned` geladen 
+ * & skaliert. Für Rahmen liefert der Cache statt des Bildes nur die abgedeckten Abschnitte (`stage->spans`).
+ * Das Ergebnis muss mit `release_overlay()` zurückgegeben werden.
+ *
+ * @return int 0 bei Erfolg, -2 bei unbekanntem Preset oder einem Overlay-Bild mit 16 Bit pro Kanal, 
+ *             sonst Fehlercode von `load_picture_from_path()` oder `resample_picture()`
+ */
+static int acquire_overlay(const filter_context_t *context, const filter_descriptor_t *filter, const picture_t *target, 
+                           pixel_stage_t *stage) {
+    const char *path = get_overlay_path(filter);
+    if (!path) {
+        return -2;
+    }
+    const picture_t **overlay = &stage->overlay;
+    picture_t *owned = &stage->owned;
+    *overlay = NULL;
+    stage->spans = NULL;
+
+    double start = stats_now();
+    int skip = get_frame_skip(filter);
+    if (context && context->assets && skip >= 0) {
+        int status = asset_cache_acquire_spans(context->assets, path, target->x, target->y, (uint8_t)skip, &stage->spans);
+        stats_span("overlay load/scale", "overlay", start);
+        return status;
+    }
+    if (context && context->assets) {
+        int status = asset_cache_acquire(context->assets, path, target->x, target->y, overlay);
+        if (status == 0 && picture_is_16bit(*overlay)) {
+            asset_cache_release(context->assets, *overlay);
+            *overlay = NULL;
+            return -2;
+        }
+        stats_span("overlay load/scale", "overlay", start);
+        return status;
+    }
+
+    // Filterbild laden (Overlay-Bilder haben immer 8 Bit pro Kanal, Alpha wird vormultipliziert)
+    int status = load_overlay_from_path(path, owned);
+    if (status) {
+        pixel_buffer_free(owned->pixels);
+        owned->pixels = NULL;
+        return status;
+    } 
+
+    // Filterbild auf die Zielgröße skalieren (nächster Nachbar, Rahmen behalten ihre reinen Farben)
+    picture_t scaled = { .x = target->x, .y = target->y };
+    status = resample_picture(context ? context->pool : NULL, context ? context->simd : SIMD_AUTO, owned, &scaled, RESAMPLE_NEAREST);
+    pixel_buffer_free(owned->pixels);
+    *owned = scaled;
+    if (status) {
+        return status;
+    }
+    *overlay = owned;
+    stats_span("overlay load/scale", "overlay", start);
+    return 0;
+}
+
+/**
+ * @brief Gibt ein mit `acquire_overlay()` geholtes Overlay-Bild bzw. die Abschnitte zurück
+ */
+static void release_overlay(const filter_context_t *context, pixel_stage_t *stage) {
+    if (stage->overlay && stage->overlay != &stage->owned && context && context->assets) {
+        asset_cache_release(context->assets, stage->overlay);
+    }
+    if (stage->spans && context && context->assets) {
+        asset_cache_release_spans(context->assets, stage->spans);
+    }
+    if (stage->owned.pixels) {
+        pixel_buffer_free(stage->owned.pixels);
+        stage->owned.pixels = NULL;
+    }
+}
+
+int apply_overlay(filter_context_t *context, filter_descriptor_t *filter, picture_t *target) {
+    if (!filter || !target) {
+        return -1; 
+    }
+
+    pixel_stage_t stage = { .filter = filter };
+    int status = acquire_overlay(context, filter, target, &stage);
+    if (status) {
+        return status;
+    }
+    
+    // Overlay anwenden (reine Pixeloperation, die Bänder schreiben direkt ins Zielbild)
+    band_job_t job = { .kernel = overlay_band, .target = target, .filter = filter, .overlay = stage.overlay,
+                       .spans = stage.spans, .kernels = get_row_kernels(context ? context->simd : SIMD_AUTO),
+                       .rows = target->y };
+    status = run_in_bands(context, &job);
+
+    release_overlay(context, &stage);
+    return status;
+}
+
+/**
+ * @brief Berechnet ein Pixel des Light-Blurs über `get_pixel()` (Bildrand & In-Place-Modus)
+ */
+static void blur_light_pixel(const picture_t *source, picture_t *target, uint32_t x, uint32_t y) {
+    // Randzeilen & -spalten werden unverändert übernommen
+    if (y == 0 || y == target->y - 1 || x == 0 || x == target->x - 1) {
+        *get_pixel_unchecked(target, x, y) = *get_pixel_unchecked(source, x, y);
+        return;
+    }
+    
+    // Alle Nachbarn liegen im Bild, daher ohne Bereichsprüfung
+    color_t *currentPixel = get_pixel_unchecked(source, x, y);
+    color_t *abovePixel = get_pixel_unchecked(source, x, y-1);
+    color_t *belowPixel = get_pixel_unchecked(source, x, y+1);
+    color_t *leftPixel = get_pixel_unchecked(source, x-1, y);
+    color_t *rightPixel = get_pixel_unchecked(source, x+1, y);
+    color_t *targetPixel = get_pixel_unchecked(target, x, y);
+    
+    // Berechnung der Summen der Farbwerte der benachbarten Pixel
+    uint32_t sumRed = currentPixel->red + abovePixel->red + belowPixel->red + leftPixel->red + rightPixel->red;
+    uint32_t sumGreen = currentPixel->green + abovePixel->green + belowPixel->green + leftPixel->green + rightPixel->green;
+    uint32_t sumBlue = currentPixel->blue + abovePixel->blue + belowPixel->blue + leftPixel->blue + rightPixel->blue;
+
+    // Durchschnitt der Nachbarn berechnen
+    targetPixel->red  = (uint8_t)(sumRed / 5); 
+    targetPixel->green = (uint8_t)(sumGreen / 5); 
+    targetPixel->blue = (uint8_t)(sumBlue / 5); 
+    targetPixel->alpha = currentPixel->alpha;
+}
+
+/**
+ * @brief Light-Blur für 16-Bit-Bilder: Rand wird übernommen, innen Mittelwert des 5-Punkt-Kreuzes
+ */
+static void blur_light_band16(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd) {
+    const picture_t *source = job->source;
+    picture_t *target = job->target;
+    uint32_t width = target->x;
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        const color16_t *current = picture_row16(source, y);
+        color16_t *out = picture_row16(target, y);
+        if (y == 0 || y + 1 >= target->y || width < 3) {
+            memcpy(out, current, width * sizeof(color16_t));
+            continue;
+        }
+
+        const color16_t *above = picture_row16(source, y - 1);
+        const color16_t *below = picture_row16(source, y + 1);
+        out[0] = current[0];
+        for (uint32_t x = 1; x + 1 < width; x++) {
+            out[x].red = (uint16_t)(((uint32_t)current[x].red + above[x].red + below[x].red 
+                                     + current[x - 1].red + current[x + 1].red) / 5);
+            out[x].green = (uint16_t)(((uint32_t)current[x].green + above[x].green + below[x].green 
+                                       + current[x - 1].green + current[x + 1].green) / 5);
+            out[x].blue = (uint16_t)(((uint32_t)current[x].blue + above[x].blue + below[x].blue 
+                                      + current[x - 1].blue + current[x + 1].blue) / 5);
+            out[x].alpha = current[x].alpha;
+        }
+        out[width - 1] = current[width - 1];
+    }
+}
+
+static void blur_light_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    if (picture_is_16bit(job->target)) {
+        blur_light_band16(job, rowStart, rowEnd);
+        return;
+    }
+    const picture_t *source = job->source;
+    picture_t *target = job->target;
+    bool inPlace = (source == target);
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        // Randzeilen & In-Place-Modus pixelweise, damit die Scanreihenfolge erhalten bleibt
+        if (inPlace || y == 0 || y + 1 >= target->y || target->x < 3) {
+            for (uint32_t x = 0; x < target->x; x++) {
+                blur_light_pixel(source, target, x, y);
+            }
+            continue;
+        }
+
+        // Bildinneres über die Zeilenkernel, die Randspalten werden übernommen
+        blur_light_pixel(source, target, 0, y);
+        job->kernels->blurLightRow(picture_row(source, y - 1) + 1, picture_row(source, y) + 1, 
+                                   picture_row(source, y + 1) + 1, picture_row(target, y) + 1, target->x - 2);
+        blur_light_pixel(source, target, target->x - 1, y);
+    }
+}
+
+int blur_filter_light(filter_context_t *context, picture_t *target) {
+    if (!target) {
+        return -1;  
+    }
+
+    return run_out_of_place(context, blur_light_band, NULL, true, target);
+}
+
+/**
+ * @brief Berechnet ein Pixel des Medium-Blurs über `get_pixel()` (Bildrand & In-Place-Modus)
+ */
+static void blur_medium_pixel(const picture_t *source, picture_t *target, uint32_t x, uint32_t y) {
+    // Randzeilen & -spalten werden unverändert übernommen
+    if (y == 0 || y == target->y - 1 || x == 0 || x == target->x - 1) {
+        *get_pixel_unchecked(target, x, y) = *get_pixel_unchecked(source, x, y);
+        return;
+    }
+    color_t *neighbor[12];
+
+    color_t *currentPixel = get_pixel(source, x, y);
+    neighbor[0] = get_pixel(source, x+1, y+1);
+    neighbor[1]= get_pixel(source, x, y+1);
+    neighbor[2] = get_pixel(source, x-1, y+1);
+    neighbor[3] = get_pixel(source, x-1, y);
+    neighbor[4] = get_pixel(source, x+1, y);
+    neighbor[5] = get_pixel(source, x-1, y-1);
+    neighbor[6] = get_pixel(source, x, y-1);
+    neighbor[7] = get_pixel(source, x+1, y-1);
+    neighbor[8] = get_pixel(source, x, y-2);
+    neighbor[9] = get_pixel(source, x, y+2);
+    neighbor[10] = get_pixel(source, x+2,y); 
+    neighbor[11] = get_pixel(source, x-2, y);
+    color_t *targetPixel = get_pixel(target, x, y);
+
+    uint32_t sumRed = currentPixel->red;
+    uint32_t sumGreen = currentPixel->green;
+    uint32_t sumBlue = currentPixel->blue;
+       
+    for (size_t i = 0; i < 12; i++) {
+        if (neighbor[i] != NULL) {
+            sumRed += neighbor[i]->red;
+            sumGreen += neighbor[i]->green;
+            sumBlue += neighbor[i]->blue;
+        }
+    }
+    targetPixel->red = sumRed / 13;
+    targetPixel->green = sumGreen / 13;
+    targetPixel->blue = sumBlue / 13;  
+    targetPixel->alpha = currentPixel->alpha;
+}
+
+/**
+ * @brief Berechnet ein Pixel des Medium-Blurs eines 16-Bit-Bildes mit Bereichsprüfung, wie `blur_medium_pixel()`
+ *
+ * Auch am Rand wird durch 13 geteilt, fehlende Nachbarn zählen also als 0.
+ */
+static void blur_medium_pixel16(const picture_t *source, picture_t *target, uint32_t x, uint32_t y) {
+    static const int offsets[12][2] = {
+        {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {1, 0}, {-1, -1}, {0, -1}, {1, -1}, {0, -2}, {0, 2}, {2, 0}, {-2, 0},
+    };
+    const color16_t *currentPixel = &picture_row16(source, y)[x];
+    color16_t *targetPixel = &picture_row16(target, y)[x];
+    if (y == 0 || y == target->y - 1 || x == 0 || x == target->x - 1) {
+        *targetPixel = *currentPixel;
+        return;
+    }
+
+    uint32_t sumRed = currentPixel->red;
+    uint32_t sumGreen = currentPixel->green;
+    uint32_t sumBlue = currentPixel->blue;
+    for (int i = 0; i < 12; i++) {
+        int64_t nx = (int64_t)x + offsets[i][0];
+        int64_t ny = (int64_t)y + offsets[i][1];
+        if (nx < 0 || ny < 0 || nx >= target->x || ny >= target->y) {
+            continue;
+        }
+        const color16_t *neighbor = &picture_row16(source, (uint32_t)ny)[nx];
+        sumRed += neighbor->red;
+        sumGreen += neighbor->green;
+        sumBlue += neighbor->blue;
+    }
+    targetPixel->red = (uint16_t)(sumRed / 13);
+    targetPixel->green = (uint16_t)(sumGreen / 13);
+    targetPixel->blue = (uint16_t)(sumBlue / 13);
+    targetPixel->alpha = currentPixel->alpha;
+}
+
+/**
+ * @brief Medium-Blur für 16-Bit-Bilder, das Bildinnere ohne Bereichsprüfung
+ */
+static void blur_medium_band16(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd) {
+    const picture_t *source = job->source;
+    picture_t *target = job->target;
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        if (y < 2 || y + 2 >= target->y || target->x < 5) {
+            for (uint32_t x = 0; x < target->x; x++) {
+                blur_medium_pixel16(source, target, x, y);
+            }
+            continue;
+        }
+
+        const color16_t *r0 = picture_row16(source, y - 2);
+        const color16_t *r1 = picture_row16(source, y - 1);
+        const color16_t *r2 = picture_row16(source, y);
+        const color16_t *r3 = picture_row16(source, y + 1);
+        const color16_t *r4 = picture_row16(source, y + 2);
+        color16_t *out = picture_row16(target, y);
+
+        blur_medium_pixel16(source, target, 0, y);
+        blur_medium_pixel16(source, target, 1, y);
+        for (uint32_t x = 2; x + 2 < target->x; x++) {
+            out[x].red = (uint16_t)(((uint32_t)r0[x].red + r1[x - 1].red + r1[x].red + r1[x + 1].red 
+                                     + r2[x - 2].red + r2[x - 1].red + r2[x].red + r2[x + 1].red + r2[x + 2].red 
+                                     + r3[x - 1].red + r3[x].red + r3[x + 1].red + r4[x].red) / 13);
+            out[x].green = (uint16_t)(((uint32_t)r0[x].green + r1[x - 1].green + r1[x].green + r1[x + 1].green 
+                                       + r2[x - 2].green + r2[x - 1].green + r2[x].green + r2[x + 1].green + r2[x + 2].green 
+                                       + r3[x - 1].green + r3[x].green + r3[x + 1].green + r4[x].green) / 13);
+            out[x].blue = (uint16_t)(((uint32_t)r0[x].blue + r1[x - 1].blue + r1[x].blue + r1[x + 1].blue 
+                                      + r2[x - 2].blue + r2[x - 1].blue + r2[x].blue + r2[x + 1].blue + r2[x + 2].blue 
+                                      + r3[x - 1].blue + r3[x].blue + r3[x + 1].blue + r4[x].blue) / 13);
+            out[x].alpha = r2[x].alpha;
+        }
+        blur_medium_pixel16(source, target, target->x - 2, y);
+        blur_medium_pixel16(source, target, target->x - 1, y);
+    }
+}
+
+static void blur_medium_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    if (picture_is_16bit(job->target)) {
+        blur_medium_band16(job, rowStart, rowEnd);
+        return;
+    }
+    const picture_t *source = job->source;
+    picture_t *target = job->target;
+    bool inPlace = (source == target);
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        // Alle 13 Nachbarn existieren erst ab Abstand 2 zum Rand, davor pixelweise mit NULL-Prüfung
+        if (inPlace || y < 2 || y + 2 >= target->y || target->x < 5) {
+            for (uint32_t x = 0; x < target->x; x++) {
+                blur_medium_pixel(source, target, x, y);
+            }
+            continue;
+        }
+
+        const color_t *const rows[5] = {
+            picture_row(source, y - 2) + 2, picture_row(source, y - 1) + 2, picture_row(source, y) + 2,
+            picture_row(source, y + 1) + 2, picture_row(source, y + 2) + 2,
+        };
+        blur_medium_pixel(source, target, 0, y);
+        blur_medium_pixel(source, target, 1, y);
+        job->kernels->blurMediumRow(rows, picture_row(target, y) + 2, target->x - 4);
+        blur_medium_pixel(source, target, target->x - 2, y);
+        blur_medium_pixel(source, target, target->x - 1, y);
+    }
+}
+
+int blur_filter_medium(filter_context_t *context, picture_t *target) {
+    if (!target) {
+        return -1;     
+    }
+
+    return run_out_of_place(context, blur_medium_band, NULL, true, target);
+}
+
+/**
+ * @brief Boxfilter über eine Zeile mit gleitender Summe, die Kosten pro Pixel hängen nicht vom Radius ab
+ * 
+ * Außerhalb der Zeile wird das Randpixel wiederholt. Die Division durch die Fenstergröße 
+ * erfolgt gerundet über einen Kehrwert in Festkomma (exakt für Fenster < 4096 Pixel).
+ */
+static void box_blur_row(const color_t *in, color_t *out, uint32_t width, uint32_t radius) {
+    int64_t last = (int64_t)width - 1;
+    uint64_t size = 2 * (uint64_t)radius + 1;
+    uint64_t reciprocal = ((1ull << 32) + size - 1) / size;
+    uint32_t sumRed = 0;
+    uint32_t sumGreen = 0;
+    uint32_t sumBlue = 0;
+
+    for (int64_t k = -(int64_t)radius; k <= (int64_t)radius; k++) {
+        const color_t *pixel = &in[k < 0 ? 0 : (k > last ? last : k)];
+        sumRed += pixel->red;
+        sumGreen += pixel->green;
+        sumBlue += pixel->blue;
+    }
+
+    for (int64_t x = 0; x <= last; x++) {
+        out[x].red = (uint8_t)(((sumRed + size / 2) * reciprocal) >> 32);
+        out[x].green = (uint8_t)(((sumGreen + size / 2) * reciprocal) >> 32);
+        out[x].blue = (uint8_t)(((sumBlue + size / 2) * reciprocal) >> 32);
+        out[x].alpha = in[x].alpha;
+
+        // Fenster um ein Pixel weiterschieben
+        int64_t enter = x + radius + 1;
+        int64_t leave = x - radius;
+        const color_t *entering = &in[enter > last ? last : enter];
+        const color_t *leaving = &in[leave < 0 ? 0 : leave];
+        sumRed += entering->red - leaving->red;
+        sumGreen += entering->green - leaving->green;
+        sumBlue += entering->blue - leaving->blue;
+    }
+}
+
+/**
+ * @brief `box_blur_row()` für 16-Bit-Pixel, mit gerundeter ganzzahliger Division
+ *
+ * Die Summen passen in 32 Bit (höchstens 4095 * 65535), für den Festkomma-Kehrwert wären sie zu groß.
+ */
+static void box_blur_row16(const color16_t *in, color16_t *out, uint32_t width, uint32_t radius) {
+    int64_t last = (int64_t)width - 1;
+    uint32_t size = 2 * radius + 1;
+    uint32_t sumRed = 0;
+    uint32_t sumGreen = 0;
+    uint32_t sumBlue = 0;
+
+    for (int64_t k = -(int64_t)radius; k <= (int64_t)radius; k++) {
+        const color16_t *pixel = &in[k < 0 ? 0 : (k > last ? last : k)];
+        sumRed += pixel->red;
+        sumGreen += pixel->green;
+        sumBlue += pixel->blue;
+    }
+
+    for (int64_t x = 0; x <= last; x++) {
+        out[x].red = (uint16_t)((sumRed + size / 2) / size);
+        out[x].green = (uint16_t)((sumGreen + size / 2) / size);
+        out[x].blue = (uint16_t)((sumBlue + size / 2) / size);
+        out[x].alpha = in[x].alpha;
+
+        int64_t enter = x + radius + 1;
+        int64_t leave = x - radius;
+        const color16_t *entering = &in[enter > last ? last : enter];
+        const color16_t *leaving = &in[leave < 0 ? 0 : leave];
+        sumRed += entering->red - leaving->red;
+        sumGreen += entering->green - leaving->green;
+        sumBlue += entering->blue - leaving->blue;
+    }
+}
+
+/**
+ * @brief `separable_blur_band()` für 16-Bit-Bilder, der Arbeitsspeicher ist doppelt so groß
+ */
+static void separable_blur_band16(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    const picture_t *source = job->source;
+    picture_t *target = job->target;
+    const box_plan_t *plan = job->boxPlan;
+    uint32_t width = source->x;
+
+    color16_t *band = (color16_t *)(job->workspace + thread * job->workspaceStride);
+    color16_t *ping = band + (size_t)BAND_ROWS * width;
+    color16_t *pong = ping + width;
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        const color16_t *in = picture_row16(source, y);
+        color16_t *out = band + (size_t)(y - rowStart) * width;
+        for (uint32_t pass = 0; pass < plan->passes; pass++) {
+            color16_t *passOut = (pass + 1 == plan->passes) ? out : (pass % 2 ? pong : ping);
+            box_blur_row16(in, passOut, width, plan->radius[pass]);
+            in = passOut;
+        }
+    }
+
+    uint32_t bandRows = rowEnd - rowStart;
+    for (uint32_t x = 0; x < width; x++) {
+        color16_t *column = picture_row16(target, x) + rowStart;
+        for (uint32_t k = 0; k < bandRows; k++) {
+            column[k] = band[(size_t)k * width + x];
+        }
+    }
+}
+
+/**
+ * @brief Horizontaler Durchgang der separierbaren Blurs mit transponierter Ausgabe
+ * 
+ * Wendet die Boxfilter des Plans auf die Zeilen des Bands an & schreibt das Ergebnis transponiert 
+ * (Zeile y wird zu Spalte y). Die Zeilen des Bands liegen dabei im Arbeitsspeicher, sodass beim 
+ * Transponieren pro Spalte BAND_ROWS aufeinanderfolgende Pixel geschrieben werden. Ein zweiter 
+ * Durchgang auf dem transponierten Bild ergibt so den vertikalen Filter, ohne spaltenweise zu lesen.
+ */
+static void separable_blur_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    if (picture_is_16bit(job->target)) {
+        separable_blur_band16(job, rowStart, rowEnd, thread);
+        return;
+    }
+    const picture_t *source = job->source;
+    picture_t *target = job->target;    // target->x == source->y, target->y == source->x
+    const box_plan_t *plan = job->boxPlan;
+    uint32_t width = source->x;
+
+    // Arbeitsspeicher: BAND_ROWS fertige Zeilen & zwei Zeilen für die Zwischenergebnisse
+    color_t *band = job->workspace + thread * job->workspaceStride;
+    color_t *ping = band + (size_t)BAND_ROWS * width;
+    color_t *pong = ping + width;
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        const color_t *in = picture_row(source, y);
+        color_t *out = band + (size_t)(y - rowStart) * width;
+        for (uint32_t pass = 0; pass < plan->passes; pass++) {
+            color_t *passOut = (pass + 1 == plan->passes) ? out : (pass % 2 ? pong : ping);
+            box_blur_row(in, passOut, width, plan->radius[pass]);
+            in = passOut;
+        }
+    }
+
+    uint32_t bandRows = rowEnd - rowStart;
+    for (uint32_t x = 0; x < width; x++) {
+        color_t *column = picture_row(target, x) + rowStart;
+        for (uint32_t k = 0; k < bandRows; k++) {
+            column[k] = band[(size_t)k * width + x];
+        }
+    }
+}
+
+/**
+ * @brief Führt den Plan horizontal & vertikal aus (zwei transponierende Durchgänge über den Scratch-Puffer)
+ *
+ * @return int 0 bei Erfolg, -3 bei Speicherproblemen
+ */
+static int run_separable_blur(filter_context_t *context, const box_plan_t *plan, picture_t *target) {
+    size_t numPixels = picture_buffer_size(target);
+    filter_context_t local = {0};
+    if (!context) {
+        context = &local;
+    }
+    if (reserve_scratch(context, numPixels) != 0) {
+        return -3;
+    }
+
+    uint32_t longest = target->x > target->y ? target->x : target->y;
+    size_t stride = (size_t)(BAND_ROWS + 2) * longest * (picture_pixel_size(target) / sizeof(color_t));
+    color_t *workspace = malloc(thread_pool_size(context->pool) * stride * sizeof(color_t));
+    if (!workspace) {
+        pixel_buffer_free(local.scratch);
+        return -3;
+    }
+
+    picture_t transposed = *target;
+    transposed.x = target->y;
+    transposed.y = target->x;
+    transposed.pixels = context->scratch;
+
+    // Horizontal: Bild -> transponierter Scratch-Puffer, danach vertikal: Scratch-Puffer -> Bild
+    band_job_t horizontal = { .kernel = separable_blur_band, .source = target, .target = &transposed, 
+                              .boxPlan = plan, .workspace = workspace, .workspaceStride = stride, .rows = target->y };
+    int status = run_in_bands(context, &horizontal);
+    if (status == 0) {
+        band_job_t vertical = { .kernel = separable_blur_band, .source = &transposed, .target = target, 
+                                .boxPlan = plan, .workspace = workspace, .workspaceStride = stride, .rows = transposed.y };
+        status = run_in_bands(context, &vertical);
+    }
+
+    free(workspace);
+    pixel_buffer_free(local.scratch);
+    return status;
+}
+
+int blur_filter_box(filter_context_t *context, const filter_descriptor_t *filter, picture_t *target) {
+    if (!filter || !target) {
+        return -1;
+    }
+    if (filter->radius > BOX_MAX_RADIUS) {
+        return -1;
+    }
+
+    box_plan_t plan = { .passes = 1, .radius = { filter->radius ? filter->radius : 1 } };
+    return run_separable_blur(context, &plan, target);
+}
+
+/**
+ * @brief Nähert den Gauß-Filter mit Standardabweichung `filter->sigma` durch drei Boxfilter an
+ *
+ * @return int 0 bei Erfolg, -1 wenn sigma größer als GAUSSIAN_MAX_SIGMA ist
+ */
+static int gaussian_box_plan(const filter_descriptor_t *filter, box_plan_t *plan) {
+    double sigma = filter->sigma > 0 ? filter->sigma : 1.0;
+    if (sigma > GAUSSIAN_MAX_SIGMA) {
+        return -1;
+    }
+
+    // Drei Boxfilter, deren Varianzen zusammen sigma^2 ergeben (Breiten wl bzw. wl + 2, beide ungerade)
+    plan->passes = BOX_PASSES_MAX;
+    double idealWidth = sqrt(12.0 * sigma * sigma / BOX_PASSES_MAX + 1.0);
+    int lowerWidth = (int)floor(idealWidth);
+    if (lowerWidth % 2 == 0) {
+        lowerWidth--;
+    }
+    double idealCount = (12.0 * sigma * sigma - BOX_PASSES_MAX * lowerWidth * lowerWidth 
+                         - 4.0 * BOX_PASSES_MAX * lowerWidth - 3.0 * BOX_PASSES_MAX) / (-4.0 * lowerWidth - 4.0);
+    int lowerCount = (int)lround(idealCount);
+    for (int i = 0; i < BOX_PASSES_MAX; i++) {
+        int boxWidth = i < lowerCount ? lowerWidth : lowerWidth + 2;
+        plan->radius[i] = (uint32_t)((boxWidth - 1) / 2);
+    }
+    return 0;
+}
+
+int blur_filter_gaussian(filter_context_t *context, const filter_descriptor_t *filter, picture_t *target) {
+    if (!filter || !target) {
+        return -1;
+    }
+    box_plan_t plan;
+    if (gaussian_box_plan(filter, &plan) != 0) {
+        return -1;
+    }
+    return run_separable_blur(context, &plan, target);
+}
+
+int resize_filter(filter_context_t *context, const filter_descriptor_t *filter, picture_t *target) {
+    if (!filter || !target || !target->pixels || target->x == 0 || target->y == 0) {
+        return -1;
+    }
+    if (filter->width == 0 && filter->height == 0) {
+        return -1;
+    }
+
+    // Fehlende Größe aus dem Seitenverhältnis ableiten
+    uint64_t width = filter->width;
+    uint64_t height = filter->height;
+    if (width == 0) {
+        width = (height * target->x + target->y / 2) / target->y;
+    }
+    else if (height == 0) {
+        height = (width * target->y + target->x / 2) / target->x;
+    }
+    if (width > UINT32_MAX || height > UINT32_MAX) {
+        return -1;
+    }
+
+    picture_t resized = { .x = width > 0 ? (uint32_t)width : 1, .y = height > 0 ? (uint32_t)height : 1 };
+    int status = resample_picture(context ? context->pool : NULL, context ? context->simd : SIMD_AUTO, target, &resized, filter->method);
+    if (status) {
+        return status;
+    }
+    pixel_buffer_free(target->pixels);
+    *target = resized;
+    return 0;
+}
+
+
+/**
+ * @brief Band einer zusammengelegten Kettengruppe: optional Emboss, danach alle Overlay-Stufen
+ *
+ * Jede Zeile durchläuft alle Stufen, solange sie noch im Cache liegt. Emboss liest dabei aus dem 
+ * unveränderten Eingabebild (`job->source`), die Overlays arbeiten auf der fertigen Zeile im Ziel.
+ */
+static void fused_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        if (job->source) {
+            emboss_band(job, y, y + 1, thread);
+        }
+        for (uint32_t i = 0; i < job->stageCount; i++) {
+            const pixel_stage_t *stage = &job->stages[i];
+            overlay_rows(job->kernels, stage->filter, stage->overlay, stage->spans, job->target, y, y + 1);
+        }
+    }
+}
+
+/**
+ * @brief Führt eine Gruppe aus [Emboss] & Overlay-Stufen in einem einzigen Durchlauf über das Bild aus
+ *
+ * @return int 0 bei Erfolg, sonst Fehlercode von `acquire_overlay()` oder -3 bei Speicherproblemen
+ */
+static int run_fused_group(filter_context_t *context, filter_descriptor_t *filters, uint32_t count, picture_t *target) {
+    pixel_stage_t stages[FILTER_CHAIN_MAX] = {0};
+    bool emboss = filters[0].preset == EMBOSS;
+    uint32_t stageCount = 0;
+    int status = 0;
+
+    // Alle Overlay-Bilder vor dem Durchlauf laden & skalieren
+    for (uint32_t i = emboss ? 1 : 0; i < count && status == 0; i++) {
+        stages[stageCount].filter = &filters[i];
+        status = acquire_overlay(context, &filters[i], target, &stages[stageCount]);
+        if (status == 0) {
+            stageCount++;
+        }
+    }
+
+    if (status == 0) {
+        band_job_t job = { .kernel = fused_band, .filter = &filters[0], .stages = stages, .stageCount = stageCount };
+        if (emboss) {
+            status = run_into_scratch(context, &job, target);
+        }
+        else {
+            job.target = target;
+            job.kernels = get_row_kernels(context ? context->simd : SIMD_AUTO);
+            job.rows = target->y;
+            status = run_in_bands(context, &job);
+        }
+    }
+
+    for (uint32_t i = 0; i < stageCount; i++) {
+        release_overlay(context, &stages[i]);
+    }
+    return status;
+}
+
+/*
+ * Planare Kernel: dieselben Filter auf getrennten Farbebenen (`planar_t`). Pro Pixel werden 
+ * 3 statt 4 Bytes gelesen & geschrieben, die inneren Schleifen laufen über zusammenhängende 
+ * Bytes einer Ebene. Die Ergebnisse sind bitgenau identisch zu den Kerneln auf `color_t`.
+ */
+
+/**
+ * @brief Wert des Pixels mit linearem Index `i` in Ebene `channel`
+ */
+static inline uint8_t planar_linear(const planar_t *image, unsigned channel, size_t i) {
+    return planar_row(image, channel, (uint32_t)(i / image->x))[i % image->x];
+}
+
+/**
+ * @brief Emboss eines Pixels am Zeilenrand, dessen Nachbarn im linearen Index in der Nachbarzeile liegen
+ */
+static uint8_t emboss_planar_edge(const planar_t *source, unsigned channel, size_t i) {
+    size_t numPixels = (size_t)source->x * source->y;
+    if (i == 0 || i + 1 == numPixels) {
+        return planar_linear(source, channel, i);
+    }
+    return (uint8_t)(planar_linear(source, channel, i + 1) - planar_linear(source, channel, i - 1) + 128);
+}
+
+static void emboss_planar_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    const planar_t *source = job->planarSource;
+    const planar_t *target = job->planarTarget;
+    uint32_t width = target->x;
+
+    for (unsigned c = 0; c < 3; c++) {
+        for (uint32_t y = rowStart; y < rowEnd; y++) {
+            const uint8_t *in = planar_row(source, c, y);
+            uint8_t *out = planar_row(target, c, y);
+            size_t rowIndex = (size_t)y * width;
+
+            out[0] = emboss_planar_edge(source, c, rowIndex);
+            if (width > 2) {
+                job->kernels->embossPlaneSpan(in + 1, out + 1, width - 2);
+            }
+            if (width > 1) {
+                out[width - 1] = emboss_planar_edge(source, c, rowIndex + width - 1);
+            }
+        }
+    }
+}
+
+static void blur_light_planar_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    const planar_t *source = job->planarSource;
+    const planar_t *target = job->planarTarget;
+    uint32_t width = target->x;
+
+    for (unsigned c = 0; c < 3; c++) {
+        for (uint32_t y = rowStart; y < rowEnd; y++) {
+            const uint8_t *current = planar_row(source, c, y);
+            uint8_t *out = planar_row(target, c, y);
+            // Randzeilen & -spalten werden unverändert übernommen
+            if (y == 0 || y + 1 >= target->y || width < 3) {
+                memcpy(out, current, width);
+                continue;
+            }
+
+            const uint8_t *above = planar_row(source, c, y - 1);
+            const uint8_t *below = planar_row(source, c, y + 1);
+            out[0] = current[0];
+            job->kernels->blurLightPlaneRow(above + 1, current + 1, below + 1, out + 1, width - 2);
+            out[width - 1] = current[width - 1];
+        }
+    }
+}
+
+/**
+ * @brief Medium-Blur eines Pixels am Bildrand: fehlende Nachbarn entfallen, geteilt wird trotzdem durch 13
+ */
+static uint8_t blur_medium_planar_edge(const planar_t *source, unsigned channel, uint32_t x, uint32_t y) {
+    static const int8_t offsets[12][2] = {
+        { 1, 1 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { 1, 0 }, { -1, -1 },
+        { 0, -1 }, { 1, -1 }, { 0, -2 }, { 0, 2 }, { 2, 0 }, { -2, 0 },
+    };
+    const uint8_t *current = planar_row(source, channel, y);
+    if (y == 0 || y + 1 == source->y || x == 0 || x + 1 == source->x) {
+        return current[x];
+    }
+
+    uint32_t sum = current[x];
+    for (int i = 0; i < 12; i++) {
+        uint32_t nx = x + (uint32_t)offsets[i][0];    // Negative Koordinaten laufen über & fallen heraus
+        uint32_t ny = y + (uint32_t)offsets[i][1];
+        if (nx < source->x && ny < source->y) {
+            sum += planar_row(source, channel, ny)[nx];
+        }
+    }
+    return (uint8_t)(sum / 13);
+}
+
+static void blur_medium_planar_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    const planar_t *source = job->planarSource;
+    const planar_t *target = job->planarTarget;
+    uint32_t width = target->x;
+
+    for (unsigned c = 0; c < 3; c++) {
+        for (uint32_t y = rowStart; y < rowEnd; y++) {
+            uint8_t *out = planar_row(target, c, y);
+            if (y < 2 || y + 2 >= target->y || width < 5) {
+                for (uint32_t x = 0; x < width; x++) {
+                    out[x] = blur_medium_planar_edge(source, c, x, y);
+                }
+                continue;
+            }
+
+            const uint8_t *const rows[5] = {
+                planar_row(source, c, y - 2) + 2, planar_row(source, c, y - 1) + 2, planar_row(source, c, y) + 2,
+                planar_row(source, c, y + 1) + 2, planar_row(source, c, y + 2) + 2,
+            };
+            out[0] = blur_medium_planar_edge(source, c, 0, y);
+            out[1] = blur_medium_planar_edge(source, c, 1, y);
+            job->kernels->blurMediumPlaneRow(rows, out + 2, width - 4);
+            out[width - 2] = blur_medium_planar_edge(source, c, width - 2, y);
+            out[width - 1] = blur_medium_planar_edge(source, c, width - 1, y);
+        }
+    }
+}
+
+/**
+ * @brief 3x3-Median eines Pixels am Bildrand über die vorhandenen Nachbarn (wie `apply_median_blur()`)
+ */
+static uint8_t median_planar_edge(const planar_t *source, unsigned channel, uint32_t x, uint32_t y) {
+    uint8_t values[8];
+    size_t count = 0;
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            uint32_t nx = x + (uint32_t)dx;
+            uint32_t ny = y + (uint32_t)dy;
+            if ((dx != 0 || dy != 0) && nx < source->x && ny < source->y) {
+                values[count++] = planar_row(source, channel, ny)[nx];
+            }
+        }
+    }
+    if (count == 0) {
+        return planar_row(source, channel, y)[x];    // 1x1-Bild
+    }
+    sort_small(values, count);
+    return values[count / 2];
+}
+
+static void median_blur_planar_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    const planar_t *source = job->planarSource;
+    const planar_t *target = job->planarTarget;
+    uint32_t width = target->x;
 
-        int sumRed = pixelNext.red - pixelPrev.red + 128;
-        int sumGreen = pixelNext.green - pixelPrev.green + 128;
-        int sumBlue = pixelNext.blue - pixelPrev.blue + 128;
+    for (unsigned c = 0; c < 3; c++) {
+        for (uint32_t y = rowStart; y < rowEnd; y++) {
+            uint8_t *out = planar_row(target, c, y);
+            if (y == 0 || y + 1 >= target->y || width < 3) {
+                for (uint32_t x = 0; x < width; x++) {
+                    out[x] = median_planar_edge(source, c, x, y);
+                }
+                continue;
+            }
 
-        pixel.red = (uint8_t)sumRed;
-        pixel.green = (uint8_t)sumGreen;
-        pixel.blue = (uint8_t)sumBlue;
+            const uint8_t *above = planar_row(source, c, y - 1);
+            const uint8_t *current = planar_row(source, c, y);
+            const uint8_t *below = planar_row(source, c, y + 1);
+            out[0] = median_planar_edge(source, c, 0, y);
+            uint32_t x = 1;
+            for (; x + MEDIAN_LANES < width; x += MEDIAN_LANES) {
+                // Die Nachbarn benachbarter Pixel liegen in der Ebene direkt hintereinander
+                uint8_t v[8][MEDIAN_LANES];
+                memcpy(v[0], above + x - 1, MEDIAN_LANES);
+                memcpy(v[1], above + x, MEDIAN_LANES);
+                memcpy(v[2], above + x + 1, MEDIAN_LANES);
+                memcpy(v[3], current + x - 1, MEDIAN_LANES);
+                memcpy(v[4], current + x + 1, MEDIAN_LANES);
+                memcpy(v[5], below + x - 1, MEDIAN_LANES);
+                memcpy(v[6], below + x, MEDIAN_LANES);
+                memcpy(v[7], below + x + 1, MEDIAN_LANES);
+                median_of_8(v, out + x);
+            }
+            for (; x < width; x++) {
+                out[x] = median_planar_edge(source, c, x, y);
+            }
+        }
+    }
+}
 
-        target->pixels[i] = pixel; 
+/**
+ * @brief Fügt eine Spalte des Fensters zum Histogramm einer Ebene hinzu oder entfernt sie
+ */
+static void histogram_planar_column(median_histogram_t *histogram, const planar_t *source, unsigned channel, 
+                                    uint32_t x, uint32_t yStart, uint32_t yEnd, bool add) {
+    const uint8_t *pixel = planar_row(source, channel, yStart) + x;
+    for (uint32_t y = yStart; y <= yEnd; y++, pixel += source->stride) {
+        if (add) {
+            histogram_add(histogram, *pixel);
+        }
+        else {
+            histogram_remove(histogram, *pixel);
+        }
     }
+}
 
-    return 0;
-}  
+static void median_histogram_planar_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    const planar_t *source = job->planarSource;
+    const planar_t *target = job->planarTarget;
+    uint32_t radius = job->filter->radius;
 
-void apply_median_blur(color_t *neighbor[8], color_t *currentPixel) {
-    uint8_t red[8];
-    uint8_t green[8];
-    uint8_t blue[8];
+    for (unsigned c = 0; c < 3; c++) {
+        for (uint32_t y = rowStart; y < rowEnd; y++) {
+            uint32_t yStart = y > radius ? y - radius : 0;
+            uint32_t yEnd = y + radius < target->y ? y + radius : target->y - 1;
+            uint32_t windowRows = yEnd - yStart + 1;
 
-    size_t redCount = 0;
-    size_t greenCount = 0;
-    size_t blueCount = 0;
+            median_histogram_t histogram;
+            memset(&histogram, 0, sizeof(histogram));
+            for (uint32_t x = 0; x <= radius && x < target->x; x++) {
+                histogram_planar_column(&histogram, source, c, x, yStart, yEnd, true);
+            }
 
-    for (size_t i = 0; i < 8; i++) {
-        if (neighbor[i] != NULL) {
-            red[redCount++] = neighbor[i]->red;
-            green[greenCount++] = neighbor[i]->green;
-            blue[blueCount++] = neighbor[i]->blue;
+            const uint8_t *current = planar_row(source, c, y);
+            uint8_t *out = planar_row(target, c, y);
+            for (uint32_t x = 0; x < target->x; x++) {
+                if (x > radius) {
+                    histogram_planar_column(&histogram, source, c, x - radius - 1, yStart, yEnd, false);
+                }
+                if (x > 0 && x + radius < target->x) {
+                    histogram_planar_column(&histogram, source, c, x + radius, yStart, yEnd, true);
+                }
+                uint32_t xStart = x > radius ? x - radius : 0;
+                uint32_t xEnd = x + radius < target->x ? x + radius : target->x - 1;
+                uint32_t count = windowRows * (xEnd - xStart + 1) - 1;    // ohne Zentrum
+
+                out[x] = current[x];
+                if (count == 0) {
+                    continue;
+                }
+                histogram_remove(&histogram, current[x]);
+                out[x] = histogram_kth(&histogram, count / 2);
+                histogram_add(&histogram, current[x]);
+            }
         }
     }
+}
 
-    // Sortieren der Farbkanäle
-    qsort(red, redCount, sizeof(uint8_t), compare);
-    qsort(green, greenCount, sizeof(uint8_t), compare);
-    qsort(blue, blueCount, sizeof(uint8_t), compare);
+/**
+ * @brief `box_blur_row()` für eine Zeile einer Ebene
+ *
+ * Das Fenster ragt nur an den Zeilenenden über den Rand, dazwischen läuft eine Schleife ohne Randprüfung.
+ */
+static void box_blur_planar_row(const uint8_t *in, uint8_t *out, uint32_t width, uint32_t radius) {
+    int64_t last = (int64_t)width - 1;
+    uint64_t size = 2 * (uint64_t)radius + 1;
+    uint64_t reciprocal = ((1ull << 32) + size - 1) / size;
+    uint32_t sum = 0;
 
-    // Median anwenden
-    currentPixel->red = red[redCount / 2];    // redCount enthält die Anzahl der gültigen Pixel für rot 
-    currentPixel->green = green[greenCount / 2];
-    currentPixel->blue = blue[blueCount / 2];
+    for (int64_t k = -(int64_t)radius; k <= (int64_t)radius; k++) {
+        sum += in[k < 0 ? 0 : (k > last ? last : k)];
+    }
+
+    // Inneres: x - radius >= 0 & x + radius + 1 <= last
+    int64_t innerStart = radius;
+    int64_t innerEnd = last - (int64_t)radius - 1;
+    int64_t x = 0;
+    for (; x <= last && x < innerStart; x++) {
+        out[x] = (uint8_t)(((sum + size / 2) * reciprocal) >> 32);
+        int64_t enter = x + radius + 1;
+        int64_t leave = x - radius;
+        sum += in[enter > last ? last : enter] - in[leave < 0 ? 0 : leave];
+    }
+    for (; x <= innerEnd; x++) {
+        out[x] = (uint8_t)(((sum + size / 2) * reciprocal) >> 32);
+        sum += in[x + radius + 1] - in[x - radius];
+    }
+    for (; x <= last; x++) {
+        out[x] = (uint8_t)(((sum + size / 2) * reciprocal) >> 32);
+        int64_t enter = x + radius + 1;
+        int64_t leave = x - radius;
+        sum += in[enter > last ? last : enter] - in[leave < 0 ? 0 : leave];
+    }
 }
 
-int median_blur_filter(picture_t *target) {
-    if (!target) {
-        return -1; 
+/**
+ * @brief `separable_blur_band()` für planare Bilder, jede Ebene wird einzeln gefiltert & transponiert
+ *
+ * Die Bänder sind PLANAR_BAND_ROWS Zeilen hoch, damit jede transponierte Spalte eine ganze Cachezeile 
+ * füllt (bei 16 Zeilen teilten sich vier Bänder & damit mehrere Threads jede Zielcachezeile).
+ */
+static void separable_blur_planar_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    const planar_t *source = job->planarSource;
+    const planar_t *target = job->planarTarget;    // target->x == source->y, target->y == source->x
+    const box_plan_t *plan = job->boxPlan;
+    uint32_t width = source->x;
+    uint32_t bandRows = rowEnd - rowStart;
+
+    uint8_t *band = (uint8_t *)(job->workspace + thread * job->workspaceStride);
+    uint8_t *ping = band + (size_t)PLANAR_BAND_ROWS * width;
+    uint8_t *pong = ping + width;
+
+    for (unsigned c = 0; c < 3; c++) {
+        for (uint32_t y = rowStart; y < rowEnd; y++) {
+            const uint8_t *in = planar_row(source, c, y);
+            uint8_t *out = band + (size_t)(y - rowStart) * width;
+            for (uint32_t pass = 0; pass < plan->passes; pass++) {
+                uint8_t *passOut = (pass + 1 == plan->passes) ? out : (pass % 2 ? pong : ping);
+                box_blur_planar_row(in, passOut, width, plan->radius[pass]);
+                in = passOut;
+            }
+        }
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t *column = planar_row(target, c, x) + rowStart;
+            for (uint32_t k = 0; k < bandRows; k++) {
+                column[k] = band[(size_t)k * width + x];
+            }
+        }
     }
-    
-    for (uint32_t y = 0; y < target->y; y++) {
-        for (uint32_t x = 0; x < target->x; x++) {
-            color_t *neighbor[8];
-
-            // Nachbarn speichern
-            neighbor[0] = get_pixel(target, x, y+1);    
-            neighbor[1] = get_pixel(target, x+1, y+1);
-            neighbor[2] = get_pixel(target, x+1, y);
-            neighbor[3] = get_pixel(target, x+1, y-1);
-            neighbor[4] = get_pixel(target, x, y-1);
-            neighbor[5] = get_pixel(target, x-1, y-1);
-            neighbor[6] = get_pixel(target, x-1, y);
-            neighbor[7] = get_pixel(target, x-1, y+1);
-
-            color_t *currentPixel = get_pixel(target, x, y);    // Zentrum
-            apply_median_blur(neighbor, currentPixel);    
-        }  
-    }   
-    return 0;
 }
 
-int apply_overlay(filter_descriptor_t *filter, picture_t *target) {
-    if (!filter || !target) {
-        return -1; 
+/**
+ * @brief `overlay_rows()` für planare Zielbilder, das Overlay-Bild bleibt ein `color_t`-Bild
+ *
+ * Jede Ebene wird in einer eigenen Schleife ohne Sprünge bearbeitet. Die Rahmen prüfen dabei 
+ * weiterhin alle drei Kanäle des Overlay-Pixels, um auszulassende Stellen zu erkennen.
+ */
+static void overlay_planar_rows(const filter_descriptor_t *filter, const picture_t *overlay, const planar_t *target, 
+                                uint32_t rowStart, uint32_t rowEnd) {
+    uint32_t width = target->x < overlay->x ? target->x : overlay->x;
+    if (rowEnd > overlay->y) {
+        rowEnd = overlay->y;
     }
+    // Rahmen übernehmen das Overlay-Pixel: schwarze Rahmen lassen weiße, weiße Rahmen schwarze Stellen aus
+    bool frame = filter->preset == BLACKFRAME || filter->preset == WHITEFRAME;
+    uint8_t skip = filter->preset == BLACKFRAME ? 0xff : 0x00;
+    // Sonst Mittelwert, mit color= nur für die gewählten Kanäle
+    const bool blend[3] = {
+        !filter->useColor || filter->color.red,
+        !filter->useColor || filter->color.green,
+        !filter->useColor || filter->color.blue,
+    };
+    const size_t offsets[3] = { offsetof(color_t, red), offsetof(color_t, green), offsetof(color_t, blue) };
+    bool alpha = picture_has_alpha(overlay);
+    unsigned mask = overlay_channel_mask(filter);
 
-    // Filterpfad basierend auf Preset setzen
-    picture_t filterImage;
-    char *path; 
-    switch(filter->preset) {
-        case SNOWFLAKES:
-            path = "assets/snowflakes.ppm";
-            break; 
-        case HEARTS: 
-            path = "assets/hearts.ppm";
-            break; 
-        case STARS: 
-            path = "assets/stars.ppm";
-            break; 
-        case BLACKFRAME:
-            path = "assets/blackframe.ppm";
-            break; 
-        case WHITEFRAME:
-            path = "assets/whiteframe.ppm";
-            break;
-        case OVERLAY:
-            path = filter->path; 
-            break; 
-        default: 
-            return -2; 
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        const uint8_t *frameBytes = (const uint8_t *)picture_row(overlay, y);
+        for (unsigned c = 0; c < 3; c++) {
+            uint8_t *out = planar_row(target, c, y);
+            const uint8_t *values = frameBytes + offsets[c];
+            if (alpha) {
+                if (mask & (1u << c)) {
+                    for (uint32_t x = 0; x < width; x++) {
+                        const uint8_t *pixel = frameBytes + (size_t)x * sizeof(color_t);
+                        out[x] = composite_channel(out[x], pixel[offsets[c]], pixel[offsetof(color_t, alpha)]);
+                    }
+                }
+            }
+            else if (frame) {
+                for (uint32_t x = 0; x < width; x++) {
+                    const uint8_t *pixel = frameBytes + (size_t)x * sizeof(color_t);
+                    bool keep = pixel[offsetof(color_t, red)] == skip && pixel[offsetof(color_t, green)] == skip 
+                                && pixel[offsetof(color_t, blue)] == skip;
+                    out[x] = keep ? out[x] : values[(size_t)x * sizeof(color_t)];
+                }
+            }
+            else if (blend[c]) {
+                for (uint32_t x = 0; x < width; x++) {
+                    out[x] = (uint8_t)(((uint32_t)out[x] + values[(size_t)x * sizeof(color_t)]) / 2);
+                }
+            }
+        }
     }
+}
 
-    // Filterbild laden
-    int status = load_picture_from_path(path, &filterImage);
-    if (status) {
-        return status;
-    } 
+/**
+ * @brief Band aufeinanderfolgender Overlay-Stufen, jede Zeile durchläuft alle Stufen (wie `fused_band()`)
+ */
+static void overlay_planar_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        for (uint32_t i = 0; i < job->stageCount; i++) {
+            const pixel_stage_t *stage = &job->stages[i];
+            if (stage->spans) {
+                overlay_spans_apply_planar(stage->spans, job->planarTarget, y, y + 1);
+            }
+            else {
+                overlay_planar_rows(stage->filter, stage->overlay, job->planarTarget, y, y + 1);
+            }
+        }
+    }
+}
 
-    // Filterbild skalieren
-    scale_t scale = get_scale(&filterImage, target);
-    status = scale_image(&filterImage, scale);
-    if (status) {
-        if (filterImage.pixels) {
-            free (filterImage.pixels);
-            filterImage.pixels = NULL;
+/**
+ * @brief Führt aufeinanderfolgende Overlay-Stufen in einem einzigen Durchlauf über das planare Bild aus
+ *
+ * @return int 0 bei Erfolg, sonst Fehlercode von `acquire_overlay()`
+ */
+static int run_planar_overlays(filter_context_t *context, filter_descriptor_t *filters, uint32_t count, planar_t *target) {
+    // Overlay-Bilder werden nur anhand der Abmessungen des Zielbildes skaliert
+    picture_t size = { .maxColorValue = target->maxColorValue, .x = target->x, .y = target->y };
+    pixel_stage_t stages[FILTER_CHAIN_MAX] = {0};
+    uint32_t stageCount = 0;
+    int status = 0;
+
+    for (uint32_t i = 0; i < count && status == 0; i++) {
+        stages[stageCount].filter = &filters[i];
+        status = acquire_overlay(context, &filters[i], &size, &stages[stageCount]);
+        if (status == 0) {
+            stageCount++;
         }
+    }
+    if (status == 0) {
+        band_job_t job = { .kernel = overlay_planar_band, .planarTarget = target, .stages = stages, 
+                           .stageCount = stageCount, .rows = target->y };
+        status = run_in_bands(context, &job);
+    }
+
+    for (uint32_t i = 0; i < stageCount; i++) {
+        release_overlay(context, &stages[i]);
+    }
+    return status;
+}
+
+/**
+ * @brief `run_into_scratch()` für planare Bilder: Ebenen aus `target` lesen, in den Scratch-Puffer schreiben & tauschen
+ *
+ * @return int 0 bei Erfolg, -3 bei Speicherproblemen
+ */
+static int run_planar_into_scratch(filter_context_t *context, band_job_t *job, planar_t *target) {
+    size_t count;
+    if (planar_buffer_size(target->x, target->y, &count) != 0) {
+        return -1;
+    }
+    filter_context_t local = {0};
+    if (!context) {
+        context = &local;
+    }
+    if (reserve_scratch(context, count) != 0) {
+        return -3;
+    }
+
+    planar_t destination = *target;
+    planar_attach(&destination, context->scratch);
+    job->planarSource = target;
+    job->planarTarget = &destination;
+    job->kernels = get_row_kernels(context->simd);
+    job->rows = target->y;
+    int status = run_in_bands(context, job);
+    if (status) {
+        pixel_buffer_free(local.scratch);
         return status;
     }
-    
-    // Overlay anwenden
-    for (uint32_t x = 0; x < target->x; x++) {
-        for (uint32_t y = 0; y < target->y; y++) {
-            color_t *currentPixel = get_pixel(target, x, y);
-            color_t *currentPixelOfTheFrame = get_pixel(&filterImage, x, y);
 
-            if (!currentPixel || !currentPixelOfTheFrame) {
-                continue;
+    // Puffer tauschen
+    context->scratch = target->buffer;
+    context->scratchCapacity = count;
+    planar_attach(target, destination.buffer);
+    pixel_buffer_free(local.scratch);
+    return 0;
+}
+
+/**
+ * @brief `run_separable_blur()` für planare Bilder
+ *
+ * @return int 0 bei Erfolg, -1 bei ungültiger Größe, -3 bei Speicherproblemen
+ */
+static int run_separable_planar_blur(filter_context_t *context, const box_plan_t *plan, planar_t *target) {
+    // Transponiert hat jede Zeile eine andere Auffüllung, der Scratch-Puffer muss beide Varianten fassen
+    size_t count;
+    size_t transposedCount;
+    if (planar_buffer_size(target->x, target->y, &count) != 0 
+        || planar_buffer_size(target->y, target->x, &transposedCount) != 0) {
+        return -1;
+    }
+    filter_context_t local = {0};
+    if (!context) {
+        context = &local;
+    }
+    if (reserve_scratch(context, count > transposedCount ? count : transposedCount) != 0) {
+        return -3;
+    }
+
+    uint32_t longest = target->x > target->y ? target->x : target->y;
+    size_t stride = ((size_t)(PLANAR_BAND_ROWS + 2) * longest + sizeof(color_t) - 1) / sizeof(color_t);
+    color_t *workspace = malloc(thread_pool_size(context->pool) * stride * sizeof(color_t));
+    if (!workspace) {
+        pixel_buffer_free(local.scratch);
+        return -3;
+    }
+
+    planar_t transposed = *target;
+    transposed.x = target->y;
+    transposed.y = target->x;
+    planar_attach(&transposed, context->scratch);
+
+    band_job_t horizontal = { .kernel = separable_blur_planar_band, .planarSource = target, .planarTarget = &transposed, 
+                              .boxPlan = plan, .workspace = workspace, .workspaceStride = stride, 
+                              .bandRows = PLANAR_BAND_ROWS, .rows = target->y };
+    int status = run_in_bands(context, &horizontal);
+    if (status == 0) {
+        band_job_t vertical = { .kernel = separable_blur_planar_band, .planarSource = &transposed, .planarTarget = target, 
+                                .boxPlan = plan, .workspace = workspace, .workspaceStride = stride, 
+                                .bandRows = PLANAR_BAND_ROWS, .rows = transposed.y };
+        status = run_in_bands(context, &vertical);
+    }
+
+    free(workspace);
+    pixel_buffer_free(local.scratch);
+    return status;
+}
+
+/**
+ * @brief `apply_filter()` für planare Bilder (ohne Overlays, siehe `run_planar_overlays()`)
+ *
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben, -2 bei unbekanntem Filter, -3 bei Speicherproblemen
+ */
+static int apply_filter_planar(filter_context_t *context, const filter_descriptor_t *filter, planar_t *target) {
+    band_job_t job = { .filter = filter };
+    box_plan_t plan = { .passes = 1, .radius = { filter->radius ? filter->radius : 1 } };
+
+    switch (filter->preset) {
+        case EMBOSS:
+            job.kernel = emboss_planar_band;
+            return run_planar_into_scratch(context, &job, target);
+        case BLUR:
+            if (filter->radius > MEDIAN_MAX_RADIUS) {
+                return -1;
             }
-                
-            // Schwarzer Rahmen: weiße Stellen ignorieren
-            if (filter->preset == BLACKFRAME) {
-                if (currentPixelOfTheFrame->red == 0xff && currentPixelOfTheFrame->green == 0xff && currentPixelOfTheFrame->blue == 0xff) {
-                    continue;  
-                }
-                *currentPixel = *currentPixelOfTheFrame;
+            job.kernel = filter->radius > 1 ? median_histogram_planar_band : median_blur_planar_band;
+            return run_planar_into_scratch(context, &job, target);
+        case BLURLIGHT:
+            job.kernel = blur_light_planar_band;
+            return run_planar_into_scratch(context, &job, target);
+        case BLURMEDIUM:
+            job.kernel = blur_medium_planar_band;
+            return run_planar_into_scratch(context, &job, target);
+        case BLURBOX:
+            if (filter->radius > BOX_MAX_RADIUS) {
+                return -1;
             }
-
-            // Weißer Rahmen: schwarze Stellen ignorieren
-            else if (filter->preset == WHITEFRAME) {
-                if (currentPixelOfTheFrame->red == 0x00 && currentPixelOfTheFrame->green == 0x00 && currentPixelOfTheFrame->blue == 0x00) {
-                    continue;  
-                }
-                *currentPixel = *currentPixelOfTheFrame;
+            return run_separable_planar_blur(context, &plan, target);
+        case BLURGAUSSIAN:
+            if (gaussian_box_plan(filter, &plan) != 0) {
+                return -1;
             }
+            return run_separable_planar_blur(context, &plan, target);
+        default:
+            return -2;
+    }
+}
 
-            // Durchschnitt für RGB für Overlay-Effekt
-            uint32_t sumRed = currentPixel->red;
-            uint32_t sumGreen = currentPixel->green;
-            uint32_t sumBlue = currentPixel->blue;
+int build_filter_chain(filter_chain_t *chain, const filter_descriptor_t *options, const char *names) {
+    if (!chain || !options || !names) {
+        return -1;
+    }
 
-            // filter->color.blue = 0xFF;
-            // filter->color.red = 0xFF;
-            // filter->color.green = 0xFF;
+    int status = 0;
+    chain->count = 0;
+    while (*names) {
+        const char *separator = strchr(names, ',');
+        size_t length = separator ? (size_t)(separator - names) : strlen(names);
+        if (chain->count == FILTER_CHAIN_MAX) {
+            return -1;
+        }
 
-            if (filter->useColor) {
-                    if (!!filter->color.red) {
-                    sumRed += currentPixelOfTheFrame->red * !!filter->color.red;
-                    currentPixel->red = (uint8_t)(sumRed / 2);
-                }
+        // Name der Stufe kopieren, alle anderen Optionen gelten für jede Stufe
+        char name[32] = {0};
+        if (length < sizeof(name)) {
+            memcpy(name, names, length);
+        }
+        filter_descriptor_t *stage = &chain->stages[chain->count++];
+        *stage = *options;
+        set_filter_from_name(stage, name);
+        if (stage->preset == UNKNOWN) {
+            status = -1;
+        }
 
-                if (!!filter->color.green) {
-                    sumGreen += currentPixelOfTheFrame->green * !!filter->color.green;
-                    currentPixel->green = (uint8_t)(sumGreen / 2);
-                }
+        names += length;
+        if (*names == ',') {
+            names++;
+        }
+    }
+    return chain->count > 0 ? status : -1;
+}
 
-                if (!!filter->color.blue) {
-                    sumBlue += currentPixelOfTheFrame->blue * !!filter->color.blue;
-                    currentPixel->blue = (uint8_t)(sumBlue / 2);
-                }
-            } 
-            
-            else {
-                sumRed += currentPixelOfTheFrame->red;
-                sumGreen += currentPixelOfTheFrame->green;
-                sumBlue += currentPixelOfTheFrame->blue;
-                currentPixel->red = (uint8_t)(sumRed / 2);
-                currentPixel->green = (uint8_t)(sumGreen / 2);
-                currentPixel->blue = (uint8_t)(sumBlue / 2);
-            }
-        }    
-    } 
+int apply_filter_chain(filter_context_t *context, filter_chain_t *chain, picture_t *target) {
+    if (!chain || !target) {
+        return -1;
+    }
+    if (chain->count == 0) {
+        return -2;
+    }
 
-    if (filterImage.pixels) {
-        free(filterImage.pixels);
-        filterImage.pixels = NULL;
+    uint32_t i = 0;
+    while (i < chain->count) {
+        // Gruppe bestimmen: optional Emboss am Anfang, gefolgt von Overlays
+        uint32_t end = i;
+        if (chain->stages[end].preset == EMBOSS) {
+            end++;
+        }
+        while (end < chain->count && is_overlay_preset(chain->stages[end].preset)) {
+            end++;
+        }
+
+        int status;
+        double start = stats_now();
+        bool legacy = context && context->legacyInPlace;
+        if (end - i >= 2 && !legacy) {
+            status = run_fused_group(context, &chain->stages[i], end - i, target);
+            stats_span("fused pass", "filter", start);
+        }
+        else {
+            end = i + 1;
+            status = apply_filter(context, &chain->stages[i], target);
+            stats_span(get_filter_name(&chain->stages[i]), "filter", start);
+        }
+        if (status != 0) {
+            return status;
+        }
+        i = end;
     }
     return 0;
 }
 
-int blur_filter_light(picture_t *target) {
-    if (!target) {
-        return -1;  
+int apply_filter_chain_planar(filter_context_t *context, filter_chain_t *chain, planar_t *target) {
+    if (!chain || !target || !target->buffer) {
+        return -1;
+    }
+    if (chain->count == 0) {
+        return -2;
     }
 
-    for (uint32_t y = 1; y < target->y - 1; y++) {
-        for (uint32_t x = 1; x < target->x - 1; x++) {
-            
-            color_t *currentPixel = get_pixel(target, x, y);
-            color_t *abovePixel = get_pixel(target, x, y-1);
-            color_t *belowPixel = get_pixel(target, x, y+1);
-            color_t *leftPixel = get_pixel(target, x-1, y);
-            color_t *rightPixel = get_pixel(target, x+1, y);
-            
-            // Berechnung der Summen der Farbwerte der benachbarten Pixel
-            uint32_t sumRed = currentPixel->red + abovePixel->red + belowPixel->red + leftPixel->red + rightPixel->red;
-            uint32_t sumGreen = currentPixel->green + abovePixel->green + belowPixel->green + leftPixel->green + rightPixel->green;
-            uint32_t sumBlue = currentPixel->blue + abovePixel->blue + belowPixel->blue + leftPixel->blue + rightPixel->blue;
+    uint32_t i = 0;
+    while (i < chain->count) {
+        // Aufeinanderfolgende Overlays laufen zusammen, alle anderen Stufen einzeln
+        uint32_t end = i;
+        while (end < chain->count && is_overlay_preset(chain->stages[end].preset)) {
+            end++;
+        }
 
-            // Durchschnitt der Nachbarn berechnen
-            currentPixel->red  = (uint8_t)(sumRed / 5); 
-            currentPixel->green = (uint8_t)(sumGreen / 5); 
-            currentPixel->blue = (uint8_t)(sumBlue / 5); 
+        int status;
+        double start = stats_now();
+        if (end > i) {
+            status = run_planar_overlays(context, &chain->stages[i], end - i, target);
+            stats_span(end - i > 1 ? "fused pass" : get_filter_name(&chain->stages[i]), "filter", start);
+        }
+        else {
+            end = i + 1;
+            status = apply_filter_planar(context, &chain->stages[i], target);
+            stats_span(get_filter_name(&chain->stages[i]), "filter", start);
         }
+        if (status != 0) {
+            return status;
+        }
+        i = end;
     }
     return 0;
 }
 
-int blur_filter_medium(picture_t *target) {
-    if (!target) {
-        return -1;     
+/**
+ * @brief `overlay_rows()` für gepackte RGB-Zeilen: übersprungene Rahmenstellen werden nicht beschrieben
+ */
+static void overlay_packed_rows(const filter_descriptor_t *filter, const picture_t *overlay, const packed_t *target, 
+                                uint32_t rowStart, uint32_t rowEnd) {
+    uint32_t width = target->x < overlay->x ? target->x : overlay->x;
+    if (rowEnd > overlay->y) {
+        rowEnd = overlay->y;
     }
-    
-    for (uint32_t y = 1; y < target->y - 1; y++) {
-        for (uint32_t x = 1; x < target->x - 1; x++) {
-            color_t *neighbor[12];
-
-            color_t *currentPixel = get_pixel(target, x, y);
-            neighbor[0] = get_pixel(target, x+1, y+1);
-            neighbor[1]= get_pixel(target, x, y+1);
-            neighbor[2] = get_pixel(target, x-1, y+1);
-            neighbor[3] = get_pixel(target, x-1, y);
-            neighbor[4] = get_pixel(target, x+1, y);
-            neighbor[5] = get_pixel(target, x-1, y-1);
-            neighbor[6] = get_pixel(target, x, y-1);
-            neighbor[7] = get_pixel(target, x+1, y-1);
-            neighbor[8] = get_pixel(target, x, y-2);
-            neighbor[9] = get_pixel(target, x, y+2);
-            neighbor[10] = get_pixel(target, x+2,y); 
-            neighbor[11] = get_pixel(target, x-2, y);
-
-            uint32_t sumRed = currentPixel->red;
-            uint32_t sumGreen = currentPixel->green;
-            uint32_t sumBlue = currentPixel->blue;
-               
-            for (size_t i = 0; i < 12; i++) {
-                if (neighbor[i] != NULL) {
-                    sumRed += neighbor[i]->red;
-                    sumGreen += neighbor[i]->green;
-                    sumBlue += neighbor[i]->blue;
+    bool frame = filter->preset == BLACKFRAME || filter->preset == WHITEFRAME;
+    uint8_t skip = filter->preset == BLACKFRAME ? 0xff : 0x00;
+    const bool blend[3] = {
+        !filter->useColor || filter->color.red,
+        !filter->useColor || filter->color.green,
+        !filter->useColor || filter->color.blue,
+    };
+    bool alpha = picture_has_alpha(overlay);
+    unsigned mask = overlay_channel_mask(filter);
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        uint8_t *out = target->bytes + (size_t)y * target->x * 3;
+        const color_t *frameRow = picture_row(overlay, y);
+
+        for (uint32_t x = 0; x < width; x++, out += 3) {
+            const color_t *pixel = &frameRow[x];
+            if (alpha) {
+                // Vormultipliziertes Overlay über das Pixel legen, durchsichtige Stellen bleiben unberührt
+                if (pixel->alpha == 0) {
+                    continue;
+                }
+                const uint8_t values[3] = { pixel->red, pixel->green, pixel->blue };
+                for (unsigned c = 0; c < 3; c++) {
+                    if (mask & (1u << c)) {
+                        out[c] = composite_channel(out[c], values[c], pixel->alpha);
+                    }
+                }
+                continue;
+            }
+            if (frame) {
+                // Rahmen übernehmen das Overlay-Pixel, die ausgelassenen Stellen bleiben unberührt
+                if (pixel->red == skip && pixel->green == skip && pixel->blue == skip) {
+                    continue;
                 }
+                out[0] = pixel->red;
+                out[1] = pixel->green;
+                out[2] = pixel->blue;
+            }
+            if (blend[0]) {
+                out[0] = (uint8_t)(((uint32_t)out[0] + pixel->red) / 2);
+            }
+            if (blend[1]) {
+                out[1] = (uint8_t)(((uint32_t)out[1] + pixel->green) / 2);
             }
-            currentPixel->red = sumRed / 13;
-            currentPixel->green = sumGreen / 13;
-            currentPixel->blue = sumBlue / 13;  
+            if (blend[2]) {
+                out[2] = (uint8_t)(((uint32_t)out[2] + pixel->blue) / 2);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Band aufeinanderfolgender Overlay-Stufen auf gepackten RGB-Zeilen (wie `overlay_planar_band()`)
+ */
+static void overlay_packed_band(const band_job_t *job, uint32_t rowStart, uint32_t rowEnd, unsigned thread) {
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        for (uint32_t i = 0; i < job->stageCount; i++) {
+            const pixel_stage_t *stage = &job->stages[i];
+            if (stage->spans) {
+                overlay_spans_apply_packed(stage->spans, job->packedTarget, y, y + 1);
+            }
+            else {
+                overlay_packed_rows(stage->filter, stage->overlay, job->packedTarget, y, y + 1);
+            }
+        }
+    }
+}
+
+int apply_filter_chain_packed(filter_context_t *context, filter_chain_t *chain, const packed_t *target) {
+    if (!chain || !target || !target->bytes || target->maxColorValue > 255) {
+        return -1;
+    }
+    if (chain->count == 0) {
+        return -2;
+    }
+    for (uint32_t i = 0; i < chain->count; i++) {
+        if (!is_overlay_preset(chain->stages[i].preset)) {
+            return -2;
         }
     }
-    return  0;
+
+    // Alle Stufen laufen in einem Durchlauf, die Overlay-Bilder werden nur anhand der Abmessungen skaliert
+    double start = stats_now();
+    picture_t size = { .maxColorValue = target->maxColorValue, .x = target->x, .y = target->y };
+    pixel_stage_t stages[FILTER_CHAIN_MAX] = {0};
+    uint32_t stageCount = 0;
+    int status = 0;
+    for (uint32_t i = 0; i < chain->count && status == 0; i++) {
+        stages[stageCount].filter = &chain->stages[i];
+        status = acquire_overlay(context, &chain->stages[i], &size, &stages[stageCount]);
+        if (status == 0) {
+            stageCount++;
+        }
+    }
+    if (status == 0) {
+        band_job_t job = { .kernel = overlay_packed_band, .packedTarget = target, .stages = stages, 
+                           .stageCount = stageCount, .rows = target->y };
+        status = run_in_bands(context, &job);
+    }
+
+    for (uint32_t i = 0; i < stageCount; i++) {
+        release_overlay(context, &stages[i]);
+    }
+    stats_span(chain->count > 1 ? "fused pass" : get_filter_name(&chain->stages[0]), "filter", start);
+    return status;
+}
+
+int filter_stream_halo(const filter_descriptor_t *filter) {
+    if (!filter) {
+        return -1;
+    }
+    switch (filter->preset) {
+        case EMBOSS:        // Vorgänger & Nachfolger im linearen Index, am Zeilenrand also die Nachbarzeile
+        case BLURLIGHT:
+            return 1;
+        case BLURMEDIUM:
+            return 2;
+        case BLUR:
+            if (filter->radius > MEDIAN_MAX_RADIUS) {
+                return -1;
+            }
+            return filter->radius > 1 ? (int)filter->radius : 1;
+        default:
+            return is_overlay_preset(filter->preset) ? 0 : -1;
+    }
+}
+
+int apply_filter_rows(filter_context_t *context, const filter_descriptor_t *filter, const picture_t *source, 
+                      picture_t *target, uint32_t rowStart, uint32_t rowEnd, const picture_t *overlay) {
+    if (!filter || !source || !target || rowEnd > source->y || rowStart > rowEnd) {
+        return -1;
+    }
+    if (source->pixels == target->pixels && !is_overlay_preset(filter->preset)) {
+        return -1;    // Nachbarschaftsfilter brauchen ein unverändertes Eingabebild
+    }
+
+    band_kernel_t kernel;
+    switch (filter->preset) {
+        case EMBOSS:
+            kernel = emboss_band;
+            break;
+        case BLUR:
+            kernel = filter->radius > 1 ? median_histogram_band : median_blur_band;
+            break;
+        case BLURLIGHT:
+            kernel = blur_light_band;
+            break;
+        case BLURMEDIUM:
+            kernel = blur_medium_band;
+            break;
+        default:
+            if (!is_overlay_preset(filter->preset) || !overlay) {
+                return -2;
+            }
+            // Overlays arbeiten direkt im Ziel, bei getrennten Puffern werden die Zeilen vorher kopiert
+            if (source->pixels != target->pixels) {
+                memcpy(picture_row_bytes(target, rowStart), picture_row_bytes(source, rowStart), 
+                       (size_t)(rowEnd - rowStart) * source->x * picture_pixel_size(source));
+            }
+            kernel = overlay_band;
+            break;
+    }
+
+    band_job_t job = { .kernel = kernel, .source = source, .target = target, .filter = filter, .overlay = overlay, 
+                       .kernels = get_row_kernels(context ? context->simd : SIMD_AUTO), .firstRow = rowStart, .rows = rowEnd };
+    if (kernel == median_histogram_band && picture_is_16bit(target) && attach_histograms16(context, &job) != 0) {
+        return -3;
+    }
+    int status = run_in_bands(context, &job);
+    free(job.workspace);
+    return status;
 }
 
-int apply_filter(filter_descriptor_t *filter, picture_t *target) { 
+void filter_context_release(filter_context_t *context) {
+    if (!context) {
+        return;
+    }
+    thread_pool_destroy(context->pool);
+    context->pool = NULL;
+    pixel_buffer_free(context->scratch);
+    context->scratch = NULL;
+    context->scratchCapacity = 0;
+    asset_cache_destroy(context->assets);
+    context->assets = NULL;
+}
+
+int apply_filter(filter_context_t *context, filter_descriptor_t *filter, picture_t *target) { 
     if (!filter || !target) {
         return -1;
     }
     switch (filter->preset) {
         case EMBOSS:
-            return apply_emboss(filter, target);
+            return apply_emboss(context, filter, target);
         case BLUR:
-            return median_blur_filter(target);
+            return median_blur_filter(context, filter, target);
         case BLURLIGHT:
-            return blur_filter_light(target);
+            return blur_filter_light(context, target);
         case BLURMEDIUM:
-            return blur_filter_medium(target);
+            return blur_filter_medium(context, target);
+        case BLURBOX:
+            return blur_filter_box(context, filter, target);
+        case BLURGAUSSIAN:
+            return blur_filter_gaussian(context, filter, target);
+        case RESIZE:
+            return resize_filter(context, filter, target);
         case OVERLAY:
         case WHITEFRAME:
         case BLACKFRAME:
         case HEARTS:
         case STARS:
         case SNOWFLAKES:
-            return apply_overlay(filter, target);
+            return apply_overlay(context, filter, target);
         default:
             return -2;
     }
@@ -330,17 +2586,62 @@ void set_filter_from_name(filter_descriptor_t *filter, const char *name) {
     else if (strcmp(name, "blur-medium") == 0) {
         filter->preset = BLURMEDIUM;
     }
+    else if (strcmp(name, "blur-box") == 0) {
+        filter->preset = BLURBOX;
+    }
+    else if (strcmp(name, "blur-gaussian") == 0) {
+        filter->preset = BLURGAUSSIAN;
+    }
     else if (strcmp(name, "whiteframe") == 0) {
         filter->preset = WHITEFRAME; 
     }
     else if (strcmp(name, "blackframe") == 0) {
         filter->preset = BLACKFRAME; 
     }
+    else if (strcmp(name, "resize") == 0) {
+        filter->preset = RESIZE;
+    }
     else {
         filter->preset = UNKNOWN;
     }
 }
 
+const char *get_filter_name(const filter_descriptor_t *filter) {
+    if (!filter) {
+        return "unknown";
+    }
+    switch (filter->preset) {
+        case EMBOSS:
+            return "emboss";
+        case SNOWFLAKES:
+            return "snowflakes";
+        case HEARTS:
+            return "hearts";
+        case STARS:
+            return "stars";
+        case OVERLAY:
+            return "overlay";
+        case BLUR:
+            return "blur-median";
+        case BLURLIGHT:
+            return "blur-light";
+        case BLURMEDIUM:
+            return "blur-medium";
+        case BLURBOX:
+            return "blur-box";
+        case BLURGAUSSIAN:
+            return "blur-gaussian";
+        case WHITEFRAME:
+            return "whiteframe";
+        case BLACKFRAME:
+            return "blackframe";
+        case RESIZE:
+            return "resize";
+        default:
+            return "unknown";
+    }
+}
+
 void set_filter_color(filter_descriptor_t *filter, const char *colorString) {
     if (!filter) {
         return;
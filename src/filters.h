@@ -2,12 +2,23 @@
 #define FILTERS_H
 
 #include "core.h"
+#include "kernels.h"
+#include "assetcache.h"
+#include "threadpool.h"
+#include "resample.h"
+
+#define MEDIAN_MAX_RADIUS 255    // Größter zulässiger Radius für blur-median
+#define BOX_MAX_RADIUS 2047      // Größter zulässiger Radius für blur-box
+#define GAUSSIAN_MAX_SIGMA 1000  // Größtes zulässiges Sigma für blur-gaussian
+#define FILTER_CHAIN_MAX 16      // Höchstzahl der Stufen in einer Filterkette (filter=a,b,c)
 
 enum filter_preset_t {
     UNKNOWN,
     BLUR,
     BLURLIGHT,
     BLURMEDIUM,
+    BLURBOX,
+    BLURGAUSSIAN,
     EMBOSS,
     OVERLAY,
     SNOWFLAKES,
@@ -15,6 +26,7 @@ enum filter_preset_t {
     STARS,
     WHITEFRAME, 
     BLACKFRAME,
+    RESIZE,
 };
 
 typedef struct { 
@@ -22,25 +34,55 @@ typedef struct {
     char path[MAX_FILE_PATH_LEN];
     bool useColor;
     color_t color; 
+    uint32_t radius;    // Radius für blur-median & blur-box, 0 oder 1 entspricht dem 3x3-Fenster
+    double sigma;       // Standardabweichung für blur-gaussian, 0 entspricht 1.0
+    uint32_t width;     // Zielbreite für resize, 0 ergibt sich aus dem Seitenverhältnis
+    uint32_t height;    // Zielhöhe für resize, 0 ergibt sich aus dem Seitenverhältnis
+    resample_method_t method;    // Interpolationsverfahren für resize
 } filter_descriptor_t;
 
+/**
+ * @brief Folge von Filtern, die nacheinander auf dasselbe Bild angewendet werden
+ */
+typedef struct {
+    uint32_t count;
+    filter_descriptor_t stages[FILTER_CHAIN_MAX];
+} filter_chain_t;
+
+/**
+ * @brief Ausführungsumgebung der Filter
+ * 
+ * Wird von `main()` einmal angelegt & an alle Filter weitergereicht. Nachbarschaftsfilter 
+ * schreiben in den Scratch-Puffer & tauschen ihn danach mit den Bildpixeln, sodass 
+ * jeder Kernel ein unverändertes Eingabebild liest.
+ */
+typedef struct {
+    thread_pool_t *pool;       // Thread-Pool für die Zeilenbänder, NULL für serielle Ausführung
+    color_t *scratch;          // Wiederverwendeter Zielpuffer der Nachbarschaftsfilter
+    size_t scratchCapacity;    // Größe des Scratch-Puffers in Pixeln
+    bool legacyInPlace;        // Alte In-Place-Ausführung (seriell, abhängig von der Scanreihenfolge)
+    simd_level_t simd;         // Befehlssatz der Zeilenkernel, SIMD_AUTO wählt per cpuid
+    asset_cache_t *assets;     // Cache der skalierten Overlay-Bilder, NULL lädt sie bei jedem Aufruf neu
+} filter_context_t;
+
 /**
  * @brief Wendet einen Emboss-Filter auf ein Bild an
  * 
  * vergleicht benachbarte Pixel & berechnet einen neuen Wert für das aktuelle Pixel, um einen Emboss-Effekt zu erzeugen. 
  *
+ * @param context Ausführungsumgebung (Thread-Pool), darf NULL sein
  * @param filter Das Filter, das angewendet werden soll
  * @param target Wo der Filter angewendet wird. Es enthält die Pixel, die verändert werden
- * @return int Gibt 0 bei Erfolg zurück, oder -1, wenn eines der Eingabeargumente ungültig ist
+ * @return int Gibt 0 bei Erfolg zurück, -1, wenn eines der Eingabeargumente ungültig ist, oder -3 bei Speicherproblemen
  */
-int apply_emboss(const filter_descriptor_t *filter, picture_t *target);
+int apply_emboss(filter_context_t *context, const filter_descriptor_t *filter, picture_t *target);
 
 /**
  * @brief  Wendet einen Median-Blur auf das aktuelle Pixel unter Verwendung seiner benachbarten Pixel an.
  * 
  * Berechnet den Medianwert für jeden Farbkanal (RGB) der benachbarten Pixel 
  * & wendet den resultierenden Median auf das aktuelle Pixel an. 
- * Der Median wird nach dem Sortieren der Farbwerte der Nachbarpixel berechnet.
+ * Der Median wird nach dem Sortieren der Farbwerte der Nachbarpixel berechnet (Insertion Sort, höchstens 8 Werte).
  *
  * @param neighbor Ein Array von Zeigern auf benachbarte Pixel
  * @param currentPixel  Ein Zeiger auf das Pixel, auf das der Medianwert angewendet wird
@@ -52,12 +94,17 @@ void apply_median_blur(color_t *neighbor[8], color_t *currentPixel);
  * @brief Wendet einen Median-Blur-Filter auf ein Bild an
  * 
  * Iteriert über jedes Pixel & aktualisiert dessen Farbwerte (RGB) anhand des Medians der benachbarten Pixel.
- * Nutzt `get_pixel()` zum Abrufen der Nachbarn und `apply_median_blur()` zur Berechnung des Medianwerts.
+ * Für das 3x3-Fenster wird der Median im Bildinneren über ein Sortiernetz für 16 benachbarte Pixel 
+ * gleichzeitig berechnet, am Bildrand über `apply_median_blur()`. Für `filter->radius > 1` wird ein 
+ * gleitendes Histogramm verwendet, dessen Kosten pro Pixel nur linear mit dem Radius wachsen.
  *
+ * @param context Ausführungsumgebung (Thread-Pool), darf NULL sein
+ * @param filter Die Filterbeschreibung (Radius)
  * @param target Ein Zeiger auf das Bild, das gefiltert werden soll. 
- * @return int Gibt 0 zurück, wenn der Filter erfolgreich angewendet wurde. Gibt -1 zurück, wenn das Bild ungültig ist
+ * @return int Gibt 0 zurück, wenn der Filter erfolgreich angewendet wurde. Gibt -1 zurück, wenn das Bild 
+ *             ungültig oder der Radius größer als MEDIAN_MAX_RADIUS ist, -3 bei Speicherproblemen
  */
-int median_blur_filter(picture_t *target);
+int median_blur_filter(filter_context_t *context, const filter_descriptor_t *filter, picture_t *target);
 
 /**
  * @brief Wendet Overlay-Filter auf ein Bild an
@@ -67,18 +114,37 @@ int median_blur_filter(picture_t *target);
  * angewendet, indem die Farbwerte gemittelt oder bestimmte Farben ausgelassen werden. 
  *
  * Nutzt `load_picture_from_path()` zum Laden des Filters.  
- * Nutzt `scale_image()` zum Skalieren des Filters auf die Zielgröße.  
+ * Nutzt `resample_picture()` (nächster Nachbar) zum Skalieren des Filters auf die Zielgröße.  
  * Nutzt `get_pixel()` für den Zugriff auf einzelne Pixel. 
+ * Mit Asset-Cache im Kontext werden geladene & skalierte Filterbilder wiederverwendet, solange sich 
+ * die Datei & die Zielgröße nicht ändern.
  *
+ * @param context Ausführungsumgebung (Thread-Pool, Asset-Cache), darf NULL sein
  * @param filter Zeiger auf die Filterbeschreibung
  * @param target Zeiger auf das Zielbild, auf das der Filter angewendet werden soll
  * @return int Gibt 0 bei Erfolg zurück.  
  *             Rückgabewerte bei Fehlern:
  *             - -1: Ungültige Eingaben  
  *             - -2: Unbekannter Filtertyp
- *             - >0: Fehlercode von `load_picture_from_path()` oder `scale_image()`
+ *             - >0: Fehlercode von `load_picture_from_path()` oder `resample_picture()`
+ */
+int apply_overlay(filter_context_t *context, filter_descriptor_t *filter, picture_t *target);
+
+/**
+ * @brief Gibt den Pfad des Filterbildes eines Overlay-Presets zurück
+ *
+ * @param filter Die Filterbeschreibung
+ * @return const char* Pfad zu `assets/` bzw. `filter->path` bei OVERLAY, NULL für andere Presets
  */
-int apply_overlay(filter_descriptor_t *filter, picture_t *target);
+const char *get_overlay_path(const filter_descriptor_t *filter);
+
+/**
+ * @brief Gibt den Wert zurück, dessen Stellen ein Rahmen auslässt (alle drei Kanäle gleich)
+ *
+ * @param filter Die Filterbeschreibung
+ * @return int 0xff für blackframe (weiße Stellen), 0x00 für whiteframe (schwarze Stellen), -1 für andere Presets
+ */
+int get_frame_skip(const filter_descriptor_t *filter);
 
 /**
  * @brief Wendet einen einfachen Blur-Filter auf ein Bild an
@@ -87,10 +153,11 @@ int apply_overlay(filter_descriptor_t *filter, picture_t *target);
  * (oberhalb, unterhalb, links und rechts) & setzt diesen Wert als neuen Farbwert für 
  * das Pixel im Zielbild. Der Effekt ist eine leichte Unschärfe.
  *
+ * @param context Ausführungsumgebung (Thread-Pool), darf NULL sein
  * @param target Zeiger auf das Zielbild, auf das der Unschärfefilter angewendet wird
- * @return int Gibt 0 bei Erfolg zurück, oder `-1` bei ungültigen Eingaben
+ * @return int Gibt 0 bei Erfolg zurück, `-1` bei ungültigen Eingaben oder `-3` bei Speicherproblemen
  */
-int blur_filter_light(picture_t *target);
+int blur_filter_light(filter_context_t *context, picture_t *target);
 
 /**
  * @brief Wendet Median-Blur auf ein Bild an
@@ -99,10 +166,51 @@ int blur_filter_light(picture_t *target);
  * (einschließlich der Pixel in einer größeren Umgebung, benachbarte Pixel in einem Umkreis von 2).
  * Der Effekt ist eine stärkere Unschärfe als bei Light-Blur
  * 
+ * @param context Ausführungsumgebung (Thread-Pool), darf NULL sein
+ * @param target Zeiger auf das Zielbild, auf das der Filter angewendet wird
+ * @return int Gibt 0 bei Erfolg zurück, `-1` bei ungültigen Eingaben oder `-3` bei Speicherproblemen
+ */
+int blur_filter_medium(filter_context_t *context, picture_t *target);
+
+/**
+ * @brief Wendet einen Box-Blur mit beliebigem Radius auf ein Bild an
+ *
+ * Separierbar: ein horizontaler & ein vertikaler Durchgang mit gleitender Summe, die Kosten pro Pixel 
+ * hängen daher nicht vom Radius ab. Der vertikale Durchgang läuft auf einem transponierten Zwischenbild 
+ * im Scratch-Puffer, sodass beide Durchgänge zeilenweise lesen. Am Bildrand wird das Randpixel wiederholt.
+ *
+ * @param context Ausführungsumgebung (Thread-Pool, Scratch-Puffer), darf NULL sein
+ * @param filter Die Filterbeschreibung, `filter->radius` (0 entspricht 1) bestimmt das (2r+1)x(2r+1)-Fenster
+ * @param target Zeiger auf das Zielbild, auf das der Filter angewendet wird
+ * @return int Gibt 0 bei Erfolg zurück, `-1` bei ungültigen Eingaben oder Radius > BOX_MAX_RADIUS, `-3` bei Speicherproblemen
+ */
+int blur_filter_box(filter_context_t *context, const filter_descriptor_t *filter, picture_t *target);
+
+/**
+ * @brief Wendet einen angenäherten Gauß-Blur mit beliebigem Sigma auf ein Bild an
+ *
+ * Der Gauß-Filter wird durch drei hintereinander ausgeführte Box-Blurs angenähert, deren Breiten 
+ * aus Sigma berechnet werden. Wie bei `blur_filter_box()` hängen die Kosten pro Pixel nicht von Sigma ab.
+ *
+ * @param context Ausführungsumgebung (Thread-Pool, Scratch-Puffer), darf NULL sein
+ * @param filter Die Filterbeschreibung, `filter->sigma` (0 entspricht 1.0)
  * @param target Zeiger auf das Zielbild, auf das der Filter angewendet wird
- * @return int Gibt 0 bei Erfolg zurück, oder `-1` bei ungültigen Eingaben
+ * @return int Gibt 0 bei Erfolg zurück, `-1` bei ungültigen Eingaben oder Sigma > GAUSSIAN_MAX_SIGMA, `-3` bei Speicherproblemen
  */
-int blur_filter_medium(picture_t *target);
+int blur_filter_gaussian(filter_context_t *context, const filter_descriptor_t *filter, picture_t *target);
+
+/**
+ * @brief Skaliert ein Bild auf `filter->width` x `filter->height`
+ *
+ * Ist nur eine der beiden Größen angegeben, ergibt sich die andere aus dem Seitenverhältnis (mindestens 1).
+ * Skaliert wird mit `resample_picture()` & dem Verfahren `filter->method`, auf dem Thread-Pool des Kontexts.
+ *
+ * @param context Ausführungsumgebung (Thread-Pool, Befehlssatz), darf NULL sein
+ * @param filter Die Filterbeschreibung (Zielgröße & Verfahren)
+ * @param target Zeiger auf das Bild, erhält danach die neue Größe & einen neuen Pixelpuffer
+ * @return int Gibt 0 bei Erfolg zurück, `-1` bei ungültigen Eingaben oder fehlender Zielgröße, `-3` bei Speicherproblemen
+ */
+int resize_filter(filter_context_t *context, const filter_descriptor_t *filter, picture_t *target);
 
 /**
  * @brief Setzt die Farbe des Filters basierend auf der übergebenen Farbeingabe
@@ -124,17 +232,126 @@ void set_filter_color(filter_descriptor_t *filter, const char *color_string);
  */
 void set_filter_from_name(filter_descriptor_t *filter, const char *name);
 
+/**
+ * @brief Gibt den Namen eines Filters zurück, wie er bei filter= angegeben wird
+ *
+ * @param filter Die Filterbeschreibung
+ * @return const char* Name des Presets (z.B. "blur-light"), "unknown" für UNKNOWN oder NULL
+ */
+const char *get_filter_name(const filter_descriptor_t *filter);
+
+/**
+ * @brief Baut eine Filterkette aus einer kommagetrennten Liste von Filternamen (z.B. "blur-light,emboss,whiteframe")
+ *
+ * Jede Stufe übernimmt die übrigen Optionen (Farbe, Radius, Sigma, Filterdatei) aus `options`.
+ * Unbekannte Namen werden als UNKNOWN-Stufe eingetragen.
+ *
+ * @param chain Die Kette, die befüllt wird
+ * @param options Vorlage für alle Stufen
+ * @param names Kommagetrennte Filternamen
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben, unbekannten Namen, leerer Liste oder mehr als FILTER_CHAIN_MAX Stufen
+ */
+int build_filter_chain(filter_chain_t *chain, const filter_descriptor_t *options, const char *names);
+
+/**
+ * @brief Wendet alle Stufen einer Filterkette nacheinander auf ein Bild an
+ *
+ * Aufeinanderfolgende Pixeloperationen werden zusammengelegt: eine Gruppe aus optional einem Emboss 
+ * gefolgt von Overlay-Presets (Rahmen, Hearts, Farbtönungen über color=) läuft in einem einzigen 
+ * Durchlauf über das Bild, jede Zeile durchläuft dabei alle Stufen der Gruppe. Das Ergebnis ist identisch 
+ * zur Ausführung der einzelnen Stufen. Alle anderen Filter sowie der Modus `legacyInPlace` laufen einzeln 
+ * über `apply_filter()`.
+ *
+ * @param context Ausführungsumgebung (Thread-Pool, Scratch-Puffer), darf NULL sein
+ * @param chain Die Filterkette
+ * @param target Zeiger auf das Zielbild
+ * @return int 0 bei Erfolg, sonst der Fehlercode der ersten fehlgeschlagenen Stufe (siehe `apply_filter()`)
+ */
+int apply_filter_chain(filter_context_t *context, filter_chain_t *chain, picture_t *target);
+
+/**
+ * @brief Wendet alle Stufen einer Filterkette auf ein planares Bild an (`layout=planar`)
+ *
+ * Jede Stufe läuft über einen Kernel, der direkt auf den Farbebenen arbeitet: pro Pixel & Durchlauf 
+ * werden 3 statt 4 Bytes bewegt. Das Ergebnis ist identisch zu `apply_filter_chain()` ohne `legacyInPlace`. 
+ * Aufeinanderfolgende Overlays laufen in einem Durchlauf, ihre Bilder bleiben `color_t`-Bilder aus dem Asset-Cache.
+ *
+ * @param context Ausführungsumgebung (Thread-Pool, Scratch-Puffer, Asset-Cache), darf NULL sein
+ * @param chain Die Filterkette
+ * @param target Das planare Bild (8 Bit pro Kanal), `target->buffer` kann danach auf einen anderen Puffer zeigen
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben, -2 bei leerer Kette oder unbekanntem Filter, 
+ *             -3 bei Speicherproblemen, sonst Fehlercode des Overlays
+ */
+int apply_filter_chain_planar(filter_context_t *context, filter_chain_t *chain, planar_t *target);
+
+/**
+ * @brief Wendet eine Kette aus Overlay-Stufen direkt auf gepackte RGB-Zeilen an (`mmap`-Modus)
+ *
+ * Alle Stufen laufen in einem Durchlauf über das Bild, das Ergebnis ist identisch zu `apply_filter_chain()`. 
+ * Schwarze & weiße Rahmen beschreiben die ausgelassenen Stellen nicht, bei einer abgebildeten Datei bleiben 
+ * diese Seiten also unverändert.
+ *
+ * @param context Ausführungsumgebung (Thread-Pool, Asset-Cache), darf NULL sein
+ * @param chain Die Filterkette
+ * @param target Die Pixel (8 Bit pro Kanal)
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben, -2 bei leerer Kette oder einer Stufe, die kein 
+ *             Overlay ist, sonst Fehlercode von `run_in_bands()` oder des Overlays
+ */
+int apply_filter_chain_packed(filter_context_t *context, filter_chain_t *chain, const packed_t *target);
+
+/**
+ * @brief Gibt an, wie viele Nachbarzeilen oberhalb & unterhalb ein Filter für eine Ausgabezeile liest
+ *
+ * Grundlage für den Streaming-Modus, der nur ein gleitendes Zeilenfenster im Speicher hält.
+ *
+ * @param filter Die Filterbeschreibung
+ * @return int Anzahl der Zeilen (0 für Overlays), -1 wenn der Filter nicht zeilenweise ausgeführt werden kann
+ */
+int filter_stream_halo(const filter_descriptor_t *filter);
+
+/**
+ * @brief Wendet einen Filter nur auf die Zeilen [rowStart, rowEnd) an
+ *
+ * `source` & `target` können Ausschnitte eines größeren Bildes sein: die Ergebnisse stimmen mit denen 
+ * auf dem ganzen Bild überein, solange `source` oberhalb & unterhalb der Zeilen mindestens 
+ * `filter_stream_halo()` Zeilen enthält oder dort der echte Bildrand liegt. Nachbarschaftsfilter lesen 
+ * aus `source` & schreiben in `target` (getrennte Puffer), Overlays arbeiten direkt in `target`.
+ *
+ * @param context Ausführungsumgebung (Thread-Pool), darf NULL sein
+ * @param filter Die Filterbeschreibung (nur Presets mit `filter_stream_halo() >= 0`)
+ * @param source Eingabezeilen
+ * @param target Ausgabezeilen, gleiche Abmessungen wie `source`
+ * @param rowStart Erste zu berechnende Zeile
+ * @param rowEnd Ende des Zeilenbereichs (exklusiv)
+ * @param overlay Skaliertes Overlay-Bild mit denselben Zeilenindizes wie `target` (nur für Overlays)
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben, -2 wenn der Filter nicht zeilenweise ausgeführt werden kann
+ */
+int apply_filter_rows(filter_context_t *context, const filter_descriptor_t *filter, const picture_t *source, 
+                      picture_t *target, uint32_t rowStart, uint32_t rowEnd, const picture_t *overlay);
+
+/**
+ * @brief Gibt den Thread-Pool, den Scratch-Puffer & den Asset-Cache eines Kontexts frei
+ *
+ * @param context Der Kontext, NULL wird ignoriert
+ */
+void filter_context_release(filter_context_t *context);
+
 /**
  * @brief  Wendet einen angegebenen Filter auf ein Bild an
  * 
  * entscheidet basierend auf dem Filtertyp (Preset) welcher spezifische Filter angewendet werden soll. 
+ * Die Filter werden in Zeilenbändern auf den Thread-Pool des Kontexts verteilt. Nachbarschaftsfilter 
+ * lesen dabei aus dem unveränderten Bild & schreiben in den Scratch-Puffer, sodass das Ergebnis nicht 
+ * von der Threadanzahl abhängt. `target->pixels` kann danach auf einen anderen Puffer zeigen.
  *
+ * @param context Ausführungsumgebung (Thread-Pool), darf NULL sein
  * @param filter Zeiger auf die Filterbeschreibung
  * @param target Zeiger auf das Zielbild, auf das der Filter angewendet wird
  * @return int  Gibt 0 bei Erfolg zurück, oder einen negativen Fehlercode:
  *              -1: Ungültige Eingabewerte
  *              -2: Unbekannter Filtertyp
+ *              -3: Speicherprobleme
  */
-int apply_filter(filter_descriptor_t *filter, picture_t *target);
+int apply_filter(filter_context_t *context, filter_descriptor_t *filter, picture_t *target);
 
 #endif      /* FILTERS_H */
\ No newline at end of file
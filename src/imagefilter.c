@@ -0,0 +1,164 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "imagefilter.h"
+#include "filters.h"
+#include "utils.h"
+#include "pixelbuffer.h"
+#include "core.h"
+
+struct imagefilter_context {
+    filter_context_t filters;    // Thread-Pool, Scratch-Puffer & Overlay-Cache
+};
+
+imagefilter_context_t *imagefilter_context_create(unsigned threads, simd_level_t simd, const char *cacheDirectory) {
+    imagefilter_context_t *context = calloc(1, sizeof(imagefilter_context_t));
+    if (!context) {
+        return NULL;
+    }
+    context->filters.simd = simd;
+
+    // Wie in `main()`: ohne Thread-Pool laufen die Filter seriell im aufrufenden Thread
+    if (threads != 1) {
+        context->filters.pool = thread_pool_create(threads);
+    }
+    context->filters.assets = asset_cache_create(cacheDirectory);
+    if (!context->filters.assets) {
+        imagefilter_context_destroy(context);
+        return NULL;
+    }
+    return context;
+}
+
+void imagefilter_context_destroy(imagefilter_context_t *context) {
+    if (!context) {
+        return;
+    }
+    filter_context_release(&context->filters);
+    free(context);
+    pixel_buffer_trim();
+}
+
+void imagefilter_set_log_handler(log_handler_t handler) {
+    set_log_handler(handler);
+}
+
+int imagefilter_decode(const void *data, size_t size, picture_t *picture) {
+    if (!data || size == 0 || !picture) {
+        return -1;
+    }
+    FILE *file = fmemopen((void *)data, size, "rb");
+    if (!file) {
+        return -3;
+    }
+    size_t capacity = 0;
+    picture->pixels = NULL;
+    int status = load_picture_from_file(file, picture, &capacity);
+    fclose(file);
+    return status;
+}
+
+int imagefilter_encode(const picture_t *picture, uint8_t **data, size_t *size) {
+    if (!picture || !picture->pixels || !data || !size) {
+        return -1;
+    }
+    char *buffer = NULL;
+    size_t length = 0;
+    FILE *file = open_memstream(&buffer, &length);
+    if (!file) {
+        return -3;
+    }
+    int status = write_picture_to_file(file, picture);
+    // Erst nach fclose stehen Puffer & Länge endgültig fest
+    if (fclose(file) != 0 && status == 0) {
+        status = -3;
+    }
+    if (status != 0) {
+        free(buffer);
+        return status;
+    }
+    *data = (uint8_t *)buffer;
+    *size = length;
+    return 0;
+}
+
+void imagefilter_picture_free(picture_t *picture) {
+    if (!picture) {
+        return;
+    }
+    pixel_buffer_free(picture->pixels);
+    picture->pixels = NULL;
+}
+
+/**
+ * @brief Baut die Filterkette & prüft die Optionen wie die Kommandozeile
+ *
+ * @return int 0 bei Erfolg, -1 bei unbekannten Filtern, resize ohne Größe oder overlay ohne Filterdatei
+ */
+static int prepare_chain(filter_chain_t *chain, const char *filters, const filter_descriptor_t *options) {
+    filter_descriptor_t defaults = { .method = RESAMPLE_AREA };
+    if (!options) {
+        options = &defaults;
+    }
+    if (build_filter_chain(chain, options, filters) != 0) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < chain->count; i++) {
+        const filter_descriptor_t *stage = &chain->stages[i];
+        if (stage->preset == RESIZE && stage->width == 0 && stage->height == 0) {
+            return -1;
+        }
+        if (stage->preset == OVERLAY && strlen(stage->path) < 1) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int imagefilter_apply(imagefilter_context_t *context, const char *filters, const filter_descriptor_t *options,
+                      picture_t *picture) {
+    if (!context || !filters || !picture || !picture->pixels) {
+        return -1;
+    }
+    filter_chain_t chain;
+    if (prepare_chain(&chain, filters, options) != 0) {
+        return -1;
+    }
+    return apply_filter_chain(&context->filters, &chain, picture);
+}
+
+int imagefilter_apply_pixels(imagefilter_context_t *context, const char *filters, const filter_descriptor_t *options,
+                             color_t *pixels, uint32_t width, uint32_t height) {
+    size_t numPixels;
+    if (!context || !filters || !pixels || pixel_count(width, height, &numPixels) != 0) {
+        return -1;
+    }
+    filter_chain_t chain;
+    if (prepare_chain(&chain, filters, options) != 0) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < chain.count; i++) {
+        if (chain.stages[i].preset == RESIZE) {
+            return -2;
+        }
+    }
+
+    picture_t picture = { .maxColorValue = 255, .format = "P6", .x = width, .y = height, .pixels = pixels };
+    filter_context_t *filterContext = &context->filters;
+    int status = apply_filter_chain(filterContext, &chain, &picture);
+
+    // Jeder Tausch mit dem Scratch-Puffer wechselt zwischen dem Puffer des Aufrufers & dem der Bibliothek.
+    // Endet die Kette im Puffer der Bibliothek, wird das Ergebnis zurückkopiert. Danach gehört der
+    // Scratch-Puffer wieder der Bibliothek, der Puffer des Aufrufers wird nie freigegeben.
+    if (picture.pixels != pixels) {
+        if (status == 0) {
+            memcpy(pixels, picture.pixels, numPixels * sizeof(color_t));
+        }
+        filterContext->scratch = picture.pixels;
+        filterContext->scratchCapacity = numPixels;
+    }
+    return status;
+}
@@ -0,0 +1,110 @@
+#ifndef IMAGEFILTER_H
+#define IMAGEFILTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core.h"
+#include "filters.h"
+
+/**
+ * @brief Wiederverwendbarer Kontext der Bibliothek (libimagefilter)
+ *
+ * Hält Thread-Pool, Scratch-Puffer & den Cache der skalierten Overlays über mehrere Aufrufe,
+ * sodass ein Programm, das viele Bilder im Speicher filtert, diese nur einmal anlegt. Ein Kontext
+ * darf nicht von mehreren Threads gleichzeitig benutzt werden, mehrere Kontexte schon.
+ */
+typedef struct imagefilter_context imagefilter_context_t;
+
+/**
+ * @brief Legt einen Kontext an
+ *
+ * @param threads Anzahl der Threads wie bei `threads=` (0 für alle Prozessorkerne, 1 für seriell)
+ * @param simd Befehlssatz der Zeilenkernel, SIMD_AUTO wählt per cpuid
+ * @param cacheDirectory Verzeichnis für den Festplatten-Cache der Overlays wie bei `cache-dir=`, darf NULL sein
+ * @return imagefilter_context_t* Der Kontext oder NULL bei Speicherproblemen
+ */
+imagefilter_context_t *imagefilter_context_create(unsigned threads, simd_level_t simd, const char *cacheDirectory);
+
+/**
+ * @brief Gibt einen Kontext mit Thread-Pool, Scratch-Puffer & Overlay-Cache frei
+ *
+ * Leert auch den Pool freigegebener Pixelpuffer (siehe `pixel_buffer_trim()`).
+ *
+ * @param context Der Kontext, NULL wird ignoriert
+ */
+void imagefilter_context_destroy(imagefilter_context_t *context);
+
+/**
+ * @brief Setzt den Empfänger der Diagnosemeldungen (z.B. Ursache eines Lesefehlers)
+ *
+ * Ohne Empfänger schreibt die Bibliothek nichts auf stdout oder stderr, Fehler kommen nur über die
+ * Rückgabewerte. Der Empfänger gilt für den ganzen Prozess & kann aus Worker-Threads aufgerufen werden.
+ *
+ * @param handler Der Empfänger, NULL (Standard) verwirft alle Meldungen
+ */
+void imagefilter_set_log_handler(log_handler_t handler);
+
+/**
+ * @brief Liest ein PPM-Bild (P3 oder P6, 8 oder 16 Bit) oder PAM-Bild (P7, 8 Bit) aus einem Speicherbereich
+ *
+ * @param data Inhalt einer PPM- oder PAM-Datei
+ * @param size Länge von `data` in Bytes
+ * @param picture Erhält das Bild, der Pixelpuffer wird mit `imagefilter_picture_free()` freigegeben
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben oder fehlerhaften Bilddaten, -3 bei Speicherproblemen
+ */
+int imagefilter_decode(const void *data, size_t size, picture_t *picture);
+
+/**
+ * @brief Schreibt ein Bild im PPM-Format (P3 oder P6) oder als PAM (P7) nach `picture->format` in einen neuen Speicherbereich
+ *
+ * @param picture Das Bild
+ * @param data Erhält den Speicherbereich, der Aufrufer gibt ihn mit `free()` frei
+ * @param size Erhält die Länge in Bytes
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben, -3 bei Speicherproblemen
+ */
+int imagefilter_encode(const picture_t *picture, uint8_t **data, size_t *size);
+
+/**
+ * @brief Gibt den Pixelpuffer eines Bildes von `imagefilter_decode()` oder `imagefilter_apply()` frei
+ *
+ * @param picture Das Bild, NULL wird ignoriert
+ */
+void imagefilter_picture_free(picture_t *picture);
+
+/**
+ * @brief Wendet eine Filterkette (z.B. "blur-light,emboss,whiteframe") auf ein Bild der Bibliothek an
+ *
+ * Verhält sich wie die Kommandozeile mit `filter=`. `picture->pixels` kann danach auf einen anderen
+ * Puffer zeigen (Nachbarschaftsfilter tauschen mit dem Scratch-Puffer, resize legt einen neuen an).
+ *
+ * @param context Der Kontext
+ * @param filters Kommagetrennte Filternamen
+ * @param options Vorlage für alle Stufen (Farbe, Radius, Sigma, Filterdatei, Zielgröße), NULL für Standardwerte
+ * @param picture Ein Bild von `imagefilter_decode()`
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben, unbekannten Filtern oder fehlenden Optionen
+ *             (resize ohne Größe, overlay ohne Filterdatei), sonst Fehlercode von `apply_filter_chain()`
+ */
+int imagefilter_apply(imagefilter_context_t *context, const char *filters, const filter_descriptor_t *options,
+                      picture_t *picture);
+
+/**
+ * @brief Wendet eine Filterkette direkt auf einen Pixelpuffer des Aufrufers an (8 Bit pro Kanal, RGBA)
+ *
+ * Es wird nichts kopiert, die Pixel werden im Puffer des Aufrufers gefiltert. Nachbarschaftsfilter
+ * schreiben in den Scratch-Puffer des Kontexts, liegt das Ergebnis am Ende dort, wird es einmal
+ * zurückkopiert. Der Puffer braucht keine besondere Ausrichtung. Der Alphakanal wird nicht ausgewertet.
+ *
+ * @param context Der Kontext
+ * @param filters Kommagetrennte Filternamen (ohne resize, das die Größe ändert)
+ * @param options Vorlage für alle Stufen, NULL für Standardwerte
+ * @param pixels `width` * `height` Pixel, zeilenweise ohne Abstand
+ * @param width Breite
+ * @param height Höhe
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben, unbekannten Filtern oder fehlenden Optionen,
+ *             -2 für resize, sonst Fehlercode von `apply_filter_chain()`
+ */
+int imagefilter_apply_pixels(imagefilter_context_t *context, const char *filters, const filter_descriptor_t *options,
+                             color_t *pixels, uint32_t width, uint32_t height);
+
+#endif      /* IMAGEFILTER_H */
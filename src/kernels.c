@@ -0,0 +1,851 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "kernels.h"
+#include "utils.h"
+#include "core.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+// Multiplikatoren für die Division per _mm_mulhi_epu16: (x * M) >> 16 == x / d im gesamten Wertebereich
+#define DIV5_MULTIPLIER 13108     // exakt für x <= 5 * 255
+#define DIV13_MULTIPLIER 5042     // exakt für x <= 13 * 255
+
+static void blur_light_row_scalar(const color_t *above, const color_t *current, const color_t *below, color_t *out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        uint32_t sumRed = current[i].red + above[i].red + below[i].red + current[i - 1].red + current[i + 1].red;
+        uint32_t sumGreen = current[i].green + above[i].green + below[i].green + current[i - 1].green + current[i + 1].green;
+        uint32_t sumBlue = current[i].blue + above[i].blue + below[i].blue + current[i - 1].blue + current[i + 1].blue;
+
+        out[i].red = (uint8_t)(sumRed / 5);
+        out[i].green = (uint8_t)(sumGreen / 5);
+        out[i].blue = (uint8_t)(sumBlue / 5);
+        out[i].alpha = current[i].alpha;
+    }
+}
+
+static void blur_medium_row_scalar(const color_t *const rows[5], color_t *out, size_t count) {
+    const color_t *r0 = rows[0];
+    const color_t *r1 = rows[1];
+    const color_t *r2 = rows[2];
+    const color_t *r3 = rows[3];
+    const color_t *r4 = rows[4];
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t sumRed = r0[i].red + r1[i - 1].red + r1[i].red + r1[i + 1].red
+                        + r2[i - 2].red + r2[i - 1].red + r2[i].red + r2[i + 1].red + r2[i + 2].red
+                        + r3[i - 1].red + r3[i].red + r3[i + 1].red + r4[i].red;
+        uint32_t sumGreen = r0[i].green + r1[i - 1].green + r1[i].green + r1[i + 1].green
+                          + r2[i - 2].green + r2[i - 1].green + r2[i].green + r2[i + 1].green + r2[i + 2].green
+                          + r3[i - 1].green + r3[i].green + r3[i + 1].green + r4[i].green;
+        uint32_t sumBlue = r0[i].blue + r1[i - 1].blue + r1[i].blue + r1[i + 1].blue
+                         + r2[i - 2].blue + r2[i - 1].blue + r2[i].blue + r2[i + 1].blue + r2[i + 2].blue
+                         + r3[i - 1].blue + r3[i].blue + r3[i + 1].blue + r4[i].blue;
+
+        out[i].red = (uint8_t)(sumRed / 13);
+        out[i].green = (uint8_t)(sumGreen / 13);
+        out[i].blue = (uint8_t)(sumBlue / 13);
+        out[i].alpha = r2[i].alpha;
+    }
+}
+
+static void emboss_span_scalar(const color_t *source, color_t *out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i].red = (uint8_t)(source[i + 1].red - source[i - 1].red + 128);
+        out[i].green = (uint8_t)(source[i + 1].green - source[i - 1].green + 128);
+        out[i].blue = (uint8_t)(source[i + 1].blue - source[i - 1].blue + 128);
+        out[i].alpha = source[i].alpha;
+    }
+}
+
+// Planare Varianten: eine Ebene mit einem Byte pro Pixel, ohne Alpha
+
+static void blur_light_plane_scalar(const uint8_t *above, const uint8_t *current, const uint8_t *below, uint8_t *out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = (uint8_t)(((uint32_t)current[i] + above[i] + below[i] + current[i - 1] + current[i + 1]) / 5);
+    }
+}
+
+static void blur_medium_plane_scalar(const uint8_t *const rows[5], uint8_t *out, size_t count) {
+    const uint8_t *r0 = rows[0];
+    const uint8_t *r1 = rows[1];
+    const uint8_t *r2 = rows[2];
+    const uint8_t *r3 = rows[3];
+    const uint8_t *r4 = rows[4];
+
+    for (size_t i = 0; i < count; i++) {
+        uint32_t sum = (uint32_t)r0[i] + r1[i - 1] + r1[i] + r1[i + 1]
+                     + r2[i - 2] + r2[i - 1] + r2[i] + r2[i + 1] + r2[i + 2]
+                     + r3[i - 1] + r3[i] + r3[i + 1] + r4[i];
+        out[i] = (uint8_t)(sum / 13);
+    }
+}
+
+static void emboss_plane_scalar(const uint8_t *source, uint8_t *out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = (uint8_t)(source[i + 1] - source[i - 1] + 128);
+    }
+}
+
+/**
+ * @brief Rundet eine Festkomma-Summe der Skalierung & begrenzt sie auf 0..255
+ */
+static inline uint8_t resample_round(int32_t sum) {
+    if (sum < 0) {
+        return 0;
+    }
+    sum = (sum + (1 << (RESAMPLE_BITS - 1))) >> RESAMPLE_BITS;
+    return sum > 255 ? 255 : (uint8_t)sum;
+}
+
+static void resample_row_scalar(const color_t *in, const uint32_t *start, const int16_t *weights, uint32_t taps, color_t *out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const color_t *pixel = in + start[i];
+        const int16_t *weight = weights + i * taps;
+        int32_t sumRed = 0;
+        int32_t sumGreen = 0;
+        int32_t sumBlue = 0;
+        int32_t sumAlpha = 0;
+        for (uint32_t k = 0; k < taps; k++) {
+            sumRed += weight[k] * pixel[k].red;
+            sumGreen += weight[k] * pixel[k].green;
+            sumBlue += weight[k] * pixel[k].blue;
+            sumAlpha += weight[k] * pixel[k].alpha;
+        }
+        out[i].red = resample_round(sumRed);
+        out[i].green = resample_round(sumGreen);
+        out[i].blue = resample_round(sumBlue);
+        out[i].alpha = resample_round(sumAlpha);
+    }
+}
+
+static void resample_columns_scalar(const color_t *first, size_t stride, const int16_t *weights, uint32_t taps, color_t *out, size_t count) {
+    for (size_t x = 0; x < count; x++) {
+        int32_t sumRed = 0;
+        int32_t sumGreen = 0;
+        int32_t sumBlue = 0;
+        int32_t sumAlpha = 0;
+        for (uint32_t k = 0; k < taps; k++) {
+            const color_t *pixel = first + k * stride + x;
+            sumRed += weights[k] * pixel->red;
+            sumGreen += weights[k] * pixel->green;
+            sumBlue += weights[k] * pixel->blue;
+            sumAlpha += weights[k] * pixel->alpha;
+        }
+        out[x].red = resample_round(sumRed);
+        out[x].green = resample_round(sumGreen);
+        out[x].blue = resample_round(sumBlue);
+        out[x].alpha = resample_round(sumAlpha);
+    }
+}
+
+// Overlays: die Farbmaske ist in jeder Variante eine Konstante, die Abfragen entfallen beim Übersetzen
+
+static inline void overlay_blend_scalar(color_t *row, const color_t *overlay, size_t count, unsigned mask) {
+    for (size_t i = 0; i < count; i++) {
+        if (mask & OVERLAY_MASK_RED) {
+            row[i].red = (uint8_t)((row[i].red + overlay[i].red) >> 1);
+        }
+        if (mask & OVERLAY_MASK_GREEN) {
+            row[i].green = (uint8_t)((row[i].green + overlay[i].green) >> 1);
+        }
+        if (mask & OVERLAY_MASK_BLUE) {
+            row[i].blue = (uint8_t)((row[i].blue + overlay[i].blue) >> 1);
+        }
+    }
+}
+
+static inline void overlay_frame_scalar(color_t *row, const color_t *overlay, size_t count, uint8_t skip) {
+    for (size_t i = 0; i < count; i++) {
+        if (overlay[i].red == skip && overlay[i].green == skip && overlay[i].blue == skip) {
+            continue;
+        }
+        // Nur die Farbkanäle, der Alphakanal des Bildes bleibt erhalten
+        row[i].red = overlay[i].red;
+        row[i].green = overlay[i].green;
+        row[i].blue = overlay[i].blue;
+    }
+}
+
+static inline void overlay_composite_scalar(color_t *row, const color_t *overlay, size_t count, unsigned mask) {
+    for (size_t i = 0; i < count; i++) {
+        uint8_t alpha = overlay[i].alpha;
+        if (alpha == 0) {
+            continue;
+        }
+        if (mask & OVERLAY_MASK_RED) {
+            row[i].red = composite_channel(row[i].red, overlay[i].red, alpha);
+        }
+        if (mask & OVERLAY_MASK_GREEN) {
+            row[i].green = composite_channel(row[i].green, overlay[i].green, alpha);
+        }
+        if (mask & OVERLAY_MASK_BLUE) {
+            row[i].blue = composite_channel(row[i].blue, overlay[i].blue, alpha);
+        }
+    }
+}
+
+// Erzeugt die acht Varianten von `overlay_blend_<suffix>()` & `overlay_composite_<suffix>()` sowie die 
+// zwei von `overlay_frame_<suffix>()`
+#define OVERLAY_VARIANTS(suffix, attribute) \
+    attribute static void overlay_blend_##suffix##_0(color_t *row, const color_t *overlay, size_t count) { (void)row; (void)overlay; (void)count; } \
+    attribute static void overlay_blend_##suffix##_1(color_t *row, const color_t *overlay, size_t count) { overlay_blend_##suffix(row, overlay, count, 1); } \
+    attribute static void overlay_blend_##suffix##_2(color_t *row, const color_t *overlay, size_t count) { overlay_blend_##suffix(row, overlay, count, 2); } \
+    attribute static void overlay_blend_##suffix##_3(color_t *row, const color_t *overlay, size_t count) { overlay_blend_##suffix(row, overlay, count, 3); } \
+    attribute static void overlay_blend_##suffix##_4(color_t *row, const color_t *overlay, size_t count) { overlay_blend_##suffix(row, overlay, count, 4); } \
+    attribute static void overlay_blend_##suffix##_5(color_t *row, const color_t *overlay, size_t count) { overlay_blend_##suffix(row, overlay, count, 5); } \
+    attribute static void overlay_blend_##suffix##_6(color_t *row, const color_t *overlay, size_t count) { overlay_blend_##suffix(row, overlay, count, 6); } \
+    attribute static void overlay_blend_##suffix##_7(color_t *row, const color_t *overlay, size_t count) { overlay_blend_##suffix(row, overlay, count, 7); } \
+    attribute static void overlay_frame_##suffix##_white(color_t *row, const color_t *overlay, size_t count) { overlay_frame_##suffix(row, overlay, count, 0x00); } \
+    attribute static void overlay_frame_##suffix##_black(color_t *row, const color_t *overlay, size_t count) { overlay_frame_##suffix(row, overlay, count, 0xff); } \
+    attribute static void overlay_composite_##suffix##_0(color_t *row, const color_t *overlay, size_t count) { (void)row; (void)overlay; (void)count; } \
+    attribute static void overlay_composite_##suffix##_1(color_t *row, const color_t *overlay, size_t count) { overlay_composite_##suffix(row, overlay, count, 1); } \
+    attribute static void overlay_composite_##suffix##_2(color_t *row, const color_t *overlay, size_t count) { overlay_composite_##suffix(row, overlay, count, 2); } \
+    attribute static void overlay_composite_##suffix##_3(color_t *row, const color_t *overlay, size_t count) { overlay_composite_##suffix(row, overlay, count, 3); } \
+    attribute static void overlay_composite_##suffix##_4(color_t *row, const color_t *overlay, size_t count) { overlay_composite_##suffix(row, overlay, count, 4); } \
+    attribute static void overlay_composite_##suffix##_5(color_t *row, const color_t *overlay, size_t count) { overlay_composite_##suffix(row, overlay, count, 5); } \
+    attribute static void overlay_composite_##suffix##_6(color_t *row, const color_t *overlay, size_t count) { overlay_composite_##suffix(row, overlay, count, 6); } \
+    attribute static void overlay_composite_##suffix##_7(color_t *row, const color_t *overlay, size_t count) { overlay_composite_##suffix(row, overlay, count, 7); }
+
+#define OVERLAY_BLEND_TABLE(suffix) { \
+    overlay_blend_##suffix##_0, overlay_blend_##suffix##_1, overlay_blend_##suffix##_2, overlay_blend_##suffix##_3, \
+    overlay_blend_##suffix##_4, overlay_blend_##suffix##_5, overlay_blend_##suffix##_6, overlay_blend_##suffix##_7 }
+#define OVERLAY_FRAME_TABLE(suffix) { overlay_frame_##suffix##_white, overlay_frame_##suffix##_black }
+#define OVERLAY_COMPOSITE_TABLE(suffix) { \
+    overlay_composite_##suffix##_0, overlay_composite_##suffix##_1, overlay_composite_##suffix##_2, overlay_composite_##suffix##_3, \
+    overlay_composite_##suffix##_4, overlay_composite_##suffix##_5, overlay_composite_##suffix##_6, overlay_composite_##suffix##_7 }
+
+OVERLAY_VARIANTS(scalar, )
+
+#ifdef KERNELS_X86
+
+// color_t liegt als R, G, B, A im Speicher, Alpha ist also das höchste Byte jedes 32-Bit-Werts
+
+__attribute__((target("sse4.1")))
+static inline __m128i load4(const color_t *pixels) {
+    return _mm_loadu_si128((const __m128i *)(const void *)pixels);
+}
+
+__attribute__((target("sse4.1")))
+static void blur_light_row_sse41(const color_t *above, const color_t *current, const color_t *below, color_t *out, size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i divisor = _mm_set1_epi16(DIV5_MULTIPLIER);
+    const __m128i alphaMask = _mm_set1_epi32((int)0xff000000u);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i center = load4(current + i);
+        __m128i taps[4] = { load4(current + i - 1), load4(current + i + 1), load4(above + i), load4(below + i) };
+
+        __m128i sumLo = _mm_unpacklo_epi8(center, zero);
+        __m128i sumHi = _mm_unpackhi_epi8(center, zero);
+        for (int t = 0; t < 4; t++) {
+            sumLo = _mm_add_epi16(sumLo, _mm_unpacklo_epi8(taps[t], zero));
+            sumHi = _mm_add_epi16(sumHi, _mm_unpackhi_epi8(taps[t], zero));
+        }
+        __m128i result = _mm_packus_epi16(_mm_mulhi_epu16(sumLo, divisor), _mm_mulhi_epu16(sumHi, divisor));
+        result = _mm_blendv_epi8(result, center, alphaMask);
+        _mm_storeu_si128((__m128i *)(void *)(out + i), result);
+    }
+    blur_light_row_scalar(above + i, current + i, below + i, out + i, count - i);
+}
+
+__attribute__((target("sse4.1")))
+static void blur_medium_row_sse41(const color_t *const rows[5], color_t *out, size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i divisor = _mm_set1_epi16(DIV13_MULTIPLIER);
+    const __m128i alphaMask = _mm_set1_epi32((int)0xff000000u);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i center = load4(rows[2] + i);
+        __m128i taps[12] = {
+            load4(rows[0] + i),
+            load4(rows[1] + i - 1), load4(rows[1] + i), load4(rows[1] + i + 1),
+            load4(rows[2] + i - 2), load4(rows[2] + i - 1), load4(rows[2] + i + 1), load4(rows[2] + i + 2),
+            load4(rows[3] + i - 1), load4(rows[3] + i), load4(rows[3] + i + 1),
+            load4(rows[4] + i),
+        };
+
+        __m128i sumLo = _mm_unpacklo_epi8(center, zero);
+        __m128i sumHi = _mm_unpackhi_epi8(center, zero);
+        for (int t = 0; t < 12; t++) {
+            sumLo = _mm_add_epi16(sumLo, _mm_unpacklo_epi8(taps[t], zero));
+            sumHi = _mm_add_epi16(sumHi, _mm_unpackhi_epi8(taps[t], zero));
+        }
+        __m128i result = _mm_packus_epi16(_mm_mulhi_epu16(sumLo, divisor), _mm_mulhi_epu16(sumHi, divisor));
+        result = _mm_blendv_epi8(result, center, alphaMask);
+        _mm_storeu_si128((__m128i *)(void *)(out + i), result);
+    }
+    const color_t *const rest[5] = { rows[0] + i, rows[1] + i, rows[2] + i, rows[3] + i, rows[4] + i };
+    blur_medium_row_scalar(rest, out + i, count - i);
+}
+
+__attribute__((target("sse4.1")))
+static void emboss_span_sse41(const color_t *source, color_t *out, size_t count) {
+    const __m128i offset = _mm_set1_epi8((char)0x80);
+    const __m128i alphaMask = _mm_set1_epi32((int)0xff000000u);
+    size_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i result = _mm_add_epi8(_mm_sub_epi8(load4(source + i + 1), load4(source + i - 1)), offset);
+        result = _mm_blendv_epi8(result, load4(source + i), alphaMask);
+        _mm_storeu_si128((__m128i *)(void *)(out + i), result);
+    }
+    emboss_span_scalar(source + i, out + i, count - i);
+}
+
+__attribute__((target("sse4.1")))
+static inline __m128i load16(const uint8_t *values) {
+    return _mm_loadu_si128((const __m128i *)(const void *)values);
+}
+
+/**
+ * @brief Summiert `count` Vektoren aus je 16 Bytes in zwei Hälften zu 16 Bit & teilt per Kehrwert
+ */
+__attribute__((target("sse4.1")))
+static inline __m128i average16(const __m128i *taps, int count, __m128i divisor) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sumLo = zero;
+    __m128i sumHi = zero;
+    for (int t = 0; t < count; t++) {
+        sumLo = _mm_add_epi16(sumLo, _mm_unpacklo_epi8(taps[t], zero));
+        sumHi = _mm_add_epi16(sumHi, _mm_unpackhi_epi8(taps[t], zero));
+    }
+    return _mm_packus_epi16(_mm_mulhi_epu16(sumLo, divisor), _mm_mulhi_epu16(sumHi, divisor));
+}
+
+__attribute__((target("sse4.1")))
+static void blur_light_plane_sse41(const uint8_t *above, const uint8_t *current, const uint8_t *below, uint8_t *out, size_t count) {
+    const __m128i divisor = _mm_set1_epi16(DIV5_MULTIPLIER);
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i taps[5] = { load16(current + i), load16(current + i - 1), load16(current + i + 1), 
+                            load16(above + i), load16(below + i) };
+        _mm_storeu_si128((__m128i *)(void *)(out + i), average16(taps, 5, divisor));
+    }
+    blur_light_plane_scalar(above + i, current + i, below + i, out + i, count - i);
+}
+
+__attribute__((target("sse4.1")))
+static void blur_medium_plane_sse41(const uint8_t *const rows[5], uint8_t *out, size_t count) {
+    const __m128i divisor = _mm_set1_epi16(DIV13_MULTIPLIER);
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i taps[13] = {
+            load16(rows[0] + i),
+            load16(rows[1] + i - 1), load16(rows[1] + i), load16(rows[1] + i + 1),
+            load16(rows[2] + i - 2), load16(rows[2] + i - 1), load16(rows[2] + i), load16(rows[2] + i + 1), load16(rows[2] + i + 2),
+            load16(rows[3] + i - 1), load16(rows[3] + i), load16(rows[3] + i + 1),
+            load16(rows[4] + i),
+        };
+        _mm_storeu_si128((__m128i *)(void *)(out + i), average16(taps, 13, divisor));
+    }
+    const uint8_t *const rest[5] = { rows[0] + i, rows[1] + i, rows[2] + i, rows[3] + i, rows[4] + i };
+    blur_medium_plane_scalar(rest, out + i, count - i);
+}
+
+__attribute__((target("sse4.1")))
+static void emboss_plane_sse41(const uint8_t *source, uint8_t *out, size_t count) {
+    const __m128i offset = _mm_set1_epi8((char)0x80);
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i result = _mm_add_epi8(_mm_sub_epi8(load16(source + i + 1), load16(source + i - 1)), offset);
+        _mm_storeu_si128((__m128i *)(void *)(out + i), result);
+    }
+    emboss_plane_scalar(source + i, out + i, count - i);
+}
+
+/**
+ * @brief Zwei Gewichte als Paar für _mm_madd_epi16 (niedriges Wort für die erste Zeile)
+ */
+static inline int32_t weight_pair(int16_t first, int16_t second) {
+    return (int32_t)(((uint32_t)(uint16_t)second << 16) | (uint16_t)first);
+}
+
+__attribute__((target("sse4.1")))
+static void resample_row_sse41(const color_t *in, const uint32_t *start, const int16_t *weights, uint32_t taps, color_t *out, size_t count) {
+    // Zwei Pixel als 16-Bit-Werte (r0 g0 b0 a0 r1 g1 b1 a1) zu Kanalpaaren (r0 r1 g0 g1 ...) umordnen
+    const __m128i pairs = _mm_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+    const __m128i rounding = _mm_set1_epi32(1 << (RESAMPLE_BITS - 1));
+
+    for (size_t i = 0; i < count; i++) {
+        const color_t *pixel = in + start[i];
+        const int16_t *weight = weights + i * taps;
+        __m128i sum = rounding;
+        uint32_t k = 0;
+        for (; k + 2 <= taps; k += 2) {
+            __m128i values = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(const void *)(pixel + k)));
+            values = _mm_shuffle_epi8(values, pairs);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(values, _mm_set1_epi32(weight_pair(weight[k], weight[k + 1]))));
+        }
+        if (k < taps) {
+            int32_t last;
+            memcpy(&last, pixel + k, sizeof(last));
+            __m128i values = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(last));
+            sum = _mm_add_epi32(sum, _mm_mullo_epi32(values, _mm_set1_epi32(weight[k])));
+        }
+        sum = _mm_srai_epi32(sum, RESAMPLE_BITS);
+        __m128i packed = _mm_packs_epi32(sum, sum);
+        packed = _mm_packus_epi16(packed, packed);
+        int32_t result = _mm_cvtsi128_si32(packed);
+        memcpy(out + i, &result, sizeof(result));
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void resample_columns_sse41(const color_t *first, size_t stride, const int16_t *weights, uint32_t taps, color_t *out, size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rounding = _mm_set1_epi32(1 << (RESAMPLE_BITS - 1));
+    size_t x = 0;
+
+    // 4 Pixel (16 Kanalwerte) pro Schritt, je zwei Zeilen werden verschränkt & mit _mm_madd_epi16 summiert
+    for (; x + 4 <= count; x += 4) {
+        __m128i sum[4] = { rounding, rounding, rounding, rounding };
+        for (uint32_t k = 0; k < taps; k += 2) {
+            __m128i a = load4(first + k * stride + x);
+            __m128i b = k + 1 < taps ? load4(first + (k + 1) * stride + x) : zero;
+            __m128i weight = _mm_set1_epi32(weight_pair(weights[k], k + 1 < taps ? weights[k + 1] : 0));
+            __m128i aLo = _mm_unpacklo_epi8(a, zero);
+            __m128i aHi = _mm_unpackhi_epi8(a, zero);
+            __m128i bLo = _mm_unpacklo_epi8(b, zero);
+            __m128i bHi = _mm_unpackhi_epi8(b, zero);
+            sum[0] = _mm_add_epi32(sum[0], _mm_madd_epi16(_mm_unpacklo_epi16(aLo, bLo), weight));
+            sum[1] = _mm_add_epi32(sum[1], _mm_madd_epi16(_mm_unpackhi_epi16(aLo, bLo), weight));
+            sum[2] = _mm_add_epi32(sum[2], _mm_madd_epi16(_mm_unpacklo_epi16(aHi, bHi), weight));
+            sum[3] = _mm_add_epi32(sum[3], _mm_madd_epi16(_mm_unpackhi_epi16(aHi, bHi), weight));
+        }
+        for (int j = 0; j < 4; j++) {
+            sum[j] = _mm_srai_epi32(sum[j], RESAMPLE_BITS);
+        }
+        __m128i result = _mm_packus_epi16(_mm_packs_epi32(sum[0], sum[1]), _mm_packs_epi32(sum[2], sum[3]));
+        _mm_storeu_si128((__m128i *)(void *)(out + x), result);
+    }
+    resample_columns_scalar(first + x, stride, weights, taps, out + x, count - x);
+}
+
+/**
+ * @brief Abgerundeter Mittelwert pro Byte: `_mm_avg_epu8` rundet auf, bei ungerader Summe wird 1 abgezogen
+ */
+__attribute__((target("sse4.1")))
+static inline __m128i average_floor4(__m128i a, __m128i b) {
+    __m128i odd = _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1));
+    return _mm_sub_epi8(_mm_avg_epu8(a, b), odd);
+}
+
+/**
+ * @brief Bytemaske der Kanäle einer Farbmaske (0xff für zu mischende Kanäle, Alpha nie)
+ */
+static inline uint32_t channel_bytes(unsigned mask) {
+    return ((mask & OVERLAY_MASK_RED) ? 0x000000ffu : 0) | ((mask & OVERLAY_MASK_GREEN) ? 0x0000ff00u : 0)
+           | ((mask & OVERLAY_MASK_BLUE) ? 0x00ff0000u : 0);
+}
+
+__attribute__((target("sse4.1")))
+static inline void overlay_blend_sse41(color_t *row, const color_t *overlay, size_t count, unsigned mask) {
+    const __m128i channels = _mm_set1_epi32((int)channel_bytes(mask));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i pixels = load4(row + i);
+        __m128i result = _mm_blendv_epi8(pixels, average_floor4(pixels, load4(overlay + i)), channels);
+        _mm_storeu_si128((__m128i *)(void *)(row + i), result);
+    }
+    overlay_blend_scalar(row + i, overlay + i, count - i, mask);
+}
+
+__attribute__((target("sse4.1")))
+static inline void overlay_frame_sse41(color_t *row, const color_t *overlay, size_t count, uint8_t skip) {
+    const __m128i rgb = _mm_set1_epi32(0x00ffffff);
+    const __m128i skipped = _mm_set1_epi32((int)(0x00010101u * skip));
+    const __m128i alphas = _mm_set1_epi32((int)0xff000000u);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i frame = load4(overlay + i);
+        __m128i keep = _mm_cmpeq_epi32(_mm_and_si128(frame, rgb), skipped);
+        if (_mm_movemask_epi8(keep) == 0xffff) {
+            continue;    // Nur ausgelassene Pixel: Zeile bleibt unberührt
+        }
+        // Alpha kommt immer aus der Zeile
+        __m128i result = _mm_blendv_epi8(frame, load4(row + i), _mm_or_si128(keep, alphas));
+        _mm_storeu_si128((__m128i *)(void *)(row + i), result);
+    }
+    overlay_frame_scalar(row + i, overlay + i, count - i, skip);
+}
+
+/**
+ * @brief Vier Pixel "Overlay über Zeile" mit vormultipliziertem Overlay, nur für Blöcke mit 0 < Alpha < 255
+ *
+ * Jeder Kanal: premultiplied + div255(row * (255 - alpha)) in 16 Bit, gerundet wie `div255()`.
+ */
+__attribute__((target("sse4.1")))
+static inline __m128i composite4(__m128i pixels, __m128i frame) {
+    // Alpha jedes Pixels auf alle vier Bytes verteilen & invertieren
+    const __m128i spread = _mm_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+    __m128i inverse = _mm_sub_epi8(_mm_set1_epi8((char)0xff), _mm_shuffle_epi8(frame, spread));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(128);
+    __m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), _mm_unpacklo_epi8(inverse, zero)), bias);
+    __m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), _mm_unpackhi_epi8(inverse, zero)), bias);
+    low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+    high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+    return _mm_add_epi8(frame, _mm_packus_epi16(low, high));
+}
+
+__attribute__((target("sse4.1")))
+static inline void overlay_composite_sse41(color_t *row, const color_t *overlay, size_t count, unsigned mask) {
+    const __m128i channels = _mm_set1_epi32((int)channel_bytes(mask));
+    const __m128i alphas = _mm_set1_epi32((int)0xff000000u);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i frame = load4(overlay + i);
+        __m128i alpha = _mm_and_si128(frame, alphas);
+        if (_mm_testz_si128(alpha, alpha)) {
+            continue;    // Ganz durchsichtig: Zeile bleibt unberührt
+        }
+        __m128i pixels = load4(row + i);
+        __m128i result = _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, alphas)) == 0xffff ? frame : composite4(pixels, frame);
+        _mm_storeu_si128((__m128i *)(void *)(row + i), _mm_blendv_epi8(pixels, result, channels));
+    }
+    overlay_composite_scalar(row + i, overlay + i, count - i, mask);
+}
+
+OVERLAY_VARIANTS(sse41, __attribute__((target("sse4.1"))))
+
+__attribute__((target("avx2")))
+static inline __m256i load8(const color_t *pixels) {
+    return _mm256_loadu_si256((const __m256i *)(const void *)pixels);
+}
+
+__attribute__((target("avx2")))
+static void blur_light_row_avx2(const color_t *above, const color_t *current, const color_t *below, color_t *out, size_t count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i divisor = _mm256_set1_epi16(DIV5_MULTIPLIER);
+    const __m256i alphaMask = _mm256_set1_epi32((int)0xff000000u);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i center = load8(current + i);
+        __m256i taps[4] = { load8(current + i - 1), load8(current + i + 1), load8(above + i), load8(below + i) };
+
+        // unpack/pack arbeiten jeweils innerhalb der 128-Bit-Hälften, die Reihenfolge bleibt daher erhalten
+        __m256i sumLo = _mm256_unpacklo_epi8(center, zero);
+        __m256i sumHi = _mm256_unpackhi_epi8(center, zero);
+        for (int t = 0; t < 4; t++) {
+            sumLo = _mm256_add_epi16(sumLo, _mm256_unpacklo_epi8(taps[t], zero));
+            sumHi = _mm256_add_epi16(sumHi, _mm256_unpackhi_epi8(taps[t], zero));
+        }
+        __m256i result = _mm256_packus_epi16(_mm256_mulhi_epu16(sumLo, divisor), _mm256_mulhi_epu16(sumHi, divisor));
+        result = _mm256_blendv_epi8(result, center, alphaMask);
+        _mm256_storeu_si256((__m256i *)(void *)(out + i), result);
+    }
+    blur_light_row_sse41(above + i, current + i, below + i, out + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void blur_medium_row_avx2(const color_t *const rows[5], color_t *out, size_t count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i divisor = _mm256_set1_epi16(DIV13_MULTIPLIER);
+    const __m256i alphaMask = _mm256_set1_epi32((int)0xff000000u);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i center = load8(rows[2] + i);
+        __m256i taps[12] = {
+            load8(rows[0] + i),
+            load8(rows[1] + i - 1), load8(rows[1] + i), load8(rows[1] + i + 1),
+            load8(rows[2] + i - 2), load8(rows[2] + i - 1), load8(rows[2] + i + 1), load8(rows[2] + i + 2),
+            load8(rows[3] + i - 1), load8(rows[3] + i), load8(rows[3] + i + 1),
+            load8(rows[4] + i),
+        };
+
+        __m256i sumLo = _mm256_unpacklo_epi8(center, zero);
+        __m256i sumHi = _mm256_unpackhi_epi8(center, zero);
+        for (int t = 0; t < 12; t++) {
+            sumLo = _mm256_add_epi16(sumLo, _mm256_unpacklo_epi8(taps[t], zero));
+            sumHi = _mm256_add_epi16(sumHi, _mm256_unpackhi_epi8(taps[t], zero));
+        }
+        __m256i result = _mm256_packus_epi16(_mm256_mulhi_epu16(sumLo, divisor), _mm256_mulhi_epu16(sumHi, divisor));
+        result = _mm256_blendv_epi8(result, center, alphaMask);
+        _mm256_storeu_si256((__m256i *)(void *)(out + i), result);
+    }
+    const color_t *const rest[5] = { rows[0] + i, rows[1] + i, rows[2] + i, rows[3] + i, rows[4] + i };
+    blur_medium_row_sse41(rest, out + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void emboss_span_avx2(const color_t *source, color_t *out, size_t count) {
+    const __m256i offset = _mm256_set1_epi8((char)0x80);
+    const __m256i alphaMask = _mm256_set1_epi32((int)0xff000000u);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i result = _mm256_add_epi8(_mm256_sub_epi8(load8(source + i + 1), load8(source + i - 1)), offset);
+        result = _mm256_blendv_epi8(result, load8(source + i), alphaMask);
+        _mm256_storeu_si256((__m256i *)(void *)(out + i), result);
+    }
+    emboss_span_sse41(source + i, out + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i load32(const uint8_t *values) {
+    return _mm256_loadu_si256((const __m256i *)(const void *)values);
+}
+
+/**
+ * @brief `average16()` für 32 Bytes (unpack/pack innerhalb der 128-Bit-Hälften erhalten die Reihenfolge)
+ */
+__attribute__((target("avx2")))
+static inline __m256i average32(const __m256i *taps, int count, __m256i divisor) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sumLo = zero;
+    __m256i sumHi = zero;
+    for (int t = 0; t < count; t++) {
+        sumLo = _mm256_add_epi16(sumLo, _mm256_unpacklo_epi8(taps[t], zero));
+        sumHi = _mm256_add_epi16(sumHi, _mm256_unpackhi_epi8(taps[t], zero));
+    }
+    return _mm256_packus_epi16(_mm256_mulhi_epu16(sumLo, divisor), _mm256_mulhi_epu16(sumHi, divisor));
+}
+
+__attribute__((target("avx2")))
+static void blur_light_plane_avx2(const uint8_t *above, const uint8_t *current, const uint8_t *below, uint8_t *out, size_t count) {
+    const __m256i divisor = _mm256_set1_epi16(DIV5_MULTIPLIER);
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i taps[5] = { load32(current + i), load32(current + i - 1), load32(current + i + 1), 
+                            load32(above + i), load32(below + i) };
+        _mm256_storeu_si256((__m256i *)(void *)(out + i), average32(taps, 5, divisor));
+    }
+    blur_light_plane_sse41(above + i, current + i, below + i, out + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void blur_medium_plane_avx2(const uint8_t *const rows[5], uint8_t *out, size_t count) {
+    const __m256i divisor = _mm256_set1_epi16(DIV13_MULTIPLIER);
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i taps[13] = {
+            load32(rows[0] + i),
+            load32(rows[1] + i - 1), load32(rows[1] + i), load32(rows[1] + i + 1),
+            load32(rows[2] + i - 2), load32(rows[2] + i - 1), load32(rows[2] + i), load32(rows[2] + i + 1), load32(rows[2] + i + 2),
+            load32(rows[3] + i - 1), load32(rows[3] + i), load32(rows[3] + i + 1),
+            load32(rows[4] + i),
+        };
+        _mm256_storeu_si256((__m256i *)(void *)(out + i), average32(taps, 13, divisor));
+    }
+    const uint8_t *const rest[5] = { rows[0] + i, rows[1] + i, rows[2] + i, rows[3] + i, rows[4] + i };
+    blur_medium_plane_sse41(rest, out + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void emboss_plane_avx2(const uint8_t *source, uint8_t *out, size_t count) {
+    const __m256i offset = _mm256_set1_epi8((char)0x80);
+    size_t i = 0;
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i result = _mm256_add_epi8(_mm256_sub_epi8(load32(source + i + 1), load32(source + i - 1)), offset);
+        _mm256_storeu_si256((__m256i *)(void *)(out + i), result);
+    }
+    emboss_plane_sse41(source + i, out + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void resample_columns_avx2(const color_t *first, size_t stride, const int16_t *weights, uint32_t taps, color_t *out, size_t count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i rounding = _mm256_set1_epi32(1 << (RESAMPLE_BITS - 1));
+    size_t x = 0;
+
+    for (; x + 8 <= count; x += 8) {
+        __m256i sum[4] = { rounding, rounding, rounding, rounding };
+        for (uint32_t k = 0; k < taps; k += 2) {
+            __m256i a = load8(first + k * stride + x);
+            __m256i b = k + 1 < taps ? load8(first + (k + 1) * stride + x) : zero;
+            __m256i weight = _mm256_set1_epi32(weight_pair(weights[k], k + 1 < taps ? weights[k + 1] : 0));
+            __m256i aLo = _mm256_unpacklo_epi8(a, zero);
+            __m256i aHi = _mm256_unpackhi_epi8(a, zero);
+            __m256i bLo = _mm256_unpacklo_epi8(b, zero);
+            __m256i bHi = _mm256_unpackhi_epi8(b, zero);
+            sum[0] = _mm256_add_epi32(sum[0], _mm256_madd_epi16(_mm256_unpacklo_epi16(aLo, bLo), weight));
+            sum[1] = _mm256_add_epi32(sum[1], _mm256_madd_epi16(_mm256_unpackhi_epi16(aLo, bLo), weight));
+            sum[2] = _mm256_add_epi32(sum[2], _mm256_madd_epi16(_mm256_unpacklo_epi16(aHi, bHi), weight));
+            sum[3] = _mm256_add_epi32(sum[3], _mm256_madd_epi16(_mm256_unpackhi_epi16(aHi, bHi), weight));
+        }
+        for (int j = 0; j < 4; j++) {
+            sum[j] = _mm256_srai_epi32(sum[j], RESAMPLE_BITS);
+        }
+        // unpack & pack arbeiten innerhalb der 128-Bit-Hälften & heben sich dort gegenseitig auf
+        __m256i result = _mm256_packus_epi16(_mm256_packs_epi32(sum[0], sum[1]), _mm256_packs_epi32(sum[2], sum[3]));
+        _mm256_storeu_si256((__m256i *)(void *)(out + x), result);
+    }
+    resample_columns_sse41(first + x, stride, weights, taps, out + x, count - x);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i average_floor8(__m256i a, __m256i b) {
+    __m256i odd = _mm256_and_si256(_mm256_xor_si256(a, b), _mm256_set1_epi8(1));
+    return _mm256_sub_epi8(_mm256_avg_epu8(a, b), odd);
+}
+
+__attribute__((target("avx2")))
+static inline void overlay_blend_avx2(color_t *row, const color_t *overlay, size_t count, unsigned mask) {
+    const __m256i channels = _mm256_set1_epi32((int)channel_bytes(mask));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i pixels = load8(row + i);
+        __m256i result = _mm256_blendv_epi8(pixels, average_floor8(pixels, load8(overlay + i)), channels);
+        _mm256_storeu_si256((__m256i *)(void *)(row + i), result);
+    }
+    overlay_blend_sse41(row + i, overlay + i, count - i, mask);
+}
+
+__attribute__((target("avx2")))
+static inline void overlay_frame_avx2(color_t *row, const color_t *overlay, size_t count, uint8_t skip) {
+    const __m256i rgb = _mm256_set1_epi32(0x00ffffff);
+    const __m256i skipped = _mm256_set1_epi32((int)(0x00010101u * skip));
+    const __m256i alphas = _mm256_set1_epi32((int)0xff000000u);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i frame = load8(overlay + i);
+        __m256i keep = _mm256_cmpeq_epi32(_mm256_and_si256(frame, rgb), skipped);
+        if (_mm256_movemask_epi8(keep) == -1) {
+            continue;
+        }
+        __m256i result = _mm256_blendv_epi8(frame, load8(row + i), _mm256_or_si256(keep, alphas));
+        _mm256_storeu_si256((__m256i *)(void *)(row + i), result);
+    }
+    overlay_frame_sse41(row + i, overlay + i, count - i, skip);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i composite8(__m256i pixels, __m256i frame) {
+    const __m256i spread = _mm256_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15,
+                                            3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+    __m256i inverse = _mm256_sub_epi8(_mm256_set1_epi8((char)0xff), _mm256_shuffle_epi8(frame, spread));
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i bias = _mm256_set1_epi16(128);
+    __m256i low = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(pixels, zero), _mm256_unpacklo_epi8(inverse, zero)), bias);
+    __m256i high = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(pixels, zero), _mm256_unpackhi_epi8(inverse, zero)), bias);
+    low = _mm256_srli_epi16(_mm256_add_epi16(low, _mm256_srli_epi16(low, 8)), 8);
+    high = _mm256_srli_epi16(_mm256_add_epi16(high, _mm256_srli_epi16(high, 8)), 8);
+    return _mm256_add_epi8(frame, _mm256_packus_epi16(low, high));
+}
+
+__attribute__((target("avx2")))
+static inline void overlay_composite_avx2(color_t *row, const color_t *overlay, size_t count, unsigned mask) {
+    const __m256i channels = _mm256_set1_epi32((int)channel_bytes(mask));
+    const __m256i alphas = _mm256_set1_epi32((int)0xff000000u);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i frame = load8(overlay + i);
+        __m256i alpha = _mm256_and_si256(frame, alphas);
+        if (_mm256_testz_si256(alpha, alpha)) {
+            continue;
+        }
+        __m256i pixels = load8(row + i);
+        __m256i result = _mm256_movemask_epi8(_mm256_cmpeq_epi32(alpha, alphas)) == -1 ? frame : composite8(pixels, frame);
+        _mm256_storeu_si256((__m256i *)(void *)(row + i), _mm256_blendv_epi8(pixels, result, channels));
+    }
+    overlay_composite_sse41(row + i, overlay + i, count - i, mask);
+}
+
+OVERLAY_VARIANTS(avx2, __attribute__((target("avx2"))))
+
+#endif      /* KERNELS_X86 */
+
+static const row_kernels_t SCALAR_KERNELS = {
+    SIMD_SCALAR, blur_light_row_scalar, blur_medium_row_scalar, emboss_span_scalar,
+    blur_light_plane_scalar, blur_medium_plane_scalar, emboss_plane_scalar,
+    resample_row_scalar, resample_columns_scalar,
+    OVERLAY_BLEND_TABLE(scalar), OVERLAY_FRAME_TABLE(scalar), OVERLAY_COMPOSITE_TABLE(scalar)
+};
+
+#ifdef KERNELS_X86
+static const row_kernels_t SSE41_KERNELS = {
+    SIMD_SSE41, blur_light_row_sse41, blur_medium_row_sse41, emboss_span_sse41,
+    blur_light_plane_sse41, blur_medium_plane_sse41, emboss_plane_sse41,
+    resample_row_sse41, resample_columns_sse41,
+    OVERLAY_BLEND_TABLE(sse41), OVERLAY_FRAME_TABLE(sse41), OVERLAY_COMPOSITE_TABLE(sse41)
+};
+
+static const row_kernels_t AVX2_KERNELS = {
+    SIMD_AVX2, blur_light_row_avx2, blur_medium_row_avx2, emboss_span_avx2,
+    blur_light_plane_avx2, blur_medium_plane_avx2, emboss_plane_avx2,
+    resample_row_sse41, resample_columns_avx2,
+    OVERLAY_BLEND_TABLE(avx2), OVERLAY_FRAME_TABLE(avx2), OVERLAY_COMPOSITE_TABLE(avx2)
+};
+#endif
+
+/**
+ * @brief Ermittelt per cpuid den besten unterstützten Befehlssatz
+ */
+static simd_level_t detect_simd_level(void) {
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return SIMD_SSE41;
+    }
+#endif
+    return SIMD_SCALAR;
+}
+
+const row_kernels_t *get_row_kernels(simd_level_t requested) {
+    simd_level_t supported = detect_simd_level();
+    simd_level_t level = (requested == SIMD_AUTO || requested > supported) ? supported : requested;
+
+#ifdef KERNELS_X86
+    if (level == SIMD_AVX2) {
+        return &AVX2_KERNELS;
+    }
+    if (level == SIMD_SSE41) {
+        return &SSE41_KERNELS;
+    }
+#endif
+    return &SCALAR_KERNELS;
+}
+
+int simd_level_from_name(const char *name, simd_level_t *level) {
+    if (!name || !level) {
+        return -1;
+    }
+    if (strcmp(name, "auto") == 0) {
+        *level = SIMD_AUTO;
+    }
+    else if (strcmp(name, "scalar") == 0) {
+        *level = SIMD_SCALAR;
+    }
+    else if (strcmp(name, "sse4") == 0) {
+        *level = SIMD_SSE41;
+    }
+    else if (strcmp(name, "avx2") == 0) {
+        *level = SIMD_AVX2;
+    }
+    else {
+        return -1;
+    }
+    return 0;
+}
+
+const char *simd_level_name(simd_level_t level) {
+    switch (level) {
+        case SIMD_SCALAR:
+            return "scalar";
+        case SIMD_SSE41:
+            return "sse4";
+        case SIMD_AVX2:
+            return "avx2";
+        default:
+            return "auto";
+    }
+}
\ No newline at end of file
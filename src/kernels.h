@@ -0,0 +1,93 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include "core.h"
+
+#define RESAMPLE_BITS 14    // Nachkommabits der Skalierungsgewichte (Summe der Gewichte 1 << RESAMPLE_BITS)
+
+#define OVERLAY_MASK_RED 1      // Kanalbits des Index von `overlayBlendRow`
+#define OVERLAY_MASK_GREEN 2
+#define OVERLAY_MASK_BLUE 4
+#define OVERLAY_FRAME_WHITE 0   // whiteframe: schwarze Stellen des Overlays auslassen
+#define OVERLAY_FRAME_BLACK 1   // blackframe: weiße Stellen des Overlays auslassen
+
+// Overlay-Kernel: verrechnet `count` Pixel des Overlays in eine Zeile des Zielbildes
+typedef void (*overlay_row_t)(color_t *row, const color_t *overlay, size_t count);
+
+/**
+ * @brief Befehlssatz, mit dem die Zeilenkernel ausgeführt werden
+ */
+typedef enum {
+    SIMD_AUTO = 0,    // Bester vom Prozessor unterstützter Befehlssatz
+    SIMD_SCALAR,
+    SIMD_SSE41,
+    SIMD_AVX2,
+} simd_level_t;
+
+/**
+ * @brief Zeilenkernel für das Bildinnere der Nachbarschaftsfilter
+ * 
+ * Alle Varianten liefern bitgenau dasselbe Ergebnis. Die Zeiger zeigen jeweils auf das erste 
+ * zu berechnende Pixel, die Kernel lesen die Nachbarn links & rechts davon selbst. 
+ * Der Alphawert wird aus dem mittleren Pixel übernommen.
+ */
+typedef struct {
+    simd_level_t level;
+
+    // 5-Punkt-Kreuz (blur-light): Mittelwert aus Zentrum, links, rechts, oben & unten
+    void (*blurLightRow)(const color_t *above, const color_t *current, const color_t *below, color_t *out, size_t count);
+
+    // 13-Punkt-Raute (blur-medium): rows[0..4] sind die Zeilen y-2 bis y+2
+    void (*blurMediumRow)(const color_t *const rows[5], color_t *out, size_t count);
+
+    // Emboss auf dem linearen Pixelindex: next - prev + 128 pro Kanal
+    void (*embossSpan)(const color_t *source, color_t *out, size_t count);
+
+    // Dieselben Kernel für eine Ebene eines planaren Bildes (ein Byte pro Pixel, `planar_t`)
+    void (*blurLightPlaneRow)(const uint8_t *above, const uint8_t *current, const uint8_t *below, uint8_t *out, size_t count);
+    void (*blurMediumPlaneRow)(const uint8_t *const rows[5], uint8_t *out, size_t count);
+    void (*embossPlaneSpan)(const uint8_t *source, uint8_t *out, size_t count);
+
+    // Skalieren (resample.c): Summen mit RESAMPLE_BITS Festkomma-Gewichten, gerundet & auf 0..255 begrenzt.
+    // Horizontal: out[i] = Summe über k von weights[i * taps + k] * in[start[i] + k]
+    void (*resampleRow)(const color_t *in, const uint32_t *start, const int16_t *weights, uint32_t taps, color_t *out, size_t count);
+    // Vertikal: out[x] = Summe über k von weights[k] * first[k * stride + x]
+    void (*resampleColumns)(const color_t *first, size_t stride, const int16_t *weights, uint32_t taps, color_t *out, size_t count);
+
+    // Overlay-Presets (8 Bit), eine Variante pro Farbmaske: abgerundeter Mittelwert mit dem Overlay-Pixel
+    // für die Kanäle der Maske (OVERLAY_MASK_*), die übrigen Kanäle & Alpha bleiben unverändert
+    overlay_row_t overlayBlendRow[8];
+    // Rahmen: Overlay-Pixel übernehmen, außer wo es die ausgelassene Farbe hat (OVERLAY_FRAME_*).
+    // Blöcke ganz aus ausgelassenen Pixeln werden nicht beschrieben.
+    overlay_row_t overlayFrameRow[2];
+    // Overlays mit Alphakanal (vormultipliziert): Overlay über die Kanäle der Maske legen. Blöcke mit
+    // Alpha 0 werden übersprungen, mit Alpha 255 kopiert
+    overlay_row_t overlayCompositeRow[8];
+} row_kernels_t;
+
+/**
+ * @brief Gibt die Zeilenkernel für den gewünschten Befehlssatz zurück
+ * 
+ * Wird ein Befehlssatz angefordert, den der Prozessor nicht unterstützt (Prüfung per cpuid), 
+ * wird der nächstniedrigere unterstützte verwendet.
+ *
+ * @param requested Gewünschter Befehlssatz, SIMD_AUTO für den besten verfügbaren
+ * @return const row_kernels_t* Die Kernel, nie NULL
+ */
+const row_kernels_t *get_row_kernels(simd_level_t requested);
+
+/**
+ * @brief Ordnet einem Namen (auto, scalar, sse4, avx2) den Befehlssatz zu
+ *
+ * @param name Der Name aus der Kommandozeile
+ * @param level Zielwert
+ * @return int 0 bei Erfolg, -1 bei unbekanntem Namen
+ */
+int simd_level_from_name(const char *name, simd_level_t *level);
+
+/**
+ * @brief Gibt den Namen eines Befehlssatzes zurück
+ */
+const char *simd_level_name(simd_level_t level);
+
+#endif      /* KERNELS_H */
\ No newline at end of file
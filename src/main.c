@@ -3,33 +3,105 @@
 #include <stdio.h>
 
 #include "filters.h"
+#include "batch.h"
+#include "stream.h"
+#include "mapped.h"
 #include "utils.h"
+#include "pixelbuffer.h"
+#include "stats.h"
 #include "core.h"
 
+/**
+ * @brief Gibt die Diagnosemeldungen der Module aus, Fortschritt & Fehlerursachen wie die übrigen Meldungen auf stdout
+ */
+static void print_log(log_level_t level, const char *message) {
+    fputs(message, stdout);
+}
+
 /**
  * @brief Gibt die Hilfeoptionen für das Programm aus.
  * Zeigt eine Übersicht der verfügbaren Optionen und deren Beschreibung für das Programm an
  */
 void print_help() {
     printf("\nOptions:\n");
-    printf("  if=<filename>    Specify the input file (e.g., if=image.ppm)\n");
+    printf("  if=<filename>    Specify the input file (e.g., if=image.ppm), if=- reads a list of input files from stdin\n");
     printf("  of=<filename>    Specify the output file (e.g., of=newimage.ppm)\n");
+    printf("  indir=<dir>      Process every .ppm file in a directory (batch mode)\n");
+    printf("  outdir=<dir>     Output directory for batch mode (default: new-<name> in the current directory)\n");
     printf("  ff=<filename>    Specify the filter file (e.g., ff=image.ppm)\n");
+    printf("                   (a PAM file with RGB_ALPHA is composited using its alpha channel)\n");
     printf("  color=<filename> Specify the color of the filter (e.g., color=red)\n");
-    printf("  filter=<option>  Apply a filter to the image:\n");
+    printf("  radius=<n>       Window radius for blur-median and blur-box (default: 1, i.e. 3x3)\n");
+    printf("  sigma=<s>        Standard deviation for blur-gaussian (default: 1.0)\n");
+    printf("  w=<n>, h=<n>     Target size for resize, a missing side keeps the aspect ratio\n");
+    printf("  method=<method>  Interpolation for resize: nearest, bilinear, area, lanczos3 (default: area)\n");
+    printf("  cache-dir=<dir>  Directory for a persistent cache of scaled overlay images (optional)\n");
+    printf("  pixel-dir=<dir>  Keep large images in deleted files in this directory instead of RAM (optional)\n");
+    printf("  threads=<n>      Number of worker threads, 0 uses all CPU cores (default: 1)\n");
+    printf("  simd=<level>     Instruction set for the filter kernels: auto, scalar, sse4, avx2 (default: auto)\n");
+    printf("  layout=<layout>  Internal pixel layout for single images: rgba or planar (default: rgba)\n");
+    printf("                   planar keeps R, G and B in separate planes (8-bit images only)\n");
+    printf("  stream           Filter a P6 image band by band without loading it completely\n");
+    printf("                   (emboss, blur-light, blur-medium, blur-median and overlays)\n");
+    printf("  mmap             Apply overlays directly to the pixel bytes of a memory-mapped P6 output file\n");
+    printf("                   (8-bit, overlays and color tints only, of= may equal if= to filter in place)\n");
+    printf("  legacy-inplace   Run neighbourhood filters in place like older versions (single-threaded)\n");
+    printf("  stats            Print timings per stage (header, decode, overlays, filters, encode), bytes read and\n");
+    printf("                   written, peak memory and busy time per thread\n");
+    printf("  trace=<filename> Write the timings as a Chrome trace-event JSON file (chrome://tracing, Perfetto)\n");
+    printf("  filter=<option>  Apply a filter to the image, several filters are chained with commas\n");
+    printf("                   (e.g., filter=blur-light,emboss,whiteframe):\n");
     printf("                   - overlay: overlays filter file to the input image\n");
     printf("                   - emboss: applies emboss filter\n");
     printf("                   - blur-median: applies median blur filter\n");
     printf("                   - blur-light: applies blur light filter\n");
     printf("                   - blur-medium: applies blur medium filter\n");
+    printf("                   - blur-box: applies box blur with radius=<n>\n");
+    printf("                   - blur-gaussian: applies gaussian blur with sigma=<s>\n");
     printf("                   - blackframe: adds a black frame\n");
     printf("                   - whiteframe: adds a white frame\n");
     printf("                   - snowflakes: adds snowflakes\n");
     printf("                   - hearts: adds hearts\n");
     printf("                   - stars: adds stars\n");
+    printf("                   - resize: scales the image to w=<n> x h=<n> using method=<method>\n");
     printf("  help             Show this help message\n");
     printf("\nExample:\n");
-    printf("  ./imagefilter if=image.ppm of=newimage.ppm filter=emboss\n\n");
+    printf("  ./imagefilter if=image.ppm of=newimage.ppm filter=emboss\n");
+    printf("  ./imagefilter if=image.ppm of=newimage.ppm filter=blur-light,emboss,whiteframe\n");
+    printf("  ./imagefilter indir=photos outdir=framed filter=whiteframe threads=0\n");
+    printf("  ./imagefilter if=image.ppm of=thumb.ppm filter=resize w=256 method=area\n");
+    printf("  ./imagefilter if=large.ppm of=framed.ppm filter=whiteframe mmap\n\n");
+}
+
+/**
+ * @brief Lädt, filtert & speichert ein Bild in planarer Darstellung (`layout=planar`)
+ *
+ * @return int 0 bei Erfolg, -2 wenn das Bild 16 Bit pro Kanal hat (dann gepackt verarbeiten), sonst Fehlercode
+ */
+static int filter_planar_file(filter_context_t *context, filter_chain_t *chain, const char *inputPath, const char *outputPath) {
+    planar_t image = {0};
+    int status = load_planar_from_path(inputPath, &image);
+    if (status == -2) {
+        return status;
+    }
+    if (status != 0) {
+        printf("Error loading input file %d, exiting!\n", status);
+        return status;
+    }
+
+    printf("Picture size: x:%u, y:%u\n", image.x, image.y);
+    status = apply_filter_chain_planar(context, chain, &image);
+    if (status != 0) {
+        printf("Error applying filter: %d, exiting!\n", status);
+    }
+    else {
+        status = generate_file_from_planar(outputPath, &image);
+        if (status != 0) {
+            printf("Error generating output file: %d, exiting!\n", status);
+        }
+    }
+    pixel_buffer_free(image.buffer);
+    return status == -2 ? -1 : status;
 }
 
 /**
@@ -43,6 +115,7 @@ void print_help() {
  * @return int Rückgabewert des Programms: 0 bei Erfolg, nicht null bei Fehler
  */
 int main(int argc, char *argv[]) {
+    set_log_handler(print_log);
     if (argc == 1) {
         print_help();
         return -1;
@@ -50,8 +123,20 @@ int main(int argc, char *argv[]) {
 
     char outputPath[MAX_FILE_PATH_LEN] = {0};  
     char inputPath[MAX_FILE_PATH_LEN] = {0};
-    filter_descriptor_t filter = {0};
+    filter_descriptor_t filter = { .method = RESAMPLE_AREA };    // Optionen, die für jede Stufe der Kette gelten
+    filter_chain_t chain = {0};
+    const char *filterNames = "";
+    filter_context_t context = {0};
     picture_t target = {0};   
+    const char *cacheDirectory = NULL;
+    const char *tracePath = NULL;
+    bool printStats = false;
+    batch_options_t batch = {0};
+    bool batchMode = false;
+    bool streaming = false;
+    bool mapped = false;
+    bool planar = false;
+    unsigned threads = 1;
     int status = 0;
     
     for (int i = 1; i < argc; i++) {
@@ -64,18 +149,89 @@ int main(int argc, char *argv[]) {
         // Input Dateipfad setzen (z.b. if=input.ppm)
         else if (starts_with(arg, "if=") == 1) {
             memcpy(inputPath, arg+3, MAX_FILE_PATH_LEN);
+            if (strcmp(arg+3, "-") == 0) {    // Liste der Eingabedateien von stdin
+                batchMode = true;
+            }
+        }
+        // Batch-Modus: alle Bilder eines Verzeichnisses
+        else if (starts_with(arg, "indir=") == 1) {
+            batch.inputDirectory = arg+6;
+            batchMode = true;
+        }
+        else if (starts_with(arg, "outdir=") == 1) {
+            batch.outputDirectory = arg+7;
         }
         // Filter Dateipfad setzen
         else if (starts_with(arg, "ff=") == 1) {
             memcpy(filter.path, arg+3, MAX_FILE_PATH_LEN);
         }
         else if (starts_with(arg, "filter=") == 1) {
-            set_filter_from_name(&filter, arg+7);
+            filterNames = arg+7;
         }
         else if (starts_with(arg, "color=") == 1) {
             set_filter_color(&filter, arg+6);
             filter.useColor = true;
         }
+        else if (starts_with(arg, "radius=") == 1) {
+            filter.radius = (uint32_t)strtoul(arg+7, NULL, 10);
+        }
+        else if (starts_with(arg, "sigma=") == 1) {
+            filter.sigma = strtod(arg+6, NULL);
+        }
+        // Zielgröße & Verfahren für resize
+        else if (starts_with(arg, "w=") == 1) {
+            filter.width = (uint32_t)strtoul(arg+2, NULL, 10);
+        }
+        else if (starts_with(arg, "h=") == 1) {
+            filter.height = (uint32_t)strtoul(arg+2, NULL, 10);
+        }
+        else if (starts_with(arg, "method=") == 1) {
+            if (resample_method_from_name(arg+7, &filter.method) != 0) {
+                printf("Unknown resize method: %s\n", arg+7);
+            }
+        }
+        else if (starts_with(arg, "cache-dir=") == 1) {
+            cacheDirectory = arg+10;
+        }
+        else if (starts_with(arg, "pixel-dir=") == 1) {
+            if (pixel_buffer_set_directory(arg+10) != 0) {
+                printf("Pixel directory path too long: %s\n", arg+10);
+            }
+        }
+        else if (starts_with(arg, "threads=") == 1) {
+            threads = (unsigned)strtoul(arg+8, NULL, 10);
+        }
+        else if (starts_with(arg, "simd=") == 1) {
+            if (simd_level_from_name(arg+5, &context.simd) != 0) {
+                printf("Unknown SIMD level: %s\n", arg+5);
+            }
+        }
+        else if (starts_with(arg, "layout=") == 1) {
+            if (strcmp(arg+7, "planar") == 0 || strcmp(arg+7, "rgba") == 0) {
+                planar = strcmp(arg+7, "planar") == 0;
+            }
+            else {
+                printf("Unknown layout: %s\n", arg+7);
+            }
+        }
+        else if (strcmp(arg, "stream") == 0) {
+            streaming = true;
+        }
+        else if (strcmp(arg, "mmap") == 0) {
+            mapped = true;
+        }
+        else if (strcmp(arg, "legacy-inplace") == 0) {
+            context.legacyInPlace = true;
+        }
+        // Messungen: Zusammenfassung am Ende und/oder Trace-Datei
+        else if (strcmp(arg, "stats") == 0) {
+            printStats = true;
+            stats_enable(false);
+        }
+        else if (starts_with(arg, "trace=") == 1) {
+            tracePath = arg+6;
+            stats_enable(true);
+        }
         else if (starts_with(arg, "help") == 1) {
             print_help(); 
             return 0;
@@ -85,17 +241,58 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    if (strlen(inputPath) < 1) {
-        printf("No input file provided, exiting!\n");
+    // Filterkette aufbauen, die Optionen gelten für jede Stufe (z.B. filter=blur-light,emboss,whiteframe)
+    if (build_filter_chain(&chain, &filter, filterNames) != 0) {
+        printf("Unknown filter preset, exiting!\n");
         status = -1;
     }
 
-    status = load_picture_from_path(inputPath, &target);
-    if (status != 0) {
-        printf("Error loading input file %d, exiting!\n", status);
+    bool resizes = false;
+    for (uint32_t i = 0; i < chain.count; i++) {
+        if (chain.stages[i].preset == RESIZE && filter.width == 0 && filter.height == 0) {
+            printf("Resize requires a target size w=<n> and/or h=<n>, exiting!\n");
+            status = -1;
+        }
+        resizes = resizes || chain.stages[i].preset == RESIZE;
+        if (chain.stages[i].preset == OVERLAY && strlen(filter.path) < 1) {   // Wenn der Filter auf OVERLAY gesetzt ist, aber kein Pfad zur Filterdatei angegeben wurde 
+            printf("Frame overlay requires filter file ff=/path/to/filter.ppm, exiting!\n");
+            status = -1;
+        }
+    }
+
+    // Ein einzelnes Eingabebild & ein Verzeichnis schließen sich aus, unabhängig von der Reihenfolge
+    if (batch.inputDirectory && strlen(inputPath) > 0 && strcmp(inputPath, "-") != 0) {
+        printf("indir= cannot be combined with if=<filename>, exiting!\n");
+        status = -1;
+    }
+
+    // Bei mehr als einem Thread werden die Filter auf einen Thread-Pool verteilt
+    if (threads != 1) {
+        context.pool = thread_pool_create(threads);
+        if (!context.pool) {
+            printf("Failed to create thread pool, running single-threaded.\n");
+        }
+    }
+
+    // Geladene & skalierte Overlays werden im Kontext gecacht, optional auch auf der Festplatte
+    context.assets = asset_cache_create(cacheDirectory);
+
+    // Batch-Modus: Bilder aus indir= oder von stdin, die Filterkette wird auf jedes angewendet
+    if (batchMode) {
+        if (status == 0) {
+            status = run_batch(&context, &chain, &batch);
+        }
+        if (status != 0) {
+            printf("Batch finished with errors: %d\n", status);
+        }
         goto cleanup;
     }
 
+    if (strlen(inputPath) < 1) {
+        printf("No input file provided, exiting!\n");
+        status = -1;
+    }
+
     // Wenn output_file nicht angegeben wird, wird automatisch eine Datei erstellt
     if (strlen(outputPath) < 1) {
         const char *prefix = "new-";
@@ -115,19 +312,56 @@ int main(int argc, char *argv[]) {
         validate_output_path(outputPath);
     }  
 
-    if (filter.preset == UNKNOWN) {
-        printf("Unknown filter preset, exiting!\n");
-        status = -1;
+    // Streaming-Modus: das Bild wird bandweise gelesen, gefiltert & geschrieben, ohne es ganz zu laden
+    if (streaming) {
+        status = stream_filter_file(&context, &chain, inputPath, outputPath);
+        if (status != 0) {
+            printf("Error streaming file: %d, exiting!\n", status);
+            goto cleanup;
+        }
+        printf("File saved to %s\n", outputPath);
+        goto cleanup;
     }
 
-    if (filter.preset == OVERLAY && strlen(filter.path) < 1) {   // Wenn der Filter auf OVERLAY gesetzt ist, aber kein Pfad zur Filterdatei angegeben wurde 
-        printf("Frame overlay requires filter file ff=/path/to/filter.ppm, exiting!\n");
-        status = -1;
+    // Overlays direkt auf den Pixeldaten der abgebildeten Ausgabedatei, ohne Dekodieren & Kodieren
+    if (mapped) {
+        status = mapped_filter_file(&context, &chain, inputPath, outputPath);
+        if (status != MAPPED_NOT_APPLICABLE) {
+            if (status == 0) {
+                printf("File saved to %s\n", outputPath);
+            }
+            else {
+                printf("Error filtering mapped file: %d, exiting!\n", status);
+            }
+            goto cleanup;
+        }
+        printf("mmap needs an 8-bit P6 image and only overlays, using the normal path.\n");
+    }
+
+    // Planare Darstellung (nicht mit legacy-inplace, das von der Scanreihenfolge der gepackten Pixel abhängt)
+    if (planar && resizes) {
+        printf("resize runs in the rgba layout.\n");
+    }
+    if (planar && !context.legacyInPlace && !resizes) {
+        status = filter_planar_file(&context, &chain, inputPath, outputPath);
+        if (status != -2) {
+            if (status == 0) {
+                printf("File saved to %s\n", outputPath);
+            }
+            goto cleanup;
+        }
+        printf("layout=planar needs an 8-bit RGB image, using the rgba layout.\n");
+    }
+
+    status = load_picture_from_path(inputPath, &target);
+    if (status != 0) {
+        printf("Error loading input file %d, exiting!\n", status);
+        goto cleanup;
     }
 
     printf("Picture size: x:%u, y:%u\n", target.x, target.y);
 
-    status = apply_filter(&filter, &target);
+    status = apply_filter_chain(&context, &chain, &target);
     if (status != 0) {
         printf("Error applying filter: %d, exiting!\n", status);
         goto cleanup;
@@ -142,10 +376,19 @@ int main(int argc, char *argv[]) {
     printf("File saved to %s\n", outputPath);
 
     cleanup:
+    filter_context_release(&context);
     if (target.pixels) {
-        free(target.pixels);
+        pixel_buffer_free(target.pixels);
         target.pixels = NULL;
     }
+    if (printStats) {
+        stats_print_summary(stdout);
+    }
+    if (tracePath && stats_write_trace(tracePath) != 0) {
+        printf("Error writing trace file %s\n", tracePath);
+    }
+    stats_release();
+    pixel_buffer_trim();
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,174 @@
+#define _GNU_SOURCE    // copy_file_range()
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "mapped.h"
+#include "filters.h"
+#include "utils.h"
+#include "pixelbuffer.h"
+#include "stats.h"
+#include "core.h"
+
+/**
+ * @brief Kopiert `length` Bytes von `inputOffset` der Eingabe nach `outputOffset` der Ausgabe
+ *
+ * Bevorzugt `copy_file_range()`, dabei bleiben die Daten im Kernel. Wird es nicht unterstützt
+ * (ältere Kernel, verschiedene Dateisysteme), wird der Rest über einen Puffer kopiert.
+ *
+ * @return int 0 bei Erfolg, -1 wenn die Eingabe zu kurz ist, -3 bei Speicher- oder Schreibfehlern
+ */
+static int copy_range(int input, off_t inputOffset, int output, off_t outputOffset, size_t length) {
+    while (length > 0) {
+        ssize_t copied = copy_file_range(input, &inputOffset, output, &outputOffset, length, 0);
+        if (copied <= 0) {
+            break;
+        }
+        length -= (size_t)copied;
+    }
+    if (length == 0) {
+        return 0;
+    }
+
+    size_t chunkSize = IO_CHUNK_PIXELS * 3;
+    uint8_t *chunk = malloc(chunkSize);
+    if (!chunk) {
+        return -3;
+    }
+    int status = 0;
+    while (length > 0 && status == 0) {
+        ssize_t got = pread(input, chunk, length < chunkSize ? length : chunkSize, inputOffset);
+        if (got <= 0) {
+            status = -1;
+            break;
+        }
+        if (pwrite(output, chunk, (size_t)got, outputOffset) != got) {
+            status = -3;
+            break;
+        }
+        inputOffset += got;
+        outputOffset += got;
+        length -= (size_t)got;
+    }
+    free(chunk);
+    return status;
+}
+
+int mapped_filter_file(filter_context_t *context, filter_chain_t *chain, const char *inputPath, const char *outputPath) {
+    if (!chain || !inputPath || !outputPath || chain->count == 0) {
+        return -1;
+    }
+    // Nur reine Pixeloperationen, sie lesen keine Nachbarzeilen
+    for (uint32_t i = 0; i < chain->count; i++) {
+        if (filter_stream_halo(&chain->stages[i]) != 0) {
+            return MAPPED_NOT_APPLICABLE;
+        }
+    }
+
+    FILE *input = fopen(inputPath, "rb");
+    if (!input) {
+        log_message(LOG_ERROR, "ERROR opening file %s: %s\n", inputPath, strerror(errno));
+        return -1;
+    }
+    picture_t image = {0};
+    double start = stats_now();
+    if (read_picture_header(input, &image) != 0) {
+        fclose(input);
+        return -1;
+    }
+    if (image.format[1] != '6' || picture_is_16bit(&image)) {
+        fclose(input);
+        return MAPPED_NOT_APPLICABLE;
+    }
+
+    // Die Pixeldaten müssen vollständig in der Datei liegen
+    off_t dataOffset = ftello(input);
+    struct stat inputInfo;
+    size_t numPixels;
+    if (dataOffset < 0 || fstat(fileno(input), &inputInfo) != 0 || pixel_count(image.x, image.y, &numPixels) != 0) {
+        log_message(LOG_ERROR, "Invalid image size.\n");
+        fclose(input);
+        return -1;
+    }
+    size_t dataBytes = numPixels * 3;
+    if ((uint64_t)inputInfo.st_size - (uint64_t)dataOffset < dataBytes) {
+        log_message(LOG_ERROR, "Truncated pixel data: expected %zu bytes, found %lld.\n", dataBytes, (long long)(inputInfo.st_size - dataOffset));
+        fclose(input);
+        return -1;
+    }
+    stats_span("parse header", "io", start);
+
+    // Ist die Ausgabe dieselbe Datei, wird sie an Ort & Stelle bearbeitet
+    struct stat outputInfo;
+    bool inPlace = stat(outputPath, &outputInfo) == 0 && outputInfo.st_dev == inputInfo.st_dev
+                   && outputInfo.st_ino == inputInfo.st_ino;
+    FILE *output = NULL;
+    int descriptor = -1;
+    off_t pixelsOffset = dataOffset;
+    int status = 0;
+    start = stats_now();
+    if (inPlace) {
+        descriptor = open(inputPath, O_RDWR);
+        status = descriptor < 0 ? -3 : 0;
+    }
+    else {
+        output = fopen(outputPath, "wb+");
+        if (!output) {
+            fclose(input);
+            return -3;
+        }
+        descriptor = fileno(output);
+        status = write_picture_header(output, &image);
+        if (status == 0 && fflush(output) != 0) {
+            status = -3;
+        }
+        pixelsOffset = ftello(output);
+        if (status == 0 && pixelsOffset < 0) {
+            status = -3;
+        }
+        if (status == 0) {
+            status = copy_range(fileno(input), dataOffset, descriptor, pixelsOffset, dataBytes);
+        }
+        stats_count_io((uint64_t)dataOffset + dataBytes, (uint64_t)pixelsOffset + dataBytes);
+        stats_span("copy pixels", "io", start);
+    }
+
+    // Datei abbilden, die Overlays schreiben direkt in ihre Seiten
+    if (status == 0) {
+        size_t mappedBytes = (size_t)pixelsOffset + dataBytes;
+        uint8_t *mapping = mmap(NULL, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            status = -3;
+        }
+        else {
+            packed_t target = { .maxColorValue = image.maxColorValue, .x = image.x, .y = image.y,
+                                .bytes = mapping + pixelsOffset };
+            status = apply_filter_chain_packed(context, chain, &target);
+            munmap(mapping, mappedBytes);
+        }
+    }
+
+    if (inPlace) {
+        if (descriptor >= 0 && close(descriptor) != 0 && status == 0) {
+            status = -3;
+        }
+    }
+    else {
+        if (fclose(output) != 0 && status == 0) {
+            status = -3;
+        }
+        if (status != 0) {
+            remove(outputPath);    // Keine halb gefilterte Ausgabe zurücklassen
+        }
+    }
+    fclose(input);
+    return status;
+}
@@ -0,0 +1,29 @@
+#ifndef MAPPED_H
+#define MAPPED_H
+
+#include "core.h"
+#include "filters.h"
+
+#define MAPPED_NOT_APPLICABLE 1    // Rückgabe von `mapped_filter_file()`, wenn Bild oder Kette nicht abgebildet gefiltert werden können
+
+/**
+ * @brief Wendet eine Kette aus Overlays direkt auf die Pixeldaten einer in den Speicher abgebildeten P6-Datei an
+ *
+ * Die Pixeldaten werden nicht in `color_t` dekodiert & nicht neu kodiert. Ist die Ausgabe eine andere
+ * Datei, werden Header & Pixeldaten vom Kernel in sie kopiert (`copy_file_range()`, auf Dateisystemen
+ * mit Reflinks ohne Datenkopie), danach wird sie abgebildet & die Overlays schreiben direkt in ihre
+ * Seiten. Sind Ein- & Ausgabe dieselbe Datei, wird sie ohne Kopie an Ort & Stelle bearbeitet, der
+ * ursprüngliche Header bleibt dabei erhalten. Das Ergebnis ist identisch zur Ausführung auf dem geladenen Bild.
+ *
+ * @param context Ausführungsumgebung (Thread-Pool, Asset-Cache), darf NULL sein
+ * @param chain Die Filterkette, nur Overlay-Presets (auch mit color=)
+ * @param inputPath Pfad der Eingabedatei
+ * @param outputPath Pfad der Ausgabedatei, darf gleich `inputPath` sein
+ * @return int 0 bei Erfolg, MAPPED_NOT_APPLICABLE wenn die Eingabe kein P6-Bild mit 8 Bit pro Kanal ist oder
+ *             die Kette andere Filter als Overlays enthält (geprüft, bevor etwas geladen oder geschrieben wird),
+ *             -1 bei ungültigen Eingaben, nicht lesbarer oder unvollständiger Eingabe, -3 bei Schreib- oder
+ *             Abbildungsfehlern, sonst Fehlercode des Overlays (z.B. -2 für ein Overlay-Bild mit 16 Bit pro Kanal)
+ */
+int mapped_filter_file(filter_context_t *context, filter_chain_t *chain, const char *inputPath, const char *outputPath);
+
+#endif      /* MAPPED_H */
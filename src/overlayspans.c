@@ -0,0 +1,226 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "overlayspans.h"
+#include "resample.h"
+#include "utils.h"
+#include "core.h"
+
+/**
+ * @brief Alpha eines Overlay-Pixels, ohne Alphakanal aus dem Farbschlüssel (ausgelassene Farbe durchsichtig)
+ */
+static uint8_t key_alpha(const color_t *pixel, bool alpha, uint8_t skip) {
+    if (alpha) {
+        return pixel->alpha;
+    }
+    return (pixel->red == skip && pixel->green == skip && pixel->blue == skip) ? 0 : 0xff;
+}
+
+/**
+ * @brief Durchläuft alle Quellzeilen mit den skalierten Spalten, ohne Speicher zählt es nur Abschnitte & Pixel
+ */
+static void scan_spans(const picture_t *overlay, const uint32_t *columns, uint8_t skip, overlay_spans_t *spans,
+                       size_t *spanCount, size_t *pixelCount) {
+    bool alpha = picture_has_alpha(overlay);
+    size_t count = 0;
+    size_t pixels = 0;
+    for (uint32_t sourceY = 0; sourceY < overlay->y; sourceY++) {
+        const color_t *in = picture_row(overlay, sourceY);
+        if (spans->rowSpans) {
+            spans->rowSpans[sourceY] = count;
+        }
+        uint32_t x = 0;
+        while (x < spans->width) {
+            uint8_t value = key_alpha(&in[columns[x]], alpha, skip);
+            if (value == 0) {
+                x++;
+                continue;
+            }
+            // Abschnitt aus lauter deckenden oder lauter halbdurchsichtigen Pixeln
+            bool opaque = value == 0xff;
+            uint32_t start = x;
+            while (x < spans->width && (value = key_alpha(&in[columns[x]], alpha, skip)) != 0 && (value == 0xff) == opaque) {
+                if (spans->pixels) {
+                    spans->pixels[pixels + (x - start)] = in[columns[x]];
+                }
+                x++;
+            }
+            if (spans->spans) {
+                spans->spans[count] = (overlay_span_t){ .start = start, .length = x - start, .offset = pixels, .opaque = opaque };
+            }
+            count++;
+            pixels += x - start;
+        }
+    }
+    if (spans->rowSpans) {
+        spans->rowSpans[overlay->y] = count;
+    }
+    *spanCount = count;
+    *pixelCount = pixels;
+}
+
+int overlay_spans_build(const picture_t *overlay, uint32_t width, uint32_t height, uint8_t skip, overlay_spans_t *spans) {
+    if (!overlay || !overlay->pixels || !spans || width == 0 || height == 0) {
+        return -1;
+    }
+    if (picture_is_16bit(overlay)) {
+        return -2;
+    }
+    *spans = (overlay_spans_t){ .width = width, .height = height, .sourceHeight = overlay->y };
+
+    uint32_t *columns = malloc((size_t)width * sizeof(uint32_t));
+    if (!columns) {
+        return -3;
+    }
+    for (uint32_t x = 0; x < width; x++) {
+        columns[x] = resample_nearest_index(overlay->x, width, x);
+    }
+
+    // Erst zählen, dann mit passend großen Puffern ein zweites Mal durchlaufen & füllen
+    size_t spanCount;
+    size_t pixelCount;
+    scan_spans(overlay, columns, skip, spans, &spanCount, &pixelCount);
+    spans->rowSpans = malloc(((size_t)overlay->y + 1) * sizeof(size_t));
+    spans->spans = malloc((spanCount ? spanCount : 1) * sizeof(overlay_span_t));
+    spans->pixels = malloc((pixelCount ? pixelCount : 1) * sizeof(color_t));
+    if (!spans->rowSpans || !spans->spans || !spans->pixels) {
+        free(columns);
+        overlay_spans_free(spans);
+        return -3;
+    }
+    scan_spans(overlay, columns, skip, spans, &spanCount, &spans->pixelCount);
+    free(columns);
+    return 0;
+}
+
+void overlay_spans_free(overlay_spans_t *spans) {
+    if (!spans) {
+        return;
+    }
+    free(spans->rowSpans);
+    free(spans->spans);
+    free(spans->pixels);
+    spans->rowSpans = NULL;
+    spans->spans = NULL;
+    spans->pixels = NULL;
+}
+
+size_t overlay_spans_bytes(const overlay_spans_t *spans) {
+    return ((size_t)spans->sourceHeight + 1) * sizeof(size_t) + spans->rowSpans[spans->sourceHeight] * sizeof(overlay_span_t)
+           + spans->pixelCount * sizeof(color_t);
+}
+
+/**
+ * @brief Abschnitte der Bildzeile `y`: erster & Ende des Bereichs in `spans->spans`
+ */
+static void row_spans(const overlay_spans_t *spans, uint32_t y, size_t *first, size_t *end) {
+    uint32_t sourceY = resample_nearest_index(spans->sourceHeight, spans->height, y);
+    *first = spans->rowSpans[sourceY];
+    *end = spans->rowSpans[sourceY + 1];
+}
+
+void overlay_spans_apply(const overlay_spans_t *spans, picture_t *target, uint32_t firstRow, uint32_t rowStart, uint32_t rowEnd) {
+    uint16_t expand[256];
+    bool wide = picture_is_16bit(target);
+    bool alpha = picture_has_alpha(target);
+    if (wide) {
+        for (uint32_t v = 0; v < 256; v++) {
+            expand[v] = (uint16_t)((v * target->maxColorValue + 127) / 255);
+        }
+    }
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        size_t first;
+        size_t end;
+        row_spans(spans, firstRow + y, &first, &end);
+        for (size_t i = first; i < end; i++) {
+            const overlay_span_t *span = &spans->spans[i];
+            const color_t *in = spans->pixels + span->offset;
+            if (!wide && span->opaque && !alpha) {
+                memcpy(picture_row(target, y) + span->start, in, (size_t)span->length * sizeof(color_t));
+            }
+            else if (!wide && span->opaque) {
+                // Bilder mit Alphakanal behalten ihn, nur die Farbkanäle werden übernommen
+                color_t *out = picture_row(target, y) + span->start;
+                for (uint32_t x = 0; x < span->length; x++) {
+                    out[x].red = in[x].red;
+                    out[x].green = in[x].green;
+                    out[x].blue = in[x].blue;
+                }
+            }
+            else if (!wide) {
+                color_t *out = picture_row(target, y) + span->start;
+                for (uint32_t x = 0; x < span->length; x++) {
+                    out[x].red = composite_channel(out[x].red, in[x].red, in[x].alpha);
+                    out[x].green = composite_channel(out[x].green, in[x].green, in[x].alpha);
+                    out[x].blue = composite_channel(out[x].blue, in[x].blue, in[x].alpha);
+                }
+            }
+            else {
+                color16_t *out = picture_row16(target, y) + span->start;
+                for (uint32_t x = 0; x < span->length; x++) {
+                    out[x].red = composite_channel16(out[x].red, expand[in[x].red], in[x].alpha, target->maxColorValue);
+                    out[x].green = composite_channel16(out[x].green, expand[in[x].green], in[x].alpha, target->maxColorValue);
+                    out[x].blue = composite_channel16(out[x].blue, expand[in[x].blue], in[x].alpha, target->maxColorValue);
+                }
+            }
+        }
+    }
+}
+
+void overlay_spans_apply_planar(const overlay_spans_t *spans, const planar_t *target, uint32_t rowStart, uint32_t rowEnd) {
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        uint8_t *red = planar_row(target, 0, y);
+        uint8_t *green = planar_row(target, 1, y);
+        uint8_t *blue = planar_row(target, 2, y);
+        size_t first;
+        size_t end;
+        row_spans(spans, y, &first, &end);
+        for (size_t i = first; i < end; i++) {
+            const overlay_span_t *span = &spans->spans[i];
+            const color_t *in = spans->pixels + span->offset;
+            if (span->opaque) {
+                for (uint32_t x = 0; x < span->length; x++) {
+                    red[span->start + x] = in[x].red;
+                    green[span->start + x] = in[x].green;
+                    blue[span->start + x] = in[x].blue;
+                }
+                continue;
+            }
+            for (uint32_t x = 0; x < span->length; x++) {
+                red[span->start + x] = composite_channel(red[span->start + x], in[x].red, in[x].alpha);
+                green[span->start + x] = composite_channel(green[span->start + x], in[x].green, in[x].alpha);
+                blue[span->start + x] = composite_channel(blue[span->start + x], in[x].blue, in[x].alpha);
+            }
+        }
+    }
+}
+
+void overlay_spans_apply_packed(const overlay_spans_t *spans, const packed_t *target, uint32_t rowStart, uint32_t rowEnd) {
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        uint8_t *row = target->bytes + (size_t)y * target->x * 3;
+        size_t first;
+        size_t end;
+        row_spans(spans, y, &first, &end);
+        for (size_t i = first; i < end; i++) {
+            const overlay_span_t *span = &spans->spans[i];
+            const color_t *in = spans->pixels + span->offset;
+            uint8_t *out = row + (size_t)span->start * 3;
+            if (span->opaque) {
+                for (uint32_t x = 0; x < span->length; x++, out += 3) {
+                    out[0] = in[x].red;
+                    out[1] = in[x].green;
+                    out[2] = in[x].blue;
+                }
+                continue;
+            }
+            for (uint32_t x = 0; x < span->length; x++, out += 3) {
+                out[0] = composite_channel(out[0], in[x].red, in[x].alpha);
+                out[1] = composite_channel(out[1], in[x].green, in[x].alpha);
+                out[2] = composite_channel(out[2], in[x].blue, in[x].alpha);
+            }
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef OVERLAYSPANS_H
+#define OVERLAYSPANS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "core.h"
+
+/**
+ * @brief Zusammenhängender Abschnitt abgedeckter Pixel in einer Zeile
+ */
+typedef struct {
+    uint32_t start;     // Erste Spalte im Zielbild
+    uint32_t length;    // Anzahl Pixel
+    size_t offset;      // Index des ersten Pixels in `overlay_spans_t.pixels`
+    bool opaque;        // Alle Pixel deckend (kopieren), sonst halbdurchsichtig (über das Bild legen)
+} overlay_span_t;
+
+/**
+ * @brief Dünn besetzte Form eines Rahmens: pro Zeile die Abschnitte, die nicht durchsichtig sind
+ *
+ * Ohne Alphakanal ist die ausgelassene Farbe durchsichtig & alle übrigen Pixel deckend (der Farbschlüssel
+ * wird einmal in Alpha umgewandelt). Mit Alphakanal (PAM) sind Pixel mit Alpha 0 durchsichtig, Abschnitte
+ * werden zusätzlich an den Grenzen zwischen deckenden & halbdurchsichtigen Pixeln geteilt.
+ *
+ * Die Spalten sind bereits auf die Breite des Zielbildes skaliert (nächster Nachbar wie `resample_picture()`),
+ * die Zeilen bleiben die des unskalierten Overlays: alle Zielzeilen mit derselben Quellzeile teilen sich
+ * ihre Abschnitte. So wächst die Größe nur mit der Zielbreite & das Übernehmen des Rahmens berührt nur
+ * die abgedeckten Pixel.
+ */
+typedef struct {
+    uint32_t width;             // Größe des Zielbildes
+    uint32_t height;
+    uint32_t sourceHeight;      // Zeilen des unskalierten Overlays
+    size_t *rowSpans;           // sourceHeight + 1 Einträge: Quellzeile r hat spans[rowSpans[r], rowSpans[r + 1])
+    overlay_span_t *spans;
+    color_t *pixels;            // Pixel aller Abschnitte hintereinander, auf die Zielbreite skaliert, Alpha vormultipliziert
+    size_t pixelCount;
+} overlay_spans_t;
+
+/**
+ * @brief Zerlegt ein unskaliertes Overlay in die Abschnitte für ein Zielbild der Größe width x height
+ *
+ * @param overlay Das unskalierte Overlay-Bild (8 Bit pro Kanal, Alpha vormultipliziert wie bei `load_overlay_from_path()`)
+ * @param width Breite des Zielbildes
+ * @param height Höhe des Zielbildes
+ * @param skip Ausgelassener Wert (0x00 für whiteframe, 0xff für blackframe), gilt für alle drei Kanäle,
+ *             wird bei Overlays mit Alphakanal nicht verwendet
+ * @param spans Erhält die Abschnitte, freigeben mit `overlay_spans_free()`
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben, -2 bei 16-Bit-Overlays, -3 bei Speicherproblemen
+ */
+int overlay_spans_build(const picture_t *overlay, uint32_t width, uint32_t height, uint8_t skip, overlay_spans_t *spans);
+
+/**
+ * @brief Gibt die Speicherbereiche der Abschnitte frei
+ *
+ * @param spans Die Abschnitte, NULL wird ignoriert
+ */
+void overlay_spans_free(overlay_spans_t *spans);
+
+/**
+ * @brief Belegter Speicher der Abschnitte in Bytes (für das Budget des Asset-Caches)
+ */
+size_t overlay_spans_bytes(const overlay_spans_t *spans);
+
+/**
+ * @brief Übernimmt die abgedeckten Pixel in die Zeilen [rowStart, rowEnd) eines Bildes (8 oder 16 Bit)
+ *
+ * Entspricht whiteframe/blackframe auf dem skalierten Overlay, die übrigen Pixel werden nicht berührt.
+ * Deckende Abschnitte werden kopiert (8-Bit-Ziele ohne Alphakanal erhalten das ganze Pixel, 16-Bit-Ziele die auf
+ * maxColorValue gestreckten Farbkanäle), halbdurchsichtige über die Farbkanäle gelegt.
+ *
+ * @param spans Die Abschnitte, `spans->width` muss `target->x` sein
+ * @param target Das Zielbild
+ * @param firstRow Bildzeile der Zeile 0 von `target` (z.B. der Fensteranfang beim Streamen)
+ * @param rowStart Erste Zeile in `target`
+ * @param rowEnd Zeile nach der letzten Zeile in `target`
+ */
+void overlay_spans_apply(const overlay_spans_t *spans, picture_t *target, uint32_t firstRow, uint32_t rowStart, uint32_t rowEnd);
+
+/**
+ * @brief `overlay_spans_apply()` für planare Bilder
+ */
+void overlay_spans_apply_planar(const overlay_spans_t *spans, const planar_t *target, uint32_t rowStart, uint32_t rowEnd);
+
+/**
+ * @brief `overlay_spans_apply()` für gepackte RGB-Zeilen
+ */
+void overlay_spans_apply_packed(const overlay_spans_t *spans, const packed_t *target, uint32_t rowStart, uint32_t rowEnd);
+
+#endif      /* OVERLAYSPANS_H */
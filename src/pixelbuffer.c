@@ -0,0 +1,314 @@
+#define _DEFAULT_SOURCE    // MAP_ANONYMOUS & madvise()
+
+#include <sys/mman.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "pixelbuffer.h"
+#include "core.h"
+
+#ifdef __SANITIZE_ADDRESS__
+#include <sanitizer/asan_interface.h>
+// Puffer im Pool sind für AddressSanitizer gesperrt, Zugriffe nach pixel_buffer_free() fallen weiter auf
+#define POOL_POISON(pixels, bytes) ASAN_POISON_MEMORY_REGION(pixels, bytes)
+#define POOL_UNPOISON(pixels, bytes) ASAN_UNPOISON_MEMORY_REGION(pixels, bytes)
+#else
+#define POOL_POISON(pixels, bytes) ((void)0)
+#define POOL_UNPOISON(pixels, bytes) ((void)0)
+#endif
+
+enum buffer_kind_t {
+    BUFFER_HEAP,
+    BUFFER_ANONYMOUS,
+    BUFFER_FILE,
+};
+
+/**
+ * @brief Verwaltungsdaten direkt vor den Pixeln, belegen genau PIXEL_BUFFER_ALIGNMENT Bytes
+ */
+typedef union {
+    struct {
+        size_t bytes;          // Größe der Größenklasse einschließlich Kopf (bei mmap ganze Seiten)
+        enum buffer_kind_t kind;
+    } info;
+    uint8_t padding[PIXEL_BUFFER_ALIGNMENT];
+} buffer_header_t;
+
+static char backingDirectory[MAX_FILE_PATH_LEN];    // Leer: große Puffer als anonymer Speicher
+
+/**
+ * @brief Freigegebene Puffer, die für spätere Anforderungen aufgehoben werden
+ *
+ * Die Einträge sind nach dem Zeitpunkt der Rückgabe sortiert, bei vollem Pool wird der älteste
+ * Puffer an das System zurückgegeben.
+ */
+static struct {
+    pthread_mutex_t lock;
+    buffer_header_t *buffers[PIXEL_POOL_MAX_BUFFERS];
+    unsigned count;
+    size_t cachedBytes;                  // Bytes der Puffer im Pool
+    pixel_buffer_stats_t stats;
+} pool = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+int pixel_count(uint32_t width, uint32_t height, size_t *count) {
+    if (!count || width == 0 || height == 0) {
+        return -1;
+    }
+    size_t pixels = (size_t)width * height;
+    if (pixels / width != height || pixels > PIXEL_BUFFER_MAX_COUNT) {
+        return -1;
+    }
+    *count = pixels;
+    return 0;
+}
+
+/**
+ * @brief Legt eine gelöschte Datei der Größe `bytes` an & bildet sie in den Speicher ab
+ */
+static void *map_file(size_t bytes) {
+    char path[MAX_FILE_PATH_LEN + 32];
+    snprintf(path, sizeof(path), "%s/imagefilter-XXXXXX", backingDirectory);
+    int descriptor = mkstemp(path);
+    if (descriptor < 0) {
+        return NULL;
+    }
+    unlink(path);    // Die Datei bleibt bis munmap() erhalten
+
+    void *memory = MAP_FAILED;
+    if (ftruncate(descriptor, (off_t)bytes) == 0) {
+        memory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    }
+    close(descriptor);
+    return memory == MAP_FAILED ? NULL : memory;
+}
+
+/**
+ * @brief Rundet eine Puffergröße auf ihre Größenklasse auf
+ *
+ * Bis 64 KiB in Schritten von 4 KiB, darüber vier Klassen pro Zweierpotenz (höchstens 25 % Verschnitt),
+ * sodass Bilder ähnlicher Größe denselben Puffer wiederverwenden können.
+ */
+static size_t size_class(size_t bytes) {
+    size_t step = 4096;
+    if (bytes > ((size_t)64 << 10)) {
+        size_t power = (size_t)64 << 10;
+        while (power <= bytes / 2) {
+            power *= 2;
+        }
+        step = power / 4;
+    }
+    if (bytes > SIZE_MAX - step) {
+        return bytes;
+    }
+    return (bytes + step - 1) / step * step;
+}
+
+/**
+ * @brief Holt einen Puffer vom System (Heap, anonymes mmap oder Datei)
+ */
+static buffer_header_t *system_alloc(size_t bytes) {
+    buffer_header_t *header = NULL;
+
+    if (bytes >= PIXEL_BUFFER_MMAP_THRESHOLD) {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        size_t mappedBytes = (bytes + page - 1) / page * page;
+        enum buffer_kind_t kind = backingDirectory[0] ? BUFFER_FILE : BUFFER_ANONYMOUS;
+        void *memory = NULL;
+        if (kind == BUFFER_FILE) {
+            memory = map_file(mappedBytes);
+        }
+        else {
+            memory = mmap(NULL, mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED) {
+                memory = NULL;
+            }
+#ifdef MADV_HUGEPAGE
+            // Weniger TLB-Fehlgriffe beim zeilen- & spaltenweisen Durchlaufen großer Bilder
+            if (memory) {
+                madvise(memory, mappedBytes, MADV_HUGEPAGE);
+            }
+#endif
+        }
+        if (memory) {
+            header = memory;
+            header->info.bytes = mappedBytes;
+            header->info.kind = kind;
+        }
+    }
+    else {
+        void *memory = NULL;
+        if (posix_memalign(&memory, PIXEL_BUFFER_ALIGNMENT, bytes) == 0) {
+            header = memory;
+            header->info.bytes = bytes;
+            header->info.kind = BUFFER_HEAP;
+        }
+    }
+    return header;
+}
+
+static void system_free(buffer_header_t *header) {
+    if (header->info.kind == BUFFER_HEAP) {
+        free(header);
+    }
+    else {
+        munmap(header, header->info.bytes);
+    }
+}
+
+/**
+ * @brief Entfernt den Eintrag `index` aus dem Pool. Muss mit gehaltenem Lock aufgerufen werden.
+ */
+static buffer_header_t *pool_take(unsigned index) {
+    buffer_header_t *header = pool.buffers[index];
+    memmove(&pool.buffers[index], &pool.buffers[index + 1], (pool.count - index - 1) * sizeof(buffer_header_t *));
+    pool.count--;
+    pool.cachedBytes -= header->info.bytes;
+    return header;
+}
+
+color_t *pixel_buffer_alloc(size_t count) {
+    if (count == 0 || count > PIXEL_BUFFER_MAX_COUNT) {
+        return NULL;
+    }
+    size_t bytes = size_class(sizeof(buffer_header_t) + count * sizeof(color_t));
+
+    // Kleinsten passenden Puffer aus dem Pool nehmen, höchstens doppelt so groß wie angefordert
+    pthread_mutex_lock(&pool.lock);
+    pool.stats.requests++;
+    buffer_header_t *header = NULL;
+    unsigned best = pool.count;
+    for (unsigned i = 0; i < pool.count; i++) {
+        size_t available = pool.buffers[i]->info.bytes;
+        if (available >= bytes && available / 2 <= bytes && (best == pool.count || available < pool.buffers[best]->info.bytes)) {
+            best = i;
+        }
+    }
+    buffer_header_t *released[PIXEL_POOL_MAX_BUFFERS];
+    unsigned releasedCount = 0;
+    if (best < pool.count) {
+        header = pool_take(best);
+        pool.stats.poolHits++;
+    }
+    else {
+        // Die Bilder werden größer: kleinere Puffer im Pool würden nur noch Speicher belegen
+        for (unsigned i = pool.count; i-- > 0; ) {
+            if (pool.buffers[i]->info.bytes < bytes) {
+                released[releasedCount++] = pool_take(i);
+            }
+        }
+    }
+    pthread_mutex_unlock(&pool.lock);
+
+    for (unsigned i = 0; i < releasedCount; i++) {
+        POOL_UNPOISON(released[i] + 1, released[i]->info.bytes - sizeof(buffer_header_t));
+        system_free(released[i]);
+    }
+    if (header) {
+        POOL_UNPOISON(header + 1, header->info.bytes - sizeof(buffer_header_t));
+    }
+    else if (!(header = system_alloc(bytes))) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.stats.liveBytes += header->info.bytes;
+    if (pool.stats.liveBytes + pool.cachedBytes > pool.stats.peakBytes) {
+        pool.stats.peakBytes = pool.stats.liveBytes + pool.cachedBytes;
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return (color_t *)(header + 1);
+}
+
+void pixel_buffer_free(color_t *pixels) {
+    if (!pixels) {
+        return;
+    }
+    buffer_header_t *header = (buffer_header_t *)pixels - 1;
+    size_t bytes = header->info.bytes;
+
+    // Puffer in den Pool legen, bei Überschreitung des Budgets die ältesten an das System zurückgeben
+    buffer_header_t *released[PIXEL_POOL_MAX_BUFFERS + 1];
+    unsigned releasedCount = 0;
+    pthread_mutex_lock(&pool.lock);
+    pool.stats.liveBytes -= bytes;
+    if (bytes > PIXEL_POOL_MAX_BYTES) {
+        released[releasedCount++] = header;
+    }
+    else {
+        while (pool.count > 0 && (pool.count == PIXEL_POOL_MAX_BUFFERS || pool.cachedBytes + bytes > PIXEL_POOL_MAX_BYTES)) {
+            released[releasedCount++] = pool_take(0);
+        }
+        POOL_POISON(pixels, bytes - sizeof(buffer_header_t));
+        pool.buffers[pool.count++] = header;
+        pool.cachedBytes += bytes;
+    }
+    pthread_mutex_unlock(&pool.lock);
+
+    for (unsigned i = 0; i < releasedCount; i++) {
+        POOL_UNPOISON(released[i] + 1, released[i]->info.bytes - sizeof(buffer_header_t));
+        system_free(released[i]);
+    }
+}
+
+size_t pixel_buffer_capacity(const color_t *pixels) {
+    if (!pixels) {
+        return 0;
+    }
+    const buffer_header_t *header = (const buffer_header_t *)pixels - 1;
+    return (header->info.bytes - sizeof(buffer_header_t)) / sizeof(color_t);
+}
+
+void pixel_buffer_trim(void) {
+    pthread_mutex_lock(&pool.lock);
+    while (pool.count > 0) {
+        buffer_header_t *header = pool_take(pool.count - 1);
+        POOL_UNPOISON(header + 1, header->info.bytes - sizeof(buffer_header_t));
+        system_free(header);
+    }
+    pthread_mutex_unlock(&pool.lock);
+}
+
+void pixel_buffer_get_stats(pixel_buffer_stats_t *stats) {
+    if (!stats) {
+        return;
+    }
+    pthread_mutex_lock(&pool.lock);
+    *stats = pool.stats;
+    stats->cachedBytes = pool.cachedBytes;
+    pthread_mutex_unlock(&pool.lock);
+}
+
+int pixel_buffer_reserve(color_t **pixels, size_t *capacity, size_t count) {
+    if (!pixels || !capacity) {
+        return -1;
+    }
+    if (*pixels && *capacity >= count) {
+        return 0;
+    }
+    color_t *grown = pixel_buffer_alloc(count);
+    if (!grown) {
+        return -3;
+    }
+    pixel_buffer_free(*pixels);
+    *pixels = grown;
+    *capacity = pixel_buffer_capacity(grown);
+    return 0;
+}
+
+int pixel_buffer_set_directory(const char *directory) {
+    if (directory && strlen(directory) >= sizeof(backingDirectory)) {
+        return -1;
+    }
+    pixel_buffer_trim();    // Puffer im Pool liegen noch im alten Speicher
+    if (!directory) {
+        backingDirectory[0] = '\0';
+        return 0;
+    }
+    strcpy(backingDirectory, directory);
+    return 0;
+}
\ No newline at end of file
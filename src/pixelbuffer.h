@@ -0,0 +1,103 @@
+#ifndef PIXELBUFFER_H
+#define PIXELBUFFER_H
+
+#include "core.h"
+
+#define PIXEL_BUFFER_ALIGNMENT 64                       // Ausrichtung aller Pixelpuffer in Bytes (Cachezeile)
+#define PIXEL_BUFFER_MMAP_THRESHOLD ((size_t)64 << 20)  // Ab dieser Größe werden Pixelpuffer über mmap angelegt
+#define PIXEL_BUFFER_MAX_COUNT ((SIZE_MAX - ((size_t)1 << 20)) / sizeof(color_t))  // Größter Puffer in Pixeln
+#define PIXEL_POOL_MAX_BYTES ((size_t)1 << 30)          // Speicherbudget der freigegebenen Puffer im Pool
+#define PIXEL_POOL_MAX_BUFFERS 16                       // Höchstzahl der Puffer im Pool
+
+/**
+ * @brief Zähler des Pufferpools (siehe `pixel_buffer_get_stats()`)
+ */
+typedef struct {
+    uint64_t requests;      // Aufrufe von `pixel_buffer_alloc()`
+    uint64_t poolHits;      // Davon aus dem Pool bedient, ohne neuen Speicher vom System
+    size_t liveBytes;       // Bytes der Puffer in Benutzung
+    size_t cachedBytes;     // Bytes der Puffer im Pool
+    size_t peakBytes;       // Höchststand von liveBytes + cachedBytes
+} pixel_buffer_stats_t;
+
+/**
+ * @brief Berechnet die Pixelanzahl eines Bildes mit Überlaufprüfung
+ *
+ * @param width Breite
+ * @param height Höhe
+ * @param count Erhält width * height
+ * @return int 0 bei Erfolg, -1 wenn das Bild leer ist oder die Größe in Bytes nicht in size_t passt
+ */
+int pixel_count(uint32_t width, uint32_t height, size_t *count);
+
+/**
+ * @brief Reserviert einen Puffer für `count` Pixel
+ *
+ * Die Größe wird auf eine Größenklasse aufgerundet. Passt ein freigegebener Puffer aus dem Pool (höchstens
+ * doppelt so groß), wird er wiederverwendet, ohne dass neue Seiten eingeblendet werden müssen. Sonst liegen
+ * kleine Puffer auf dem Heap, große (ab PIXEL_BUFFER_MMAP_THRESHOLD) werden über mmap angelegt & für
+ * Transparent Huge Pages markiert, mit `pixel_buffer_set_directory()` stattdessen als Datei, die der
+ * Kernel bei Speichermangel auslagern kann. Alle Puffer sind auf PIXEL_BUFFER_ALIGNMENT Bytes ausgerichtet
+ * & werden mit `pixel_buffer_free()` freigegeben, nie mit `free()`. Der Inhalt ist nicht initialisiert.
+ * Sicher für mehrere Threads.
+ *
+ * @param count Anzahl der Pixel
+ * @return color_t* Der Puffer oder NULL bei Überlauf oder Speicherproblemen
+ */
+color_t *pixel_buffer_alloc(size_t count);
+
+/**
+ * @brief Gibt einen Puffer von `pixel_buffer_alloc()` zurück
+ *
+ * Der Puffer kommt in den Pool. Übersteigt der Pool PIXEL_POOL_MAX_BUFFERS Puffer oder
+ * PIXEL_POOL_MAX_BYTES, werden die am längsten ungenutzten Puffer an das System zurückgegeben.
+ *
+ * @param pixels Der Puffer, NULL wird ignoriert
+ */
+void pixel_buffer_free(color_t *pixels);
+
+/**
+ * @brief Tatsächliche Größe eines Puffers in Pixeln (mindestens die angeforderte, siehe Größenklassen)
+ *
+ * @param pixels Der Puffer, NULL ergibt 0
+ */
+size_t pixel_buffer_capacity(const color_t *pixels);
+
+/**
+ * @brief Gibt alle Puffer im Pool an das System zurück
+ */
+void pixel_buffer_trim(void);
+
+/**
+ * @brief Liest die Zähler des Pufferpools
+ *
+ * @param stats Erhält die Zähler
+ */
+void pixel_buffer_get_stats(pixel_buffer_stats_t *stats);
+
+/**
+ * @brief Stellt sicher, dass `*pixels` mindestens `count` Pixel fasst
+ *
+ * Ein zu kleiner Puffer wird ersetzt, der Inhalt bleibt dabei nicht erhalten.
+ *
+ * @param pixels Zeiger auf den Puffer (NULL oder von `pixel_buffer_alloc()`)
+ * @param capacity Aktuelle Größe in Pixeln, wird aktualisiert
+ * @param count Benötigte Größe in Pixeln
+ * @return int 0 bei Erfolg, -3 bei Speicherproblemen (der alte Puffer bleibt dann erhalten)
+ */
+int pixel_buffer_reserve(color_t **pixels, size_t *capacity, size_t count);
+
+/**
+ * @brief Legt große Pixelpuffer künftig als Dateien in `directory` an
+ *
+ * Die Dateien werden sofort nach dem Anlegen gelöscht & verschwinden mit dem Puffer. So können Bilder
+ * verarbeitet werden, die größer als der Arbeitsspeicher sind.
+ *
+ * Der Pool wird dabei geleert.
+ *
+ * @param directory Vorhandenes Verzeichnis, NULL schaltet zurück auf anonymen Speicher
+ * @return int 0 bei Erfolg, -1 wenn der Pfad zu lang ist
+ */
+int pixel_buffer_set_directory(const char *directory);
+
+#endif      /* PIXELBUFFER_H */
\ No newline at end of file
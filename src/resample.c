@@ -0,0 +1,429 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "resample.h"
+#include "utils.h"
+#include "pixelbuffer.h"
+#include "core.h"
+
+#define RESAMPLE_BAND_ROWS 16    // Zeilen pro Teilauftrag für den Thread-Pool
+#define RESAMPLE_PI 3.14159265358979323846
+
+/**
+ * @brief Gewichtstabelle einer Achse, wird einmal pro Skalierung berechnet
+ */
+typedef struct {
+    uint32_t taps;        // Gewichte pro Zielposition (Maximum über alle Positionen, fehlende sind 0)
+    uint32_t *start;      // Erste Quellposition jeder Zielposition
+    int16_t *weights;     // `taps` Gewichte pro Zielposition, Summe jeweils 1 << RESAMPLE_BITS
+} resample_axis_t;
+
+/**
+ * @brief Gemeinsame Daten aller Zeilenbänder eines Skalierungsdurchgangs
+ */
+typedef struct {
+    const picture_t *source;
+    picture_t *target;
+    const resample_axis_t *axis;       // Gewichte der bearbeiteten Achse
+    const uint32_t *columns;           // Nächster Nachbar: Quellspalte jeder Zielspalte
+    const uint32_t *rows;              // Nächster Nachbar: Quellzeile jeder Zielzeile
+    const row_kernels_t *kernels;
+    uint32_t maxValue;                 // Obergrenze der Ergebnisse (Lanczos schwingt über)
+} resample_job_t;
+
+uint32_t resample_nearest_index(uint32_t sourceSize, uint32_t targetSize, uint32_t position) {
+    // Quotient in float, damit Overlays pixelgenau wie bisher abgebildet werden
+    float scale = (float)targetSize / sourceSize;
+    uint32_t index = (uint32_t)(position / scale);
+    return index < sourceSize ? index : sourceSize - 1;
+}
+
+static double triangle_kernel(double x) {
+    x = fabs(x);
+    return x < 1.0 ? 1.0 - x : 0.0;
+}
+
+static double lanczos3_kernel(double x) {
+    if (x == 0.0) {
+        return 1.0;
+    }
+    if (fabs(x) >= 3.0) {
+        return 0.0;
+    }
+    double px = RESAMPLE_PI * x;
+    return 3.0 * sin(px) * sin(px / 3.0) / (px * px);
+}
+
+/**
+ * @brief Bestimmt die Quellpositionen [first, end), die zur Zielposition `i` beitragen
+ */
+static void axis_window(resample_method_t method, double scale, double support, uint32_t inSize, uint32_t i,
+                        int64_t *first, int64_t *end) {
+    if (method == RESAMPLE_AREA) {
+        // Überdeckte Fläche [i * scale, (i + 1) * scale)
+        *first = (int64_t)floor(i * scale);
+        *end = (int64_t)ceil((i + 1) * scale);
+    }
+    else {
+        // Alle Pixel, deren Mitte näher als `support` an der Mitte des Zielpixels liegt
+        double center = (i + 0.5) * scale;
+        *first = (int64_t)floor(center - support - 0.5) + 1;
+        *end = (int64_t)ceil(center + support - 0.5);
+    }
+    if (*first < 0) {
+        *first = 0;
+    }
+    if (*end > (int64_t)inSize) {
+        *end = inSize;
+    }
+    if (*end <= *first) {
+        *first = *first < (int64_t)inSize ? *first : (int64_t)inSize - 1;
+        *end = *first + 1;
+    }
+}
+
+/**
+ * @brief Berechnet die Festkomma-Gewichte einer Achse
+ *
+ * Beim Verkleinern wird der Filter auf den Abstand der Zielpixel gestreckt, sodass jedes Quellpixel
+ * beiträgt. Die gerundeten Gewichte werden so korrigiert, dass ihre Summe genau 1 << RESAMPLE_BITS ist.
+ *
+ * @return int 0 bei Erfolg, -1 bei zu großen Tabellen, -3 bei Speicherproblemen
+ */
+static int build_axis(resample_method_t method, uint32_t inSize, uint32_t outSize, resample_axis_t *axis) {
+    double scale = (double)inSize / outSize;
+    double filterScale = scale > 1.0 ? scale : 1.0;
+    double support = (method == RESAMPLE_LANCZOS3 ? 3.0 : 1.0) * filterScale;
+
+    axis->taps = 1;
+    for (uint32_t i = 0; i < outSize; i++) {
+        int64_t first;
+        int64_t end;
+        axis_window(method, scale, support, inSize, i, &first, &end);
+        if ((uint64_t)(end - first) > axis->taps) {
+            axis->taps = (uint32_t)(end - first);
+        }
+    }
+    if (axis->taps > SIZE_MAX / sizeof(int16_t) / outSize) {
+        return -1;
+    }
+
+    axis->start = malloc((size_t)outSize * sizeof(uint32_t));
+    axis->weights = calloc((size_t)outSize * axis->taps, sizeof(int16_t));
+    double *values = malloc(axis->taps * sizeof(double));
+    if (!axis->start || !axis->weights || !values) {
+        free(values);
+        return -3;
+    }
+
+    const int32_t one = 1 << RESAMPLE_BITS;
+    for (uint32_t i = 0; i < outSize; i++) {
+        int64_t first;
+        int64_t end;
+        axis_window(method, scale, support, inSize, i, &first, &end);
+        uint32_t count = (uint32_t)(end - first);
+
+        double total = 0.0;
+        for (uint32_t k = 0; k < count; k++) {
+            double position = (double)(first + k);
+            if (method == RESAMPLE_AREA) {
+                double lo = i * scale > position ? i * scale : position;
+                double hi = (i + 1) * scale < position + 1.0 ? (i + 1) * scale : position + 1.0;
+                values[k] = hi > lo ? hi - lo : 0.0;
+            }
+            else {
+                double x = (position + 0.5 - (i + 0.5) * scale) / filterScale;
+                values[k] = method == RESAMPLE_LANCZOS3 ? lanczos3_kernel(x) : triangle_kernel(x);
+            }
+            total += values[k];
+        }
+        if (total == 0.0) {
+            values[0] = total = 1.0;
+        }
+
+        // Am Ende der Achse beginnt das Fenster früher, damit immer `taps` Quellpositionen gültig sind
+        uint32_t start = (uint32_t)first;
+        if (start + axis->taps > inSize) {
+            start = inSize - axis->taps;
+        }
+        int16_t *weight = axis->weights + (size_t)i * axis->taps + (first - start);
+        int32_t sum = 0;
+        uint32_t largest = 0;
+        for (uint32_t k = 0; k < count; k++) {
+            int32_t quantized = (int32_t)lround(values[k] / total * one);
+            weight[k] = (int16_t)quantized;
+            sum += quantized;
+            if (weight[k] > weight[largest]) {
+                largest = k;
+            }
+        }
+        weight[largest] = (int16_t)(weight[largest] + one - sum);
+        axis->start[i] = start;
+    }
+    free(values);
+    return 0;
+}
+
+static void release_axis(resample_axis_t *axis) {
+    free(axis->start);
+    free(axis->weights);
+    axis->start = NULL;
+    axis->weights = NULL;
+}
+
+static inline uint16_t resample_round16(int64_t sum, uint32_t maxValue) {
+    if (sum < 0) {
+        return 0;
+    }
+    sum = (sum + (1 << (RESAMPLE_BITS - 1))) >> RESAMPLE_BITS;
+    return (uint16_t)(sum > (int64_t)maxValue ? maxValue : sum);
+}
+
+/**
+ * @brief Begrenzt die Zeilen eines 8-Bit-Bildes mit maxColorValue < 255 (nur nach Lanczos nötig)
+ */
+static void clamp_row(color_t *row, uint32_t width, uint32_t maxValue) {
+    uint8_t limit = (uint8_t)maxValue;
+    for (uint32_t x = 0; x < width; x++) {
+        row[x].red = row[x].red > limit ? limit : row[x].red;
+        row[x].green = row[x].green > limit ? limit : row[x].green;
+        row[x].blue = row[x].blue > limit ? limit : row[x].blue;
+    }
+}
+
+static uint32_t band_end(uint32_t index, uint32_t rows) {
+    uint32_t end = (index + 1) * RESAMPLE_BAND_ROWS;
+    return end < rows ? end : rows;
+}
+
+static void horizontal_band(void *argument, uint32_t index, unsigned thread) {
+    const resample_job_t *job = argument;
+    const resample_axis_t *axis = job->axis;
+    uint32_t width = job->target->x;
+
+    for (uint32_t y = index * RESAMPLE_BAND_ROWS; y < band_end(index, job->target->y); y++) {
+        if (!picture_is_16bit(job->source)) {
+            job->kernels->resampleRow(picture_row(job->source, y), axis->start, axis->weights, axis->taps,
+                                      picture_row(job->target, y), width);
+            if (job->maxValue < 255) {
+                clamp_row(picture_row(job->target, y), width, job->maxValue);
+            }
+            continue;
+        }
+
+        const color16_t *in = picture_row16(job->source, y);
+        color16_t *out = picture_row16(job->target, y);
+        for (uint32_t i = 0; i < width; i++) {
+            const color16_t *pixel = in + axis->start[i];
+            const int16_t *weight = axis->weights + (size_t)i * axis->taps;
+            int64_t sumRed = 0;
+            int64_t sumGreen = 0;
+            int64_t sumBlue = 0;
+            int64_t sumAlpha = 0;
+            for (uint32_t k = 0; k < axis->taps; k++) {
+                sumRed += (int64_t)weight[k] * pixel[k].red;
+                sumGreen += (int64_t)weight[k] * pixel[k].green;
+                sumBlue += (int64_t)weight[k] * pixel[k].blue;
+                sumAlpha += (int64_t)weight[k] * pixel[k].alpha;
+            }
+            out[i].red = resample_round16(sumRed, job->maxValue);
+            out[i].green = resample_round16(sumGreen, job->maxValue);
+            out[i].blue = resample_round16(sumBlue, job->maxValue);
+            out[i].alpha = resample_round16(sumAlpha, UINT16_MAX);
+        }
+    }
+}
+
+static void vertical_band(void *argument, uint32_t index, unsigned thread) {
+    const resample_job_t *job = argument;
+    const resample_axis_t *axis = job->axis;
+    uint32_t width = job->target->x;
+
+    for (uint32_t y = index * RESAMPLE_BAND_ROWS; y < band_end(index, job->target->y); y++) {
+        const int16_t *weight = axis->weights + (size_t)y * axis->taps;
+        if (!picture_is_16bit(job->source)) {
+            job->kernels->resampleColumns(picture_row(job->source, axis->start[y]), job->source->x, weight, axis->taps,
+                                          picture_row(job->target, y), width);
+            if (job->maxValue < 255) {
+                clamp_row(picture_row(job->target, y), width, job->maxValue);
+            }
+            continue;
+        }
+
+        color16_t *out = picture_row16(job->target, y);
+        for (uint32_t x = 0; x < width; x++) {
+            int64_t sumRed = 0;
+            int64_t sumGreen = 0;
+            int64_t sumBlue = 0;
+            int64_t sumAlpha = 0;
+            for (uint32_t k = 0; k < axis->taps; k++) {
+                const color16_t *pixel = picture_row16(job->source, axis->start[y] + k) + x;
+                sumRed += (int64_t)weight[k] * pixel->red;
+                sumGreen += (int64_t)weight[k] * pixel->green;
+                sumBlue += (int64_t)weight[k] * pixel->blue;
+                sumAlpha += (int64_t)weight[k] * pixel->alpha;
+            }
+            out[x].red = resample_round16(sumRed, job->maxValue);
+            out[x].green = resample_round16(sumGreen, job->maxValue);
+            out[x].blue = resample_round16(sumBlue, job->maxValue);
+            out[x].alpha = resample_round16(sumAlpha, UINT16_MAX);
+        }
+    }
+}
+
+static void nearest_band(void *argument, uint32_t index, unsigned thread) {
+    const resample_job_t *job = argument;
+    uint32_t width = job->target->x;
+
+    for (uint32_t y = index * RESAMPLE_BAND_ROWS; y < band_end(index, job->target->y); y++) {
+        if (picture_is_16bit(job->source)) {
+            const color16_t *in = picture_row16(job->source, job->rows[y]);
+            color16_t *out = picture_row16(job->target, y);
+            for (uint32_t x = 0; x < width; x++) {
+                out[x] = in[job->columns[x]];
+            }
+        }
+        else {
+            const color_t *in = picture_row(job->source, job->rows[y]);
+            color_t *out = picture_row(job->target, y);
+            for (uint32_t x = 0; x < width; x++) {
+                out[x] = in[job->columns[x]];
+            }
+        }
+    }
+}
+
+static int run_resample_bands(thread_pool_t *pool, pool_job_t band, resample_job_t *job) {
+    uint32_t bandCount = (job->target->y + RESAMPLE_BAND_ROWS - 1) / RESAMPLE_BAND_ROWS;
+    return thread_pool_run(pool, bandCount, band, job);
+}
+
+/**
+ * @brief Nächster Nachbar über vorberechnete Quellspalten & -zeilen
+ */
+static int resample_nearest(thread_pool_t *pool, const picture_t *source, picture_t *target) {
+    uint32_t *columns = malloc((size_t)target->x * sizeof(uint32_t));
+    uint32_t *rows = malloc((size_t)target->y * sizeof(uint32_t));
+    int status = -3;
+    if (columns && rows) {
+        for (uint32_t x = 0; x < target->x; x++) {
+            columns[x] = resample_nearest_index(source->x, target->x, x);
+        }
+        for (uint32_t y = 0; y < target->y; y++) {
+            rows[y] = resample_nearest_index(source->y, target->y, y);
+        }
+        resample_job_t job = { .source = source, .target = target, .columns = columns, .rows = rows };
+        status = run_resample_bands(pool, nearest_band, &job);
+    }
+    free(columns);
+    free(rows);
+    return status;
+}
+
+/**
+ * @brief Gewichtete Skalierung: horizontal in ein Zwischenbild (Zielbreite x Quellhöhe), danach vertikal
+ *
+ * Bleibt eine Achse gleich, entfällt ihr Durchgang.
+ */
+static int resample_separable(thread_pool_t *pool, simd_level_t simd, const picture_t *source, picture_t *target,
+                              resample_method_t method) {
+    resample_axis_t horizontal = {0};
+    resample_axis_t vertical = {0};
+    picture_t intermediate = *source;
+    bool ownsIntermediate = false;
+    resample_job_t job = { .kernels = get_row_kernels(simd), .maxValue = source->maxColorValue };
+    int status = 0;
+
+    if (target->x != source->x) {
+        status = build_axis(method, source->x, target->x, &horizontal);
+        if (status == 0 && target->y == source->y) {
+            intermediate = *target;    // Nur horizontal: direkt ins Ziel
+        }
+        else if (status == 0) {
+            intermediate.x = target->x;
+            intermediate.pixels = pixel_buffer_alloc(picture_buffer_size(&intermediate));
+            ownsIntermediate = true;
+            status = intermediate.pixels ? 0 : -3;
+        }
+        if (status == 0) {
+            job.source = source;
+            job.target = &intermediate;
+            job.axis = &horizontal;
+            status = run_resample_bands(pool, horizontal_band, &job);
+        }
+    }
+    if (status == 0 && target->y != source->y) {
+        status = build_axis(method, source->y, target->y, &vertical);
+        if (status == 0) {
+            job.source = &intermediate;
+            job.target = target;
+            job.axis = &vertical;
+            status = run_resample_bands(pool, vertical_band, &job);
+        }
+    }
+
+    if (ownsIntermediate) {
+        pixel_buffer_free(intermediate.pixels);
+    }
+    release_axis(&horizontal);
+    release_axis(&vertical);
+    return status;
+}
+
+int resample_picture(thread_pool_t *pool, simd_level_t simd, const picture_t *source, picture_t *target,
+                     resample_method_t method) {
+    size_t count;
+    if (!source || !target || !source->pixels || source->x == 0 || source->y == 0
+        || pixel_count(target->x, target->y, &count) != 0) {
+        return -1;
+    }
+    memcpy(target->format, source->format, sizeof(target->format));
+    target->maxColorValue = source->maxColorValue;
+    target->pixels = pixel_buffer_alloc(picture_buffer_size(target));
+    if (!target->pixels) {
+        return -3;
+    }
+
+    int status;
+    if (target->x == source->x && target->y == source->y) {
+        memcpy(target->pixels, source->pixels, count * picture_pixel_size(source));
+        status = 0;
+    }
+    else if (method == RESAMPLE_NEAREST) {
+        status = resample_nearest(pool, source, target);
+    }
+    else {
+        status = resample_separable(pool, simd, source, target, method);
+    }
+
+    if (status) {
+        pixel_buffer_free(target->pixels);
+        target->pixels = NULL;
+    }
+    return status;
+}
+
+int resample_method_from_name(const char *name, resample_method_t *method) {
+    if (!name || !method) {
+        return -1;
+    }
+    if (strcmp(name, "nearest") == 0) {
+        *method = RESAMPLE_NEAREST;
+    }
+    else if (strcmp(name, "bilinear") == 0) {
+        *method = RESAMPLE_BILINEAR;
+    }
+    else if (strcmp(name, "area") == 0) {
+        *method = RESAMPLE_AREA;
+    }
+    else if (strcmp(name, "lanczos3") == 0) {
+        *method = RESAMPLE_LANCZOS3;
+    }
+    else {
+        return -1;
+    }
+    return 0;
+}
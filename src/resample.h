@@ -0,0 +1,54 @@
+#ifndef RESAMPLE_H
+#define RESAMPLE_H
+
+#include "core.h"
+#include "kernels.h"
+#include "threadpool.h"
+
+/**
+ * @brief Interpolationsverfahren zum Skalieren
+ */
+typedef enum {
+    RESAMPLE_NEAREST = 0,    // Nächster Nachbar (Overlays, Rahmen behalten ihre reinen Farben)
+    RESAMPLE_BILINEAR,       // Dreiecksfilter, beim Verkleinern auf den Abstand der Zielpixel gestreckt
+    RESAMPLE_AREA,           // Mittelwert über die überdeckte Fläche, gewichtet nach Überdeckung
+    RESAMPLE_LANCZOS3,       // sinc-Fenster mit 3 Keulen
+} resample_method_t;
+
+/**
+ * @brief Skaliert ein Bild auf die Größe `target->x` x `target->y`
+ *
+ * Die Gewichte werden pro Zielspalte & Zielzeile einmal berechnet & in 14 Bit Festkomma abgelegt
+ * (Summe genau 1 << RESAMPLE_BITS, einfarbige Flächen bleiben exakt erhalten). Skaliert wird zuerst
+ * horizontal, dann vertikal, jeweils in Zeilenbändern auf dem Thread-Pool & mit den Zeilenkerneln
+ * des gewählten Befehlssatzes. Bilder mit 16 Bit pro Kanal werden skalar skaliert.
+ *
+ * @param pool Thread-Pool für die Zeilenbänder, NULL für serielle Ausführung
+ * @param simd Befehlssatz der Zeilenkernel
+ * @param source Das Ausgangsbild (bleibt unverändert)
+ * @param target `x` & `y` geben die Zielgröße an, erhält Format, maximalen Farbwert & einen neuen
+ *               Puffer von `pixel_buffer_alloc()`
+ * @param method Das Interpolationsverfahren
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben oder Größen, -3 bei Speicherproblemen
+ */
+int resample_picture(thread_pool_t *pool, simd_level_t simd, const picture_t *source, picture_t *target,
+                     resample_method_t method);
+
+/**
+ * @brief Quellposition des nächsten Nachbarn für eine Zielposition (wie bei `RESAMPLE_NEAREST`)
+ *
+ * @param sourceSize Größe der Quellachse
+ * @param targetSize Größe der Zielachse
+ * @param position Zielposition
+ * @return uint32_t Quellposition, immer kleiner als `sourceSize`
+ */
+uint32_t resample_nearest_index(uint32_t sourceSize, uint32_t targetSize, uint32_t position);
+
+/**
+ * @brief Ordnet einem Namen (nearest, bilinear, area, lanczos3) ein Interpolationsverfahren zu
+ *
+ * @return int 0 bei Erfolg, -1 bei unbekanntem Namen
+ */
+int resample_method_from_name(const char *name, resample_method_t *method);
+
+#endif      /* RESAMPLE_H */
@@ -0,0 +1,256 @@
+#include <pthread.h>
+#include <sys/resource.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "stats.h"
+#include "pixelbuffer.h"
+#include "core.h"
+
+#define STATS_MAX_THREADS 256    // Weitere Threads werden dem letzten Eintrag zugerechnet
+#define STATS_MAX_NAMES 64       // Verschiedene Spannen in der Zusammenfassung
+
+typedef struct {
+    const char *name;
+    const char *category;
+    double start;                // Sekunden seit `stats_enable()`
+    double duration;
+    unsigned thread;
+} stats_event_t;
+
+typedef struct {
+    const char *name;
+    const char *category;
+    double seconds;
+    size_t count;
+} stats_total_t;
+
+static struct {
+    bool enabled;                // Wird vor dem Start weiterer Threads gesetzt & danach nur gelesen
+    bool recordBands;
+    double origin;
+    pthread_mutex_t lock;
+    stats_event_t *events;
+    size_t count;
+    size_t capacity;
+    pthread_t threads[STATS_MAX_THREADS];
+    unsigned threadCount;
+    double busy[STATS_MAX_THREADS];
+    uint64_t bytesRead;
+    uint64_t bytesWritten;
+} stats = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+void stats_enable(bool recordBands) {
+    stats.enabled = true;
+    stats.recordBands = stats.recordBands || recordBands;
+    if (stats.origin == 0.0) {
+        stats.origin = stats_now();
+    }
+}
+
+bool stats_enabled(void) {
+    return stats.enabled;
+}
+
+double stats_now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Kleine, fortlaufende Nummer des aufrufenden Threads (0 ist der erste gemessene Thread)
+ *
+ * Muss mit gehaltenem Lock aufgerufen werden.
+ */
+static unsigned thread_number(void) {
+    pthread_t self = pthread_self();
+    for (unsigned i = 0; i < stats.threadCount; i++) {
+        if (pthread_equal(stats.threads[i], self)) {
+            return i;
+        }
+    }
+    if (stats.threadCount == STATS_MAX_THREADS) {
+        return STATS_MAX_THREADS - 1;
+    }
+    stats.threads[stats.threadCount] = self;
+    return stats.threadCount++;
+}
+
+/**
+ * @brief Hängt ein Ereignis an, bei Speichermangel geht es verloren. Muss mit gehaltenem Lock aufgerufen werden.
+ */
+static void append_event(const char *name, const char *category, double start, double end, unsigned thread) {
+    if (stats.count == stats.capacity) {
+        size_t capacity = stats.capacity ? stats.capacity * 2 : 1024;
+        stats_event_t *events = realloc(stats.events, capacity * sizeof(stats_event_t));
+        if (!events) {
+            return;
+        }
+        stats.events = events;
+        stats.capacity = capacity;
+    }
+    stats.events[stats.count++] = (stats_event_t){ .name = name, .category = category, .start = start - stats.origin,
+                                                   .duration = end - start, .thread = thread };
+}
+
+void stats_span(const char *name, const char *category, double start) {
+    if (!stats.enabled) {
+        return;
+    }
+    double end = stats_now();
+    pthread_mutex_lock(&stats.lock);
+    append_event(name, category, start, end, thread_number());
+    pthread_mutex_unlock(&stats.lock);
+}
+
+void stats_band(double start) {
+    if (!stats.enabled) {
+        return;
+    }
+    double end = stats_now();
+    pthread_mutex_lock(&stats.lock);
+    unsigned thread = thread_number();
+    stats.busy[thread] += end - start;
+    if (stats.recordBands) {
+        append_event("band", "pool", start, end, thread);
+    }
+    pthread_mutex_unlock(&stats.lock);
+}
+
+void stats_count_io(uint64_t bytesRead, uint64_t bytesWritten) {
+    if (!stats.enabled) {
+        return;
+    }
+    pthread_mutex_lock(&stats.lock);
+    stats.bytesRead += bytesRead;
+    stats.bytesWritten += bytesWritten;
+    pthread_mutex_unlock(&stats.lock);
+}
+
+/**
+ * @brief Höchster Bedarf an Arbeitsspeicher (Resident Set Size) des Prozesses in kB
+ */
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : 0;
+}
+
+/**
+ * @brief Seitenfehler ohne Plattenzugriff, v.a. beim ersten Beschreiben neu eingeblendeter Puffer
+ */
+static long minor_page_faults(void) {
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_minflt : 0;
+}
+
+void stats_print_summary(FILE *output) {
+    if (!stats.enabled || !output) {
+        return;
+    }
+    double wall = stats_now() - stats.origin;
+    pthread_mutex_lock(&stats.lock);
+
+    // Spannen gleichen Namens zusammenfassen (Zeilenbänder stehen in der Auslastung pro Thread)
+    stats_total_t totals[STATS_MAX_NAMES];
+    unsigned nameCount = 0;
+    double ioSeconds = 0.0;
+    double filterSeconds = 0.0;
+    for (size_t i = 0; i < stats.count; i++) {
+        const stats_event_t *event = &stats.events[i];
+        if (strcmp(event->category, "pool") == 0) {
+            continue;
+        }
+        ioSeconds += strcmp(event->category, "io") == 0 ? event->duration : 0.0;
+        filterSeconds += strcmp(event->category, "filter") == 0 ? event->duration : 0.0;
+
+        unsigned n = 0;
+        while (n < nameCount && strcmp(totals[n].name, event->name) != 0) {
+            n++;
+        }
+        if (n == nameCount) {
+            if (nameCount == STATS_MAX_NAMES) {
+                continue;
+            }
+            totals[nameCount++] = (stats_total_t){ .name = event->name, .category = event->category };
+        }
+        totals[n].seconds += event->duration;
+        totals[n].count++;
+    }
+
+    fprintf(output, "\nStats (wall time %.4f s):\n", wall);
+    for (unsigned n = 0; n < nameCount; n++) {
+        fprintf(output, "  %-8s %-22s %10.4f s  %6zux\n", totals[n].category, totals[n].name, totals[n].seconds, totals[n].count);
+    }
+    fprintf(output, "  I/O %.4f s, filters %.4f s (incl. overlay loading)\n", ioSeconds, filterSeconds);
+    fprintf(output, "  Read %.2f MB, written %.2f MB\n", stats.bytesRead / 1e6, stats.bytesWritten / 1e6);
+    fprintf(output, "  Peak RSS %.1f MB, %ld minor page faults\n", peak_rss_kb() / 1024.0, minor_page_faults());
+    pixel_buffer_stats_t buffers;
+    pixel_buffer_get_stats(&buffers);
+    fprintf(output, "  Pixel buffers: %llu requests, %llu pool hits (%.0f%%), peak %.1f MB\n",
+            (unsigned long long)buffers.requests, (unsigned long long)buffers.poolHits,
+            buffers.requests ? 100.0 * buffers.poolHits / buffers.requests : 0.0, buffers.peakBytes / 1e6);
+    for (unsigned t = 0; t < stats.threadCount; t++) {
+        if (stats.busy[t] > 0.0) {
+            fprintf(output, "  Thread %u busy %.4f s (%.0f%% of wall time)\n", t, stats.busy[t],
+                    wall > 0 ? 100.0 * stats.busy[t] / wall : 0.0);
+        }
+    }
+    pthread_mutex_unlock(&stats.lock);
+}
+
+int stats_write_trace(const char *path) {
+    if (!stats.enabled) {
+        return -1;
+    }
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        return -2;
+    }
+
+    pixel_buffer_stats_t buffers;
+    pixel_buffer_get_stats(&buffers);
+    pthread_mutex_lock(&stats.lock);
+    int written = fprintf(file, "{\"displayTimeUnit\": \"ms\", \"otherData\": {\"bytesRead\": %llu, \"bytesWritten\": %llu, "
+                          "\"peakRssKB\": %ld, \"minorPageFaults\": %ld, \"bufferRequests\": %llu, \"bufferPoolHits\": %llu, "
+                          "\"bufferPeakBytes\": %zu},\n\"traceEvents\": [\n", (unsigned long long)stats.bytesRead,
+                          (unsigned long long)stats.bytesWritten, peak_rss_kb(), minor_page_faults(),
+                          (unsigned long long)buffers.requests, (unsigned long long)buffers.poolHits, buffers.peakBytes);
+    const char *separator = "";
+    for (unsigned t = 0; t < stats.threadCount && written >= 0; t++) {
+        written = fprintf(file, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, "
+                          "\"args\": {\"name\": \"thread %u\"}}", separator, t, t);
+        separator = ",\n";
+    }
+    // Zeitstempel in Mikrosekunden
+    for (size_t i = 0; i < stats.count && written >= 0; i++) {
+        const stats_event_t *event = &stats.events[i];
+        written = fprintf(file, "%s{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+                          "\"pid\": 1, \"tid\": %u}", separator, event->name, event->category, event->start * 1e6,
+                          event->duration * 1e6, event->thread);
+        separator = ",\n";
+    }
+    pthread_mutex_unlock(&stats.lock);
+
+    if (written >= 0) {
+        written = fprintf(file, "\n]}\n");
+    }
+    if (fclose(file) != 0 || written < 0) {
+        return -3;
+    }
+    return 0;
+}
+
+void stats_release(void) {
+    pthread_mutex_lock(&stats.lock);
+    free(stats.events);
+    stats.events = NULL;
+    stats.count = 0;
+    stats.capacity = 0;
+    stats.enabled = false;
+    pthread_mutex_unlock(&stats.lock);
+}
@@ -0,0 +1,74 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "core.h"
+
+/**
+ * @brief Schaltet die Messungen ein (Option `stats` bzw. `trace=`)
+ *
+ * Ohne Aufruf kosten alle Messpunkte nur die Abfrage von `stats_enabled()`. Zeiten werden ab
+ * diesem Aufruf gezählt.
+ *
+ * @param recordBands true, wenn auch jedes Zeilenband des Thread-Pools als Ereignis festgehalten wird
+ *                    (nur für den Trace nötig, die Auslastung pro Thread wird immer gezählt)
+ */
+void stats_enable(bool recordBands);
+
+/**
+ * @brief Gibt an, ob die Messungen eingeschaltet sind
+ */
+bool stats_enabled(void);
+
+/**
+ * @brief Monotone Uhr in Sekunden, Startwert für `stats_span()`
+ */
+double stats_now(void);
+
+/**
+ * @brief Hält eine Zeitspanne des aufrufenden Threads fest, die jetzt endet
+ *
+ * @param name Name der Spanne, muss bis `stats_release()` gültig bleiben (z.B. ein Stringliteral)
+ * @param category Gruppe der Spanne: io, overlay, filter oder pool
+ * @param start Startzeitpunkt von `stats_now()`
+ */
+void stats_span(const char *name, const char *category, double start);
+
+/**
+ * @brief Zählt die Rechenzeit eines Teilauftrags des Thread-Pools für den aufrufenden Thread
+ *
+ * @param start Startzeitpunkt von `stats_now()`
+ */
+void stats_band(double start);
+
+/**
+ * @brief Zählt gelesene & geschriebene Bytes von Bilddateien
+ */
+void stats_count_io(uint64_t bytesRead, uint64_t bytesWritten);
+
+/**
+ * @brief Gibt die Zusammenfassung aus: Zeit pro Spanne, Anteil Ein-/Ausgabe & Rechnen, Bytes,
+ *        Spitzenbedarf an Arbeitsspeicher & Auslastung pro Thread
+ *
+ * @param output Zieldatei, z.B. stdout
+ */
+void stats_print_summary(FILE *output);
+
+/**
+ * @brief Schreibt alle Spannen im Trace-Event-Format von Chrome (chrome://tracing, Perfetto)
+ *
+ * @param path Pfad der JSON-Datei
+ * @return int 0 bei Erfolg, -1 wenn die Messungen nicht eingeschaltet sind, -2 wenn die Datei nicht geöffnet
+ *             werden kann, -3 bei Schreibfehlern
+ */
+int stats_write_trace(const char *path);
+
+/**
+ * @brief Gibt alle festgehaltenen Ereignisse frei & schaltet die Messungen aus
+ */
+void stats_release(void);
+
+#endif      /* STATS_H */
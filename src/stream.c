@@ -0,0 +1,305 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "stream.h"
+#include "filters.h"
+#include "utils.h"
+#include "pixelbuffer.h"
+#include "resample.h"
+#include "overlayspans.h"
+#include "stats.h"
+#include "core.h"
+
+/**
+ * @brief Zustand einer Stufe der Kette: gleitendes Fenster über ihre Eingabezeilen
+ */
+typedef struct {
+    const filter_descriptor_t *filter;
+    uint32_t halo;                  // Nachbarzeilen oberhalb & unterhalb, die der Filter liest
+    picture_t window;               // Gepufferte Eingabezeilen, `window.y` ist die aktuelle Anzahl
+    picture_t output;               // Ausgabezeilen, gleiche Zeilenindizes wie `window`
+    uint32_t capacityRows;
+    uint32_t windowStart;           // Bildzeile der ersten Fensterzeile
+    uint32_t nextRow;               // Nächste Bildzeile, die ausgegeben wird
+    picture_t overlaySource;        // Unskaliertes Filterbild (nur Overlays)
+    uint32_t *overlayColumns;       // Quellspalte jeder Bildspalte im Filterbild (nächster Nachbar)
+    color_t *overlayRows;           // Skalierte Filterbild-Zeilen zum aktuellen Fenster
+    overlay_spans_t frameSpans;     // Rahmen: abgedeckte Abschnitte statt skalierter Zeilen
+} stream_stage_t;
+
+typedef struct {
+    filter_context_t *context;
+    stream_stage_t stages[FILTER_CHAIN_MAX];
+    uint32_t stageCount;
+    uint32_t width;
+    uint32_t height;
+    size_t pixelSize;               // sizeof(color_t) oder sizeof(color16_t)
+    FILE *output;
+} stream_t;
+
+static uint32_t min_rows(uint32_t a, uint32_t b) {
+    return a < b ? a : b;
+}
+
+/**
+ * @brief Lädt das Filterbild einer Overlay-Stufe & berechnet die Quellspalten wie `resample_picture()`
+ *
+ * Statt das Filterbild auf die volle Bildgröße zu skalieren, werden später nur die Zeilen
+ * des aktuellen Fensters erzeugt. Rahmen werden einmal in ihre abgedeckten Abschnitte zerlegt.
+ */
+static int prepare_overlay(stream_stage_t *stage, const picture_t *image) {
+    const char *path = get_overlay_path(stage->filter);
+    if (!path) {
+        return -2;
+    }
+    int status = load_overlay_from_path(path, &stage->overlaySource);
+    if (status) {
+        return status;    // -2: Overlay-Bilder haben immer 8 Bit pro Kanal
+    }
+    int skip = get_frame_skip(stage->filter);
+    if (skip >= 0) {
+        return overlay_spans_build(&stage->overlaySource, image->x, image->y, (uint8_t)skip, &stage->frameSpans);
+    }
+
+    stage->overlayColumns = malloc((size_t)image->x * sizeof(uint32_t));
+    stage->overlayRows = malloc((size_t)stage->capacityRows * image->x * sizeof(color_t));
+    if (!stage->overlayColumns || !stage->overlayRows) {
+        return -3;
+    }
+    for (uint32_t x = 0; x < image->x; x++) {
+        stage->overlayColumns[x] = resample_nearest_index(stage->overlaySource.x, image->x, x);
+    }
+    return 0;
+}
+
+/**
+ * @brief Erzeugt die skalierten Filterbild-Zeilen [rowStart, rowEnd) des Fensters (Fensterindizes)
+ *
+ * @return picture_t Skaliertes Filterbild mit denselben Zeilenindizes wie das Fenster
+ */
+static picture_t scale_overlay_rows(const stream_t *stream, stream_stage_t *stage, uint32_t rowStart, uint32_t rowEnd) {
+    picture_t rows = stage->overlaySource;    // Format & Farbtiefe (Alphakanal) des Filterbildes
+    rows.x = stream->width;
+    rows.y = stage->window.y;
+    rows.pixels = stage->overlayRows;
+
+    for (uint32_t y = rowStart; y < rowEnd; y++) {
+        uint32_t sourceY = resample_nearest_index(stage->overlaySource.y, stream->height, stage->windowStart + y);
+        const color_t *in = picture_row(&stage->overlaySource, sourceY);
+        color_t *out = picture_row(&rows, y);
+        for (uint32_t x = 0; x < rows.x; x++) {
+            out[x] = in[stage->overlayColumns[x]];
+        }
+    }
+    return rows;
+}
+
+static int push_rows(stream_t *stream, uint32_t stageIndex, const uint8_t *rows, uint32_t count);
+
+/**
+ * @brief Gibt alle Bänder aus, deren Nachbarzeilen vollständig im Fenster liegen, & schiebt das Fenster weiter
+ */
+static int flush_stage(stream_t *stream, uint32_t stageIndex) {
+    stream_stage_t *stage = &stream->stages[stageIndex];
+
+    while (stage->nextRow < stream->height) {
+        uint32_t end = min_rows(stage->nextRow + STREAM_BAND_ROWS, stream->height);
+        uint32_t needed = min_rows(end + stage->halo, stream->height);
+        if (stage->windowStart + stage->window.y < needed) {
+            return 0;    // Auf weitere Eingabezeilen warten
+        }
+
+        uint32_t rowStart = stage->nextRow - stage->windowStart;
+        uint32_t rowEnd = end - stage->windowStart;
+        const uint8_t *finished;
+        int status;
+        double start = stats_now();
+        if (stage->halo == 0 && stage->frameSpans.spans) {
+            // Rahmen: nur die abgedeckten Pixel im Fenster überschreiben
+            overlay_spans_apply(&stage->frameSpans, &stage->window, stage->windowStart, rowStart, rowEnd);
+            status = 0;
+            finished = picture_row_bytes(&stage->window, rowStart);
+        }
+        else if (stage->halo == 0) {
+            // Overlay: direkt im Fenster
+            picture_t overlay = scale_overlay_rows(stream, stage, rowStart, rowEnd);
+            status = apply_filter_rows(stream->context, stage->filter, &stage->window, &stage->window, rowStart, rowEnd, &overlay);
+            finished = picture_row_bytes(&stage->window, rowStart);
+        }
+        else {
+            stage->output.y = stage->window.y;
+            status = apply_filter_rows(stream->context, stage->filter, &stage->window, &stage->output, rowStart, rowEnd, NULL);
+            finished = picture_row_bytes(&stage->output, rowStart);
+        }
+        stats_span(get_filter_name(stage->filter), "filter", start);
+        if (status == 0) {
+            status = push_rows(stream, stageIndex + 1, finished, rowEnd - rowStart);
+        }
+        if (status) {
+            return status;
+        }
+        stage->nextRow = end;
+
+        // Nur die Zeilen behalten, die spätere Bänder noch als Nachbarn brauchen
+        uint32_t keepFrom = stage->nextRow > stage->halo ? stage->nextRow - stage->halo : 0;
+        if (keepFrom > stage->windowStart) {
+            uint32_t drop = min_rows(keepFrom - stage->windowStart, stage->window.y);
+            memmove(stage->window.pixels, picture_row_bytes(&stage->window, drop),
+                    (size_t)(stage->window.y - drop) * stream->width * stream->pixelSize);
+            stage->window.y -= drop;
+            stage->windowStart += drop;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Übergibt fertige Zeilen an eine Stufe, hinter der letzten Stufe an die Ausgabedatei
+ */
+static int push_rows(stream_t *stream, uint32_t stageIndex, const uint8_t *rows, uint32_t count) {
+    if (stageIndex == stream->stageCount) {
+        size_t numPixels = (size_t)count * stream->width;
+        double start = stats_now();
+        int status = stream->pixelSize == sizeof(color16_t) ? write_binary_pixels16(stream->output, (const color16_t *)rows, numPixels)
+                                                            : write_binary_pixels(stream->output, (const color_t *)rows, numPixels);
+        stats_count_io(0, numPixels * stream->pixelSize / 4 * 3);    // 3 bzw. 6 Bytes pro Pixel in der Datei
+        stats_span("encode", "io", start);
+        return status;
+    }
+
+    stream_stage_t *stage = &stream->stages[stageIndex];
+    while (count > 0) {
+        uint32_t rowsToCopy = min_rows(count, stage->capacityRows - stage->window.y);
+        memcpy(picture_row_bytes(&stage->window, stage->window.y), rows, (size_t)rowsToCopy * stream->width * stream->pixelSize);
+        stage->window.y += rowsToCopy;
+        rows += (size_t)rowsToCopy * stream->width * stream->pixelSize;
+        count -= rowsToCopy;
+
+        int status = flush_stage(stream, stageIndex);
+        if (status) {
+            return status;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Legt Fenster & Ausgabepuffer aller Stufen an
+ *
+ * @return int 0 bei Erfolg, -2 bei nicht unterstützten Filtern, sonst Fehlercode von `prepare_overlay()`
+ */
+static int prepare_stages(stream_t *stream, const filter_chain_t *chain, const picture_t *image) {
+    for (uint32_t i = 0; i < chain->count; i++) {
+        stream_stage_t *stage = &stream->stages[i];
+        int halo = filter_stream_halo(&chain->stages[i]);
+        if (halo < 0) {
+            return -2;
+        }
+        stream->stageCount = i + 1;
+        stage->filter = &chain->stages[i];
+        stage->halo = (uint32_t)halo;
+        stage->capacityRows = STREAM_BAND_ROWS + 2 * stage->halo;
+
+        // Fenster & Ausgabe: Band + Nachbarzeilen oben & unten
+        stage->window = *image;
+        stage->window.y = 0;
+        stage->window.pixels = malloc((size_t)stage->capacityRows * image->x * stream->pixelSize);
+        if (!stage->window.pixels) {
+            return -3;
+        }
+        if (stage->halo > 0) {
+            stage->output = stage->window;
+            stage->output.pixels = malloc((size_t)stage->capacityRows * image->x * stream->pixelSize);
+            if (!stage->output.pixels) {
+                return -3;
+            }
+        }
+        else {
+            int status = prepare_overlay(stage, image);
+            if (status) {
+                return status;
+            }
+        }
+    }
+    return 0;
+}
+
+static void release_stages(stream_t *stream) {
+    for (uint32_t i = 0; i < stream->stageCount; i++) {
+        stream_stage_t *stage = &stream->stages[i];
+        free(stage->window.pixels);
+        free(stage->output.pixels);
+        pixel_buffer_free(stage->overlaySource.pixels);
+        free(stage->overlayColumns);
+        free(stage->overlayRows);
+        overlay_spans_free(&stage->frameSpans);
+    }
+}
+
+int stream_filter_file(filter_context_t *context, const filter_chain_t *chain, const char *inputPath, const char *outputPath) {
+    if (!chain || !inputPath || !outputPath || chain->count == 0) {
+        return -1;
+    }
+
+    FILE *input = fopen(inputPath, "rb");
+    if (!input) {
+        log_message(LOG_ERROR, "ERROR opening file %s: %s\n", inputPath, strerror(errno));
+        return -1;
+    }
+    picture_t image = {0};
+    double start = stats_now();
+    if (read_picture_header(input, &image) != 0 || image.format[1] != '6' || image.x == 0 || image.y == 0) {
+        log_message(LOG_ERROR, "Streaming requires a binary (P6) input.\n");
+        fclose(input);
+        return -1;
+    }
+
+    stats_span("parse header", "io", start);
+
+    stream_t stream = { .context = context, .width = image.x, .height = image.y, .pixelSize = picture_pixel_size(&image) };
+    int status = prepare_stages(&stream, chain, &image);
+    uint8_t *band = malloc((size_t)STREAM_BAND_ROWS * image.x * stream.pixelSize);
+    if (status == 0 && !band) {
+        status = -3;
+    }
+    if (status == 0) {
+        stream.output = fopen(outputPath, "wb");
+        if (!stream.output) {
+            status = -2;
+        }
+    }
+
+    if (status == 0) {
+        status = write_picture_header(stream.output, &image);
+        // Eingabe bandweise lesen & durch die Kette schieben
+        for (uint32_t row = 0; status == 0 && row < image.y; row += STREAM_BAND_ROWS) {
+            uint32_t count = min_rows(STREAM_BAND_ROWS, image.y - row);
+            size_t numPixels = (size_t)count * image.x;
+            start = stats_now();
+            int readStatus = picture_is_16bit(&image) ? read_binary_pixels16(input, (color16_t *)band, numPixels)
+                                                      : read_binary_pixels(input, (color_t *)band, numPixels);
+            if (readStatus != 0) {
+                status = -1;
+                break;
+            }
+            stats_count_io(numPixels * stream.pixelSize / 4 * 3, 0);
+            stats_span("decode pixels", "io", start);
+            status = push_rows(&stream, 0, band, count);
+        }
+        if (fclose(stream.output) != 0 && status == 0) {
+            status = -3;
+        }
+        if (status != 0) {
+            remove(outputPath);    // Keine halb gefilterte Ausgabe zurücklassen
+        }
+    }
+
+    free(band);
+    release_stages(&stream);
+    fclose(input);
+    return status;
+}
\ No newline at end of file
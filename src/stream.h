@@ -0,0 +1,30 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "core.h"
+#include "filters.h"
+
+#define STREAM_BAND_ROWS 64    // Zeilen, die pro Schritt gelesen, gefiltert & geschrieben werden
+
+/**
+ * @brief Wendet eine Filterkette zeilenweise auf eine P6-Datei an, ohne das ganze Bild zu laden
+ *
+ * Die Eingabe wird in Bändern zu STREAM_BAND_ROWS Zeilen gelesen. Jede Stufe der Kette hält nur ein
+ * gleitendes Fenster aus einem Band & den Nachbarzeilen, die der Filter oberhalb & unterhalb liest
+ * (`filter_stream_halo()`), fertige Zeilen werden sofort an die nächste Stufe bzw. die Ausgabedatei
+ * weitergegeben. Der Speicherbedarf wächst daher mit der Bildbreite, nicht mit der Bildhöhe.
+ * Das Ergebnis ist identisch zur Ausführung auf dem geladenen Bild. Unterstützt werden emboss,
+ * blur-light, blur-medium, blur-median & die Overlay-Presets, mit 8 oder 16 Bit pro Kanal.
+ *
+ * @param context Ausführungsumgebung (Thread-Pool), darf NULL sein
+ * @param chain Die Filterkette
+ * @param inputPath Pfad der Eingabedatei (P6)
+ * @param outputPath Pfad der Ausgabedatei, wird im Format P6 geschrieben
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben, nicht lesbarer oder nicht-P6-Eingabe,
+ *             -2 wenn ein Filter der Kette nicht zeilenweise ausgeführt werden kann oder die Ausgabedatei
+ *             nicht geöffnet werden kann, -3 bei Speicher- oder Schreibfehlern. Bei einem Fehler wird
+ *             keine unvollständige Ausgabedatei zurückgelassen
+ */
+int stream_filter_file(filter_context_t *context, const filter_chain_t *chain, const char *inputPath, const char *outputPath);
+
+#endif      /* STREAM_H */
\ No newline at end of file
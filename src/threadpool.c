@@ -0,0 +1,173 @@
+#include <pthread.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "threadpool.h"
+#include "stats.h"
+#include "core.h"
+
+typedef struct {
+    thread_pool_t *pool;
+    unsigned index;                 // Threadnummer, die an die Teilaufträge übergeben wird
+} worker_t;
+
+struct thread_pool {
+    pthread_t *workers;
+    worker_t *workerInfo;
+    unsigned workerCount;           // Zusätzliche Threads (ohne den Aufrufer)
+    pthread_mutex_t lock;
+    pthread_cond_t start;           // Signalisiert einen neuen Auftrag
+    pthread_cond_t finished;        // Signalisiert, dass alle Worker fertig sind
+    pool_job_t job;
+    void *argument;
+    uint32_t nextJob;
+    uint32_t jobCount;
+    unsigned busyWorkers;
+    unsigned long generation;       // Zählt die Aufträge, damit jeder Worker jeden genau einmal sieht
+    bool shutdown;
+};
+
+/**
+ * @brief Führt einen Teilauftrag aus & zählt seine Rechenzeit, wenn die Messungen eingeschaltet sind
+ */
+static void run_job(pool_job_t job, void *argument, uint32_t index, unsigned thread) {
+    if (!stats_enabled()) {
+        job(argument, index, thread);
+        return;
+    }
+    double start = stats_now();
+    job(argument, index, thread);
+    stats_band(start);
+}
+
+/**
+ * @brief Arbeitet offene Teilaufträge ab, bis keine mehr übrig sind
+ *
+ * Muss mit gehaltenem Lock aufgerufen werden, das Lock wird nur während der Ausführung freigegeben.
+ */
+static void drain_jobs(thread_pool_t *pool, unsigned thread) {
+    while (pool->nextJob < pool->jobCount) {
+        uint32_t index = pool->nextJob++;
+        pthread_mutex_unlock(&pool->lock);
+        run_job(pool->job, pool->argument, index, thread);
+        pthread_mutex_lock(&pool->lock);
+    }
+}
+
+static void *worker_main(void *argument) {
+    const worker_t *worker = argument;
+    thread_pool_t *pool = worker->pool;
+    unsigned long seenGeneration = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->shutdown && pool->generation == seenGeneration) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->shutdown) {
+            break;
+        }
+        seenGeneration = pool->generation;
+
+        drain_jobs(pool, worker->index);
+
+        if (--pool->busyWorkers == 0) {
+            pthread_cond_signal(&pool->finished);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+thread_pool_t *thread_pool_create(unsigned threadCount) {
+    if (threadCount == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threadCount = online > 0 ? (unsigned)online : 1;
+    }
+
+    thread_pool_t *pool = calloc(1, sizeof(thread_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+    pool->workers = calloc(threadCount, sizeof(pthread_t));
+    pool->workerInfo = calloc(threadCount, sizeof(worker_t));
+    if (!pool->workers || !pool->workerInfo) {
+        free(pool->workers);
+        free(pool->workerInfo);
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->finished, NULL);
+
+    // Der aufrufende Thread zählt als erster Thread
+    for (unsigned i = 0; i + 1 < threadCount; i++) {
+        pool->workerInfo[i].pool = pool;
+        pool->workerInfo[i].index = i + 1;
+        if (pthread_create(&pool->workers[i], NULL, worker_main, &pool->workerInfo[i]) != 0) {
+            break;    // Mit den bereits gestarteten Threads weiterarbeiten
+        }
+        pool->workerCount++;
+    }
+    return pool;
+}
+
+void thread_pool_destroy(thread_pool_t *pool) {
+    if (!pool) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (unsigned i = 0; i < pool->workerCount; i++) {
+        pthread_join(pool->workers[i], NULL);
+    }
+    pthread_cond_destroy(&pool->finished);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool->workerInfo);
+    free(pool);
+}
+
+unsigned thread_pool_size(const thread_pool_t *pool) {
+    return pool ? pool->workerCount + 1 : 1;
+}
+
+int thread_pool_run(thread_pool_t *pool, uint32_t jobCount, pool_job_t job, void *argument) {
+    if (!job) {
+        return -1;
+    }
+
+    // Ohne Worker oder bei nur einem Teilauftrag direkt im aufrufenden Thread ausführen
+    if (!pool || pool->workerCount == 0 || jobCount < 2) {
+        for (uint32_t i = 0; i < jobCount; i++) {
+            run_job(job, argument, i, 0);
+        }
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->job = job;
+    pool->argument = argument;
+    pool->nextJob = 0;
+    pool->jobCount = jobCount;
+    pool->busyWorkers = pool->workerCount;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+
+    drain_jobs(pool, 0);    // Der Aufrufer arbeitet mit
+
+    while (pool->busyWorkers > 0) {
+        pthread_cond_wait(&pool->finished, &pool->lock);
+    }
+    pool->job = NULL;
+    pool->argument = NULL;
+    pthread_mutex_unlock(&pool->lock);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include "core.h"
+
+typedef struct thread_pool thread_pool_t;
+
+/**
+ * @brief Funktion, die einen einzelnen Teilauftrag (z.B. ein Zeilenband) bearbeitet
+ *
+ * @param argument Gemeinsame Daten aller Teilaufträge
+ * @param index Nummer des Teilauftrags (0 bis jobCount - 1)
+ * @param thread Nummer des ausführenden Threads (0 ist der Aufrufer, höchstens `thread_pool_size() - 1`), 
+ *               z.B. um threadlokalen Arbeitsspeicher zu wählen
+ */
+typedef void (*pool_job_t)(void *argument, uint32_t index, unsigned thread);
+
+/**
+ * @brief Erstellt einen Thread-Pool
+ * 
+ * Der aufrufende Thread arbeitet bei `thread_pool_run()` mit, es werden also 
+ * `threadCount - 1` zusätzliche Threads gestartet.
+ *
+ * @param threadCount Gesamtzahl der Threads, 0 für die Anzahl der verfügbaren CPU-Kerne
+ * @return thread_pool_t* Der neue Pool oder NULL bei Fehlern
+ */
+thread_pool_t *thread_pool_create(unsigned threadCount);
+
+/**
+ * @brief Beendet alle Threads des Pools & gibt ihn frei
+ *
+ * @param pool Der Pool, NULL wird ignoriert
+ */
+void thread_pool_destroy(thread_pool_t *pool);
+
+/**
+ * @brief Gibt die Gesamtzahl der Threads des Pools zurück
+ *
+ * @param pool Der Pool, NULL entspricht einem Thread
+ * @return unsigned Anzahl der Threads einschließlich des aufrufenden Threads
+ */
+unsigned thread_pool_size(const thread_pool_t *pool);
+
+/**
+ * @brief Führt `jobCount` Teilaufträge auf dem Pool aus & wartet, bis alle fertig sind
+ * 
+ * Freie Threads holen sich jeweils den nächsten noch offenen Teilauftrag, sodass 
+ * ungleich teure Bänder sich selbst ausgleichen. Die Reihenfolge der Ausführung ist 
+ * nicht festgelegt, Teilaufträge dürfen daher nur disjunkte Bereiche schreiben.
+ *
+ * @param pool Der Pool, bei NULL werden alle Teilaufträge im aufrufenden Thread ausgeführt
+ * @param jobCount Anzahl der Teilaufträge
+ * @param job Funktion, die für jeden Teilauftrag aufgerufen wird
+ * @param argument Wird unverändert an `job` übergeben
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben
+ */
+int thread_pool_run(thread_pool_t *pool, uint32_t jobCount, pool_job_t job, void *argument);
+
+#endif      /* THREADPOOL_H */
\ No newline at end of file
@@ -1,12 +1,34 @@
+#include <stdarg.h>
 #include <stdbool.h>
+#include <errno.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <math.h>
 
 #include "utils.h"
+#include "pixelbuffer.h"
+#include "stats.h"
 #include "core.h"
 
+static log_handler_t logHandler = NULL;    // Ohne Empfänger bleibt die Bibliothek still
+
+void set_log_handler(log_handler_t handler) {
+    logHandler = handler;
+}
+
+void log_message(log_level_t level, const char *format, ...) {
+    if (!logHandler) {
+        return;
+    }
+    char message[2 * MAX_FILE_PATH_LEN];
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(message, sizeof(message), format, arguments);
+    va_end(arguments);
+    logHandler(level, message);
+}
+
 int starts_with(const char* word, const char* prefix) {
     if (!word || !prefix) {    // Wenn Zeiger Null ist
         return -1;
@@ -28,127 +50,962 @@ int starts_with(const char* word, const char* prefix) {
     return 1;
 }
 
-int load_picture_from_path(const char* path, picture_t *target) {
-    if (!path || !target) {
+/**
+ * @brief Prüft anhand der Dateigröße, ob ab der aktuellen Position noch `count` P6-Pixel vorhanden sind
+ *
+ * Damit wird eine abgeschnittene Datei nicht mehr stillschweigend mit EOF-Werten aufgefüllt.
+ *
+ * @param file Datei, deren Position direkt hinter dem Header steht (bleibt unverändert)
+ * @param count Anzahl der erwarteten Pixel
+ * @param bytesPerPixel 3 bei 8 Bit, 6 bei 16 Bit pro Kanal
+ * @return int 0 wenn genügend Daten vorhanden sind, sonst -1
+ */
+static int check_binary_size(FILE *file, size_t count, size_t bytesPerPixel) {
+    // Restgröße der Datei bestimmen, bevor gelesen wird
+    off_t dataStart = ftello(file);
+    if (dataStart < 0 || fseeko(file, 0, SEEK_END) != 0) {
+        log_message(LOG_ERROR, "Failed to determine file size.\n");
         return -1;
     }
-    char line[500];
+    off_t fileEnd = ftello(file);
+    if (fileEnd < dataStart || fseeko(file, dataStart, SEEK_SET) != 0) {
+        log_message(LOG_ERROR, "Failed to determine file size.\n");
+        return -1;
+    }
+    if ((size_t)(fileEnd - dataStart) / bytesPerPixel < count) {
+        log_message(LOG_ERROR, "Truncated pixel data: expected %zu bytes, found %lld.\n", count * bytesPerPixel, (long long)(fileEnd - dataStart));
+        return -1;
+    }
+    return 0;
+}
 
-    FILE *file = fopen(path, "rb");  
-    
-    if (file == NULL) {
-        perror("ERROR opening file!\n");
+int read_binary_pixels(FILE *file, color_t *pixels, size_t count) {
+    uint8_t *chunk = malloc(IO_CHUNK_PIXELS * 3);
+    if (!chunk) {
+        log_message(LOG_ERROR, "Memory allocation failed!\n");
         return -1;
     }
-    
-    // Lese das Format (P3 oder P6)
-    int formatValid = fscanf(file, "%2s", target->format);    // P3 oder P6
-    if (formatValid != 1 || (target->format[0] != 'P') || ((target->format[1] != '3' && target->format[1] != '6'))) {
-        printf("Unsopported image format.\n");
-        fclose(file);
+
+    size_t done = 0;
+    while (done < count) {
+        size_t n = count - done;
+        if (n > IO_CHUNK_PIXELS) {
+            n = IO_CHUNK_PIXELS;
+        }
+        if (fread(chunk, 3, n, file) != n) {
+            log_message(LOG_ERROR, "Failed to read pixel data.\n");
+            free(chunk);
+            return -1;
+        }
+
+        // RGB-Tripel in color_t entpacken (ohne Abhängigkeiten zwischen Iterationen, vektorisierbar)
+        color_t *out = pixels + done;
+        for (size_t i = 0; i < n; i++) {
+            out[i].red = chunk[3 * i];
+            out[i].green = chunk[3 * i + 1];
+            out[i].blue = chunk[3 * i + 2];
+            out[i].alpha = 0xff;
+        }
+        done += n;
+    }
+    free(chunk);
+    return 0;
+}
+
+int read_binary_pixels16(FILE *file, color16_t *pixels, size_t count) {
+    uint8_t *chunk = malloc(IO_CHUNK_PIXELS * 6);
+    if (!chunk) {
+        log_message(LOG_ERROR, "Memory allocation failed!\n");
+        return -1;
+    }
+
+    size_t done = 0;
+    while (done < count) {
+        size_t n = count - done;
+        if (n > IO_CHUNK_PIXELS) {
+            n = IO_CHUNK_PIXELS;
+        }
+        if (fread(chunk, 6, n, file) != n) {
+            log_message(LOG_ERROR, "Failed to read pixel data.\n");
+            free(chunk);
+            return -1;
+        }
+
+        // Big-Endian-Kanäle in color16_t entpacken
+        color16_t *out = pixels + done;
+        for (size_t i = 0; i < n; i++) {
+            const uint8_t *in = &chunk[6 * i];
+            out[i].red = (uint16_t)(in[0] << 8 | in[1]);
+            out[i].green = (uint16_t)(in[2] << 8 | in[3]);
+            out[i].blue = (uint16_t)(in[4] << 8 | in[5]);
+            out[i].alpha = 0xffff;
+        }
+        done += n;
+    }
+    free(chunk);
+    return 0;
+}
+
+#define ASCII_READ_BUFFER_SIZE (1 << 20)
+
+/**
+ * @brief Gepufferter Lesezugriff für den ASCII-Tokenizer
+ */
+typedef struct {
+    FILE *file;
+    uint8_t *buffer;
+    const uint8_t *position;  // Nächstes zu lesendes Byte
+    const uint8_t *end;       // Ende der gültigen Bytes im Puffer
+} ascii_reader_t;
+
+/**
+ * @brief Versucht eine Zahl mit 1-5 Ziffern direkt aus dem Puffer zu lesen
+ *
+ * Erwartet höchstens ein Leerzeichen oder einen Zeilenumbruch davor und mindestens 8 lesbare Bytes, 
+ * sodass keine Prüfung auf das Pufferende nötig ist.
+ *
+ * @param p Aktuelle Leseposition
+ * @param value Zielwert
+ * @return size_t Anzahl verbrauchter Bytes, 0 wenn der allgemeine Pfad benötigt wird
+ */
+static inline size_t parse_short_value(const uint8_t *p, uint32_t *value) {
+    const uint8_t *start = p;
+    p += (*p == ' ' || *p == '\n');
+
+    const uint8_t *digits = p;
+    uint32_t result = 0;
+    while ((uint8_t)(*p - '0') < 10 && p - digits < 5) {
+        result = result * 10 + (uint32_t)(*p - '0');
+        p++;
+    }
+    if (p == digits || (uint8_t)(*p - '0') < 10 || result > 0xffff) {
+        return 0;
+    }
+    *value = result;
+    return (size_t)(p - start);
+}
+
+/**
+ * @brief Liest die nächste Dezimalzahl aus dem Datenstrom (allgemeiner Pfad)
+ *
+ * Überspringt Leerraum & Kommentare (`#` bis Zeilenende), die laut PPM-Spezifikation 
+ * überall zwischen den Werten stehen dürfen, und lädt den Puffer bei Bedarf nach.
+ *
+ * @param reader Der gepufferte Leser
+ * @param value Zielwert
+ * @return int 0 bei Erfolg, -1 bei Dateiende, ungültigem Zeichen oder Wert > 65535
+ */
+static int read_ascii_value(ascii_reader_t *reader, uint32_t *value) {
+    const uint8_t *p = reader->position;
+    const uint8_t *end = reader->end;
+    uint32_t result = 0;
+    bool inComment = false;
+    bool hasDigits = false;
+
+    for (;;) {
+        if (p == end) {    // Puffer nachladen
+            size_t length = fread(reader->buffer, 1, ASCII_READ_BUFFER_SIZE, reader->file);
+            p = reader->buffer;
+            end = reader->buffer + length;
+            if (length == 0) {
+                break;    // Dateiende
+            }
+        }
+        uint8_t c = *p;
+
+        if (inComment) {
+            inComment = (c != '\n' && c != '\r');
+        }
+        else if ((uint8_t)(c - '0') < 10) {
+            result = result * 10 + (uint32_t)(c - '0');
+            if (result > 0xffff) {
+                return -1;
+            }
+            hasDigits = true;
+        }
+        else if (hasDigits) {
+            break;    // Trennzeichen bleibt für den nächsten Aufruf stehen
+        }
+        else if (c == '#') {
+            inComment = true;
+        }
+        else if (c != ' ' && c != '\n' && c != '\r' && c != '\t' && c != '\v' && c != '\f') {
+            return -1;
+        }
+        p++;
+    }
+
+    reader->position = p;
+    reader->end = end;
+    if (!hasDigits) {
+        return -1;
+    }
+    *value = result;
+    return 0;
+}
+
+/**
+ * @brief Liest die ASCII-Pixeldaten eines P3-Bildes über einen großen Lesepuffer
+ *
+ * Ersetzt `fscanf` pro Pixel durch einen eigenen Tokenizer, der weder Formatstring 
+ * noch Locale auswerten muss. Übliche Werte (1-3 Ziffern, einfache Trennzeichen) werden 
+ * direkt aus dem Puffer gelesen, alles andere über `read_ascii_value()`.
+ *
+ * @param file Datei, deren Position hinter dem maximalen Farbwert steht
+ * @param pixels Zielspeicher für `count` Pixel, `color16_t` wenn `wide` gesetzt ist, sonst `color_t`
+ * @param count Anzahl der zu lesenden Pixel
+ * @param wide Bild mit 16 Bit pro Kanal
+ * @return int 0 bei Erfolg, -1 bei fehlerhaften oder fehlenden Pixeldaten
+ */
+static int read_ascii_pixels(FILE *file, color_t *pixels, size_t count, bool wide) {
+    ascii_reader_t reader = {0};
+    reader.file = file;
+    reader.buffer = malloc(ASCII_READ_BUFFER_SIZE);
+    if (!reader.buffer) {
+        log_message(LOG_ERROR, "Memory allocation failed!\n");
+        return -1;
+    }
+    reader.position = reader.buffer;
+    reader.end = reader.buffer;
+
+    const uint8_t *p = reader.position;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t sample[3];
+        for (int c = 0; c < 3; c++) {
+            size_t used = 0;
+            if (reader.end - p >= 8) {
+                used = parse_short_value(p, &sample[c]);
+            }
+            if (used) {
+                p += used;
+                continue;
+            }
+            reader.position = p;
+            if (read_ascii_value(&reader, &sample[c]) != 0) {
+                log_message(LOG_ERROR, "Failed to read pixel data.\n");
+                free(reader.buffer);
+                return -1;
+            }
+            p = reader.position;
+        }
+        if (wide) {
+            color16_t *pixel = (color16_t *)pixels + i;
+            pixel->red = (uint16_t)sample[0];
+            pixel->green = (uint16_t)sample[1];
+            pixel->blue = (uint16_t)sample[2];
+            pixel->alpha = 0xffff;
+            continue;
+        }
+        pixels[i].red = (uint8_t)sample[0];
+        pixels[i].green = (uint8_t)sample[1];
+        pixels[i].blue = (uint8_t)sample[2];
+        pixels[i].alpha = 0xff;
+    }
+    free(reader.buffer);
+    return 0;
+}
+
+/**
+ * @brief Überspringt den Rest der aktuellen Zeile (Kommentare im PAM-Header)
+ */
+static void skip_line(FILE *file) {
+    int c;
+    do {
+        c = fgetc(file);
+    } while (c != EOF && c != '\n');
+}
+
+/**
+ * @brief Liest den Header eines PAM-Bildes (P7) nach der Kennung bis einschließlich ENDHDR
+ *
+ * Unterstützt werden 8 Bit pro Kanal mit TUPLTYPE RGB_ALPHA (DEPTH 4, Format "P7") & RGB (DEPTH 3).
+ * RGB-Bilder haben dieselben Pixeldaten wie P6 & werden als "P6" gelesen.
+ *
+ * @return int 0 bei Erfolg, -1 bei fehlerhaftem oder nicht unterstütztem Header
+ */
+static int read_pam_header(FILE *file, picture_t *target) {
+    char keyword[16];
+    char tupleType[32] = "";
+    uint32_t depth = 0;
+    target->x = 0;
+    target->y = 0;
+    target->maxColorValue = 0;
+
+    while (fscanf(file, "%15s", keyword) == 1) {
+        int read = 1;
+        if (keyword[0] == '#') {
+            skip_line(file);
+        }
+        else if (strcmp(keyword, "ENDHDR") == 0) {
+            skip_line(file);    // Die Pixeldaten beginnen nach dem Zeilenumbruch
+            if (target->x == 0 || target->y == 0 || target->maxColorValue == 0 || target->maxColorValue > 255) {
+                log_message(LOG_ERROR, "Unsupported PAM image: only 8-bit RGB and RGB_ALPHA are supported.\n");
+                return -1;
+            }
+            if (depth == 4 && (tupleType[0] == '\0' || strcmp(tupleType, "RGB_ALPHA") == 0)) {
+                return 0;
+            }
+            if (depth == 3 && (tupleType[0] == '\0' || strcmp(tupleType, "RGB") == 0)) {
+                target->format[1] = '6';
+                return 0;
+            }
+            log_message(LOG_ERROR, "Unsupported PAM image: only 8-bit RGB and RGB_ALPHA are supported.\n");
+            return -1;
+        }
+        else if (strcmp(keyword, "WIDTH") == 0) {
+            read = fscanf(file, "%u", &target->x);
+        }
+        else if (strcmp(keyword, "HEIGHT") == 0) {
+            read = fscanf(file, "%u", &target->y);
+        }
+        else if (strcmp(keyword, "DEPTH") == 0) {
+            read = fscanf(file, "%u", &depth);
+        }
+        else if (strcmp(keyword, "MAXVAL") == 0) {
+            read = fscanf(file, "%u", &target->maxColorValue);
+        }
+        else if (strcmp(keyword, "TUPLTYPE") == 0) {
+            read = fscanf(file, "%31s", tupleType);
+        }
+        else {
+            read = 0;
+        }
+        if (read != 1) {
+            log_message(LOG_ERROR, "Invalid PAM header.\n");
+            return -1;
+        }
+    }
+    log_message(LOG_ERROR, "Invalid PAM header.\n");
+    return -1;
+}
+
+int read_picture_header(FILE *file, picture_t *target) {
+    if (!file || !target) {
+        return -1;
+    }
+    char line[500];
+
+    // Lese das Format (P3, P6 oder P7)
+    int formatValid = fscanf(file, "%2s", target->format);    // P3, P6 oder P7
+    if (formatValid != 1 || (target->format[0] != 'P') 
+        || ((target->format[1] != '3' && target->format[1] != '6' && target->format[1] != '7'))) {
+        log_message(LOG_ERROR, "Unsopported image format.\n");
         return -1; 
     }
+    if (target->format[1] == '7') {
+        return read_pam_header(file, target);
+    }
     
     // Lese Breite & Höhe 
-    if (fscanf(file, "%u %u", &target->y, &target->x) != 2) {
-        printf("Failed to read image dimensions.\n");
-        fclose(file);
+    if (fscanf(file, "%u %u", &target->x, &target->y) != 2) {
+        log_message(LOG_ERROR, "Failed to read image dimensions.\n");
         return -1; 
     }
 
     // Lese den maximalen Farbwert 
     if (fscanf(file, "%u", &target->maxColorValue) != 1) {
-        printf("Failed to read max color value.\n");
-
-        fclose(file);
+        log_message(LOG_ERROR, "Failed to read max color value.\n");
+        return -1;
+    }
+    if (target->maxColorValue == 0 || target->maxColorValue > 65535) {
+        log_message(LOG_ERROR, "Unsupported max color value %u.\n", target->maxColorValue);
         return -1;
     }
     
-    // Lese Header & überspringe Kommentare 
-    while (fgets(line, sizeof(line), file) != NULL) {
+    // Lese Header & überspringe Kommentare (P3 überspringt Kommentare beim Parsen der Pixeldaten selbst)
+    while (target->format[1] == '6' && fgets(line, sizeof(line), file) != NULL) {
         if (line[0] == '#') {
             continue;
         }
         break;
     }
+    return 0;
+}
+
+int load_picture_from_path(const char* path, picture_t *target) {
+    if (!target) {
+        return -1;
+    }
+    size_t capacity = 0;
+    target->pixels = NULL;
+    return load_picture_reusing(path, target, &capacity);
+}
+
+void premultiply_alpha(picture_t *target) {
+    if (!target || !target->pixels || !picture_has_alpha(target)) {
+        return;
+    }
+    size_t count = (size_t)target->x * target->y;
+    for (size_t i = 0; i < count; i++) {
+        color_t *pixel = &target->pixels[i];
+        pixel->red = div255((uint32_t)pixel->red * pixel->alpha);
+        pixel->green = div255((uint32_t)pixel->green * pixel->alpha);
+        pixel->blue = div255((uint32_t)pixel->blue * pixel->alpha);
+    }
+}
+
+int load_overlay_from_path(const char *path, picture_t *target) {
+    int status = load_picture_from_path(path, target);
+    if (status == 0 && picture_is_16bit(target)) {
+        return -2;
+    }
+    premultiply_alpha(target);
+    return status;
+}
+
+int load_picture_reusing(const char* path, picture_t *target, size_t *capacity) {
+    if (!path || !target || !capacity) {
+        return -1;
+    }
+    FILE *file = fopen(path, "rb");  
     
-    // Speicher für Pixel zuweisen
-    uint32_t dataSegmentSize = target->x * target->y;
-    if (dataSegmentSize == 0) {
-        printf("Invalid image size.\n");
-        fclose(file);
+    if (file == NULL) {
+        log_message(LOG_ERROR, "ERROR opening file %s: %s\n", path, strerror(errno));
         return -1;
     }
-    printf("Allocating %u kB\n", dataSegmentSize / 1024);
-    target->pixels = malloc(dataSegmentSize * sizeof(color_t));
-    if (target->pixels == NULL) {
-        printf("Memory allocation failed!\n");
-        fclose(file);
+    int status = load_picture_from_file(file, target, capacity);
+    fclose(file);
+    return status;
+}
+
+int load_picture_from_file(FILE *file, picture_t *target, size_t *capacity) {
+    if (!file || !target || !capacity) {
+        return -1;
+    }
+    double start = stats_now();
+    long startOffset = ftell(file);
+    if (read_picture_header(file, target) != 0) {
+        return -1;
+    }
+    stats_span("parse header", "io", start);
+    start = stats_now();
+
+    // Speicher für Pixel zuweisen (Pixelanzahl in size_t, Überlauf wird abgefangen)
+    size_t dataSegmentSize;
+    if (pixel_count(target->x, target->y, &dataSegmentSize) != 0) {
+        log_message(LOG_ERROR, "Invalid image size.\n");
         return -1;
     }
+    // Vorhandenen Puffer wiederverwenden, wenn er groß genug ist (16-Bit-Pixel belegen zwei color_t)
+    bool wide = picture_is_16bit(target);
+    size_t bufferSize = picture_buffer_size(target);
+    if (*capacity < bufferSize) {
+        log_message(LOG_INFO, "Allocating %zu kB\n", bufferSize / 1024);
+        if (pixel_buffer_reserve(&target->pixels, capacity, bufferSize) != 0) {
+            log_message(LOG_ERROR, "Memory allocation failed!\n");
+            return -1;
+        }
+    }
 
     // Pixeldaten lesen (für jedes Pixel werden RGB-Farbkomponente einzeln gelesen)
     if (target->format[1] == '3') {    // ASCII
-       for (uint32_t i = 0; i < dataSegmentSize; i++) {
-            int red, green, blue;
-            if (fscanf(file, "%d %d %d", &red, &green, &blue) != 3) {
-                printf("Failed to read pixel data.\n");
-                free(target->pixels);
-                target->pixels = NULL;
-                fclose(file);
-                return -1;
-            }
-            target->pixels[i].red = (uint8_t)red;
-            target->pixels[i].green = (uint8_t)green; 
-            target->pixels[i].blue = (uint8_t)blue;
-        }  
+        if (read_ascii_pixels(file, target->pixels, dataSegmentSize, wide) != 0) {
+            pixel_buffer_free(target->pixels);
+            target->pixels = NULL;
+            *capacity = 0;
+            return -1;
+        }
     }
     else {    // Binärmodus
-        for (uint32_t i = 0; i < dataSegmentSize; i++) {
-            target->pixels[i].red = fgetc(file);
-            target->pixels[i].green = fgetc(file);
-            target->pixels[i].blue = fgetc(file);
+        bool alpha = picture_has_alpha(target);
+        int status = check_binary_size(file, dataSegmentSize, wide ? 6 : (alpha ? 4 : 3));
+        if (status == 0 && alpha) {
+            // RGBA-Quadrupel liegen in der Datei wie `color_t` im Speicher
+            status = fread(target->pixels, sizeof(color_t), dataSegmentSize, file) == dataSegmentSize ? 0 : -1;
+        }
+        else if (status == 0) {
+            status = wide ? read_binary_pixels16(file, (color16_t *)target->pixels, dataSegmentSize)
+                          : read_binary_pixels(file, target->pixels, dataSegmentSize);
+        }
+        if (status != 0) {
+            pixel_buffer_free(target->pixels);
+            target->pixels = NULL;
+            *capacity = 0;
+            return -1;
         }
     }
-    fclose(file);
+    long endOffset = ftell(file);
+    stats_count_io(endOffset > startOffset && startOffset >= 0 ? (uint64_t)(endOffset - startOffset) : 0, 0);
+    stats_span("decode pixels", "io", start);
     return 0;
 }
 
+int write_binary_pixels(FILE *file, const color_t *pixels, size_t count) {
+    uint8_t *chunk = malloc(IO_CHUNK_PIXELS * 3);
+    if (!chunk) {
+        return -3;
+    }
+
+    for (size_t done = 0; done < count; ) {
+        size_t n = count - done;
+        if (n > IO_CHUNK_PIXELS) {
+            n = IO_CHUNK_PIXELS;
+        }
+
+        // color_t in RGB-Tripel packen (Alpha wird nicht geschrieben)
+        const color_t *in = pixels + done;
+        for (size_t i = 0; i < n; i++) {
+            chunk[3 * i] = in[i].red;
+            chunk[3 * i + 1] = in[i].green;
+            chunk[3 * i + 2] = in[i].blue;
+        }
+        if (fwrite(chunk, 3, n, file) != n) {
+            free(chunk);
+            return -3;
+        }
+        done += n;
+    }
+    free(chunk);
+    return 0;
+}
+
+int write_binary_pixels16(FILE *file, const color16_t *pixels, size_t count) {
+    uint8_t *chunk = malloc(IO_CHUNK_PIXELS * 6);
+    if (!chunk) {
+        return -3;
+    }
+
+    for (size_t done = 0; done < count; ) {
+        size_t n = count - done;
+        if (n > IO_CHUNK_PIXELS) {
+            n = IO_CHUNK_PIXELS;
+        }
+
+        // color16_t in Big-Endian-Kanäle packen (Alpha wird nicht geschrieben)
+        const color16_t *in = pixels + done;
+        for (size_t i = 0; i < n; i++) {
+            uint8_t *out = &chunk[6 * i];
+            out[0] = (uint8_t)(in[i].red >> 8);
+            out[1] = (uint8_t)in[i].red;
+            out[2] = (uint8_t)(in[i].green >> 8);
+            out[3] = (uint8_t)in[i].green;
+            out[4] = (uint8_t)(in[i].blue >> 8);
+            out[5] = (uint8_t)in[i].blue;
+        }
+        if (fwrite(chunk, 6, n, file) != n) {
+            free(chunk);
+            return -3;
+        }
+        done += n;
+    }
+    free(chunk);
+    return 0;
+}
+
+// Zweistellige Dezimaldarstellung aller Werte 0..99, Wert v steht an Position 2*v
+static const char DIGIT_PAIRS[] = 
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * @brief Schreibt einen Farbwert als Dezimalzahl ohne führende Nullen (wie `%d`)
+ *
+ * @param out Zielposition im Puffer (mindestens 3 Bytes frei)
+ * @param value Der Farbwert
+ * @return char* Position hinter der letzten geschriebenen Ziffer
+ */
+static inline char *format_sample(char *out, uint8_t value) {
+    if (value >= 100) {
+        *out++ = (char)('0' + value / 100);
+        value %= 100;
+        *out++ = DIGIT_PAIRS[2 * value];
+        *out++ = DIGIT_PAIRS[2 * value + 1];
+    }
+    else if (value >= 10) {
+        *out++ = DIGIT_PAIRS[2 * value];
+        *out++ = DIGIT_PAIRS[2 * value + 1];
+    }
+    else {
+        *out++ = (char)('0' + value);
+    }
+    return out;
+}
+
+/**
+ * @brief Schreibt einen 16-Bit-Farbwert als Dezimalzahl ohne führende Nullen
+ *
+ * @param out Zielposition im Puffer (mindestens 5 Bytes frei)
+ * @param value Der Farbwert
+ * @return char* Position hinter der letzten geschriebenen Ziffer
+ */
+static char *format_sample16(char *out, uint16_t value) {
+    if (value < 100) {
+        return format_sample(out, (uint8_t)value);
+    }
+    // Führende Stellen ohne Nullen, die letzten beiden Stellen immer zweistellig
+    out = format_sample16(out, value / 100);
+    *out++ = DIGIT_PAIRS[2 * (value % 100)];
+    *out++ = DIGIT_PAIRS[2 * (value % 100) + 1];
+    return out;
+}
+
+/**
+ * @brief Schreibt 16-Bit-Pixel im ASCII-Format (P3), wie `write_ascii_pixels()`
+ */
+static int write_ascii_pixels16(FILE *file, const color16_t *pixels, size_t count) {
+    char *chunk = malloc(IO_CHUNK_PIXELS * 18);    // höchstens "65535 65535 65535\n" pro Pixel
+    if (!chunk) {
+        return -3;
+    }
+
+    for (size_t done = 0; done < count; ) {
+        size_t n = count - done;
+        if (n > IO_CHUNK_PIXELS) {
+            n = IO_CHUNK_PIXELS;
+        }
+
+        char *out = chunk;
+        const color16_t *in = pixels + done;
+        for (size_t i = 0; i < n; i++) {
+            out = format_sample16(out, in[i].red);
+            *out++ = ' ';
+            out = format_sample16(out, in[i].green);
+            *out++ = ' ';
+            out = format_sample16(out, in[i].blue);
+            *out++ = '\n';
+        }
+        size_t length = (size_t)(out - chunk);
+        if (fwrite(chunk, 1, length, file) != length) {
+            free(chunk);
+            return -3;
+        }
+        done += n;
+    }
+    free(chunk);
+    return 0;
+}
+
+/**
+ * @brief Schreibt die Pixel im ASCII-Format (P3) über einen Zwischenpuffer
+ *
+ * Erzeugt byte-identische Ausgabe zu `fprintf("%d %d %d\n")` pro Pixel, 
+ * formatiert die Werte aber über eine Ziffern-Tabelle.
+ *
+ * @param file Zieldatei, der Header wurde bereits geschrieben
+ * @param pixels Die zu schreibenden Pixel
+ * @param count Anzahl der Pixel
+ * @return int 0 bei Erfolg, -3 bei Speicher- oder Schreibfehlern
+ */
+static int write_ascii_pixels(FILE *file, const color_t *pixels, size_t count) {
+    char *chunk = malloc(IO_CHUNK_PIXELS * 12);    // höchstens "255 255 255\n" pro Pixel
+    if (!chunk) {
+        return -3;
+    }
+
+    for (size_t done = 0; done < count; ) {
+        size_t n = count - done;
+        if (n > IO_CHUNK_PIXELS) {
+            n = IO_CHUNK_PIXELS;
+        }
+
+        char *out = chunk;
+        const color_t *in = pixels + done;
+        for (size_t i = 0; i < n; i++) {
+            out = format_sample(out, in[i].red);
+            *out++ = ' ';
+            out = format_sample(out, in[i].green);
+            *out++ = ' ';
+            out = format_sample(out, in[i].blue);
+            *out++ = '\n';
+        }
+        size_t length = (size_t)(out - chunk);
+        if (fwrite(chunk, 1, length, file) != length) {
+            free(chunk);
+            return -3;
+        }
+        done += n;
+    }
+    free(chunk);
+    return 0;
+}
+
+int write_picture_header(FILE *file, const picture_t *target) {
+    if (!file || !target) {
+        return -1;
+    }
+    if (picture_has_alpha(target)) {
+        int written = fprintf(file, "P7\nWIDTH %u\nHEIGHT %u\nDEPTH 4\nMAXVAL %u\nTUPLTYPE RGB_ALPHA\nENDHDR\n",
+                              target->x, target->y, target->maxColorValue);
+        return written < 0 ? -3 : 0;
+    }
+    int written = fprintf(file, "%s\n", target->format);              // Format (P3 oder P6)
+    written |= fprintf(file, "%u %u\n", target->x, target->y);        // Breite und Höhe
+    written |= fprintf(file, "%u\n", target->maxColorValue);          // Maximaler Farbwert
+    return written < 0 ? -3 : 0;
+}
+
 int generate_file_from_picture(const char* path, picture_t *target) { 
     if (!path ||!target) {
         return -1;
     }
-    uint32_t numPixels = target->x * target->y;
     FILE *file = fopen(path, "wb"); 
     if (file == NULL) {
         return -2;
     }
+    int status = write_picture_to_file(file, target);
+    if (fclose(file) != 0) {
+        status = -3;
+    }
+    return status;
+}
+
+int write_picture_to_file(FILE *file, const picture_t *target) {
+    if (!file || !target) {
+        return -1;
+    }
+    if (target->format[1] != '6' && target->format[1] != '3' && !picture_has_alpha(target)) {
+        return -1;
+    }
+    double start = stats_now();
+    size_t numPixels = (size_t)target->x * target->y;
+    long startOffset = ftell(file);
 
     // Header schreiben
-    fprintf(file, "%s\n", target->format);             // Format (P3 oder P6)
-    fprintf(file, "%u %u\n", target->y, target->x);    // Breite und Höhe
-    fprintf(file, "%u\n", target->maxColorValue);      // Maximaler Farbwert
+    int status = write_picture_header(file, target);
+    if (status) {
+        return status;
+    }
     
-    // Pixel-Daten schreiben
+    // Pixel-Daten blockweise in einen Puffer packen & mit wenigen großen Schreibzugriffen ausgeben
+    bool wide = picture_is_16bit(target);
     if (target->format[1] == '6') {    // Binär
-        for (uint32_t i = 0; i < numPixels; i++) {
-            fwrite(&target->pixels[i].red, sizeof(uint8_t), 1, file);
-            fwrite(&target->pixels[i].green, sizeof(uint8_t), 1, file);
-            fwrite(&target->pixels[i].blue, sizeof(uint8_t), 1, file);
-        }  
+        status = wide ? write_binary_pixels16(file, (const color16_t *)target->pixels, numPixels)
+                      : write_binary_pixels(file, target->pixels, numPixels);
+    }
+    else if (picture_has_alpha(target)) {    // PAM mit Alpha
+        status = fwrite(target->pixels, sizeof(color_t), numPixels, file) == numPixels ? 0 : -3;
     }
     else if (target->format[1] == '3') {    // ASCII
-        for (uint32_t i = 0; i < numPixels; i++) {
-            fprintf(file, "%d %d %d\n", 
-                    target->pixels[i].red,
-                    target->pixels[i].green,
-                    target->pixels[i].blue);
+        status = wide ? write_ascii_pixels16(file, (const color16_t *)target->pixels, numPixels)
+                      : write_ascii_pixels(file, target->pixels, numPixels);
+    }
+    if (fflush(file) != 0) {
+        status = -3;
+    }
+    long endOffset = ftell(file);
+    stats_count_io(0, endOffset > startOffset && startOffset >= 0 ? (uint64_t)(endOffset - startOffset) : 0);
+    stats_span("encode", "io", start);
+    return status;
+}
+
+int planar_buffer_size(uint32_t width, uint32_t height, size_t *count) {
+    size_t pixels;
+    if (!count || pixel_count(width, height, &pixels) != 0) {
+        return -1;
+    }
+    size_t stride = planar_stride(width);
+    if (stride > SIZE_MAX / 3 / height) {
+        return -1;
+    }
+    *count = (3 * stride * height + sizeof(color_t) - 1) / sizeof(color_t);
+    return 0;
+}
+
+void planar_attach(planar_t *target, color_t *buffer) {
+    target->stride = planar_stride(target->x);
+    target->buffer = buffer;
+    for (unsigned c = 0; c < 3; c++) {
+        target->planes[c] = (uint8_t *)buffer + c * target->stride * target->y;
+    }
+}
+
+/**
+ * @brief Legt den Puffer eines planaren Bildes mit gesetzten Abmessungen an
+ *
+ * @return int 0 bei Erfolg, -1 bei ungültiger Größe, -3 bei Speicherproblemen
+ */
+static int planar_alloc(planar_t *target) {
+    size_t count;
+    if (planar_buffer_size(target->x, target->y, &count) != 0) {
+        log_message(LOG_ERROR, "Invalid image size.\n");
+        return -1;
+    }
+    color_t *buffer = pixel_buffer_alloc(count);
+    if (!buffer) {
+        log_message(LOG_ERROR, "Memory allocation failed!\n");
+        return -3;
+    }
+    planar_attach(target, buffer);
+    return 0;
+}
+
+/**
+ * @brief Liest `target->y` Zeilen P6-Daten blockweise & verteilt die RGB-Tripel auf die Ebenen
+ */
+static int read_binary_planes(FILE *file, planar_t *target) {
+    uint32_t rowsPerChunk = target->x < IO_CHUNK_PIXELS ? IO_CHUNK_PIXELS / target->x : 1;
+    uint8_t *chunk = malloc((size_t)rowsPerChunk * target->x * 3);
+    if (!chunk) {
+        log_message(LOG_ERROR, "Memory allocation failed!\n");
+        return -1;
+    }
+
+    for (uint32_t y = 0; y < target->y; y += rowsPerChunk) {
+        uint32_t rows = target->y - y < rowsPerChunk ? target->y - y : rowsPerChunk;
+        size_t n = (size_t)rows * target->x;
+        if (fread(chunk, 3, n, file) != n) {
+            log_message(LOG_ERROR, "Failed to read pixel data.\n");
+            free(chunk);
+            return -1;
+        }
+        for (uint32_t row = 0; row < rows; row++) {
+            const uint8_t *in = chunk + (size_t)row * target->x * 3;
+            uint8_t *red = planar_row(target, 0, y + row);
+            uint8_t *green = planar_row(target, 1, y + row);
+            uint8_t *blue = planar_row(target, 2, y + row);
+            for (uint32_t x = 0; x < target->x; x++) {
+                red[x] = in[3 * x];
+                green[x] = in[3 * x + 1];
+                blue[x] = in[3 * x + 2];
+            }
         }
     }
-    fclose(file);
+    free(chunk);
     return 0;
 }
 
+int load_planar_from_path(const char *path, planar_t *target) {
+    if (!path || !target) {
+        return -1;
+    }
+    target->buffer = NULL;
+
+    // P3 ist selten & ohnehin durch das Parsen begrenzt: über ein gepacktes Bild laden
+    picture_t header = {0};
+    double start = stats_now();
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        log_message(LOG_ERROR, "ERROR opening file %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    int status = read_picture_header(file, &header);
+    if (status == 0 && (picture_is_16bit(&header) || picture_has_alpha(&header))) {
+        status = -2;
+    }
+    if (status == 0 && header.format[1] == '3') {
+        fclose(file);
+        picture_t packed = {0};
+        if (load_picture_from_path(path, &packed) != 0) {
+            return -1;
+        }
+        memcpy(target->format, packed.format, sizeof(target->format));
+        target->maxColorValue = packed.maxColorValue;
+        target->x = packed.x;
+        target->y = packed.y;
+        status = planar_alloc(target);
+        for (uint32_t y = 0; status == 0 && y < target->y; y++) {
+            const color_t *in = picture_row(&packed, y);
+            for (uint32_t x = 0; x < target->x; x++) {
+                planar_row(target, 0, y)[x] = in[x].red;
+                planar_row(target, 1, y)[x] = in[x].green;
+                planar_row(target, 2, y)[x] = in[x].blue;
+            }
+        }
+        pixel_buffer_free(packed.pixels);
+        return status ? -1 : 0;
+    }
+
+    if (status == 0) {
+        stats_span("parse header", "io", start);
+        start = stats_now();
+        memcpy(target->format, header.format, sizeof(target->format));
+        target->maxColorValue = header.maxColorValue;
+        target->x = header.x;
+        target->y = header.y;
+        status = planar_alloc(target);
+    }
+    if (status == 0) {
+        status = check_binary_size(file, (size_t)target->x * target->y, 3);
+    }
+    if (status == 0) {
+        status = read_binary_planes(file, target);
+    }
+    if (status == -1 || status == -3) {
+        pixel_buffer_free(target->buffer);
+        target->buffer = NULL;
+        status = -1;
+    }
+    if (status == 0) {
+        long bytesRead = ftell(file);
+        stats_count_io(bytesRead > 0 ? (uint64_t)bytesRead : 0, 0);
+        stats_span("decode pixels", "io", start);
+    }
+    fclose(file);
+    return status;
+}
+
+int generate_file_from_planar(const char *path, const planar_t *target) {
+    if (!path || !target || !target->buffer) {
+        return -1;
+    }
+
+    // P3: über ein gepacktes Bild & die vorhandenen ASCII-Routinen schreiben
+    if (target->format[1] != '6') {
+        picture_t packed = { .maxColorValue = target->maxColorValue, .x = target->x, .y = target->y };
+        memcpy(packed.format, target->format, sizeof(packed.format));
+        size_t count;
+        if (pixel_count(target->x, target->y, &count) != 0 || !(packed.pixels = pixel_buffer_alloc(count))) {
+            return -3;
+        }
+        for (uint32_t y = 0; y < target->y; y++) {
+            color_t *out = picture_row(&packed, y);
+            for (uint32_t x = 0; x < target->x; x++) {
+                out[x].red = planar_row(target, 0, y)[x];
+                out[x].green = planar_row(target, 1, y)[x];
+                out[x].blue = planar_row(target, 2, y)[x];
+                out[x].alpha = 0xff;
+            }
+        }
+        int status = generate_file_from_picture(path, &packed);
+        pixel_buffer_free(packed.pixels);
+        return status;
+    }
+
+    double start = stats_now();
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return -2;
+    }
+    picture_t header = { .maxColorValue = target->maxColorValue, .x = target->x, .y = target->y };
+    memcpy(header.format, target->format, sizeof(header.format));
+    int status = write_picture_header(file, &header);
+
+    // Zeilenweise aus den Ebenen zu RGB-Tripeln verschränken
+    uint8_t *chunk = malloc((size_t)target->x * 3);
+    if (!chunk) {
+        status = -3;
+    }
+    for (uint32_t y = 0; status == 0 && y < target->y; y++) {
+        const uint8_t *red = planar_row(target, 0, y);
+        const uint8_t *green = planar_row(target, 1, y);
+        const uint8_t *blue = planar_row(target, 2, y);
+        for (uint32_t x = 0; x < target->x; x++) {
+            chunk[3 * x] = red[x];
+            chunk[3 * x + 1] = green[x];
+            chunk[3 * x + 2] = blue[x];
+        }
+        if (fwrite(chunk, 3, target->x, file) != target->x) {
+            status = -3;
+        }
+    }
+    free(chunk);
+    long bytesWritten = ftell(file);
+    if (fclose(file) != 0) {
+        status = -3;
+    }
+    stats_count_io(0, bytesWritten > 0 ? (uint64_t)bytesWritten : 0);
+    stats_span("encode", "io", start);
+    return status;
+}
+
 int validate_output_path(const char *path) {
     const char *prefix = "new-";
     size_t prefixLen = strlen(prefix);
@@ -163,19 +1020,19 @@ int validate_output_path(const char *path) {
 
 color_t *get_pixel(const picture_t *target, uint32_t x, uint32_t y) {
     if (!target) {
-        printf("Cannot get pixel from NULL target\n");
+        log_message(LOG_ERROR, "Cannot get pixel from NULL target\n");
         return NULL;
     }
     
     if (target->y < 1 || target->x < 1) {
-        printf("Cannot get pixel from 0 size image\n");
+        log_message(LOG_ERROR, "Cannot get pixel from 0 size image\n");
         return NULL;
     }
 
     if (x > target->x - 1 || y > target->y - 1) {
         return NULL;
     }
-    return &target->pixels[x + y * target->y];    // Pixel spaltenweise berechnen
+    return get_pixel_unchecked(target, x, y);
 }
 
 
@@ -188,57 +1045,3 @@ bool are_same(double a, double b) {
 int compare(const void* a, const void* b) {
    return (*(uint8_t*)a - *(uint8_t*)b);
 }
-
-
-scale_t get_scale(picture_t *source, picture_t *target) {
-    scale_t scale; 
-    scale.x = (float)target->x / source->x;
-    scale.y = (float)target->y / source->y;
-    return scale; 
-}
-
-int scale_image(picture_t *source, scale_t scale) {
-    if (!source) {
-        return -1;
-    }
-    if (are_same(scale.x, 1.0) && are_same(scale.y, 1.0)) {
-        return 0;
-    }
-
-    // Neue Bildgröße berechnen
-    uint32_t newX = source->x * scale.x;
-    uint32_t newY = source->y * scale.y;
-
-    uint32_t dataSegmentSize = newX * newY;
-    if (dataSegmentSize < 1) {
-        return -2;
-    }
-
-    color_t *tempPixels = (color_t*)malloc(dataSegmentSize * sizeof(color_t));
-    if (!tempPixels) {
-        return -3;
-    }
-
-    for (uint32_t y = 0; y < newY; y++) {
-        for (uint32_t x = 0; x < newX; x++) {
-            int srcX = (int)(x / scale.x);  
-            int srcY = (int)(y / scale.y);
-
-            size_t offset = x + y * newX;
-        
-            color_t *currentTargetPixel = &tempPixels[offset];
-            color_t *srcPixel = get_pixel(source, srcX, srcY);
-            if(srcPixel) {
-                *currentTargetPixel = *srcPixel;
-            }
-        }
-    }
-
-    // Pixeldaten ersetzen
-    free(source->pixels);
-    source->pixels = tempPixels;
-    source->x = newX;
-    source->y = newY;
-
-    return 0; 
-}
\ No newline at end of file
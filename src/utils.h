@@ -3,10 +3,26 @@
 
 #include "core.h"
 
+/**
+ * @brief Setzt den Empfänger der Diagnosemeldungen für den ganzen Prozess
+ *
+ * Ohne Empfänger (Standard, auch in libimagefilter) werden die Meldungen verworfen, Fehler kommen 
+ * dann nur über die Rückgabewerte. Das Programm gibt sie auf stdout (LOG_INFO) & stderr (LOG_ERROR) aus.
+ *
+ * @param handler Der Empfänger, NULL verwirft alle Meldungen
+ */
+void set_log_handler(log_handler_t handler);
+
+/**
+ * @brief Formatiert eine Diagnosemeldung wie `printf()` & gibt sie an den Empfänger weiter
+ */
+void log_message(log_level_t level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
 /**
  * @brief Gibt das Pixel an der angegebenen Position im Bild zurück
  * 
- * Sortiert Pixel für das Median-Filter
+ * Die Pixel liegen zeilenweise (row-major) im Speicher, das Pixel (x, y) hat den Index `x + y * target->x`.
+ * Für heiße Schleifen ohne Prüfungen siehe `get_pixel_unchecked()` & `picture_row()`.
  *
  * @param target  Das Bild, aus dem das Pixel abgerufen werden soll
  * @param x Die x-Koordinate des Pixels im Bild (Breite)
@@ -16,25 +32,191 @@
  */
 color_t *get_pixel(const picture_t *target, uint32_t x, uint32_t y);
 
+/**
+ * @brief Gibt einen Zeiger auf das erste Pixel der Zeile y zurück
+ * 
+ * Ohne Prüfungen: der Aufrufer muss sicherstellen, dass `y < target->y` gilt. 
+ * Die Pixel einer Zeile liegen lückenlos hintereinander.
+ *
+ * @param target Das Bild
+ * @param y Die Zeile (Höhe)
+ * @return color_t* Zeiger auf das Pixel (0, y)
+ */
+static inline color_t *picture_row(const picture_t *target, uint32_t y) {
+    return &target->pixels[(size_t)y * target->x];
+}
+
+/**
+ * @brief Gibt das Pixel an der angegebenen Position ohne NULL- & Bereichsprüfung zurück
+ *
+ * @param target Das Bild
+ * @param x Die x-Koordinate (Breite), muss kleiner als `target->x` sein
+ * @param y Die y-Koordinate (Höhe), muss kleiner als `target->y` sein
+ * @return color_t* Zeiger auf das Pixel
+ */
+static inline color_t *get_pixel_unchecked(const picture_t *target, uint32_t x, uint32_t y) {
+    return &target->pixels[x + (size_t)y * target->x];
+}
+
+/**
+ * @brief Prüft, ob ein Bild 16 Bit pro Kanal hat (maxColorValue > 255)
+ *
+ * Solche Bilder speichern `color16_t`-Pixel im Puffer `target->pixels`, 8-Bit-Bilder bleiben bei `color_t`.
+ */
+static inline bool picture_is_16bit(const picture_t *target) {
+    return target->maxColorValue > 255;
+}
+
+/**
+ * @brief Gibt an, ob das Bild einen Alphakanal hat (PAM mit TUPLTYPE RGB_ALPHA, immer 8 Bit pro Kanal)
+ */
+static inline bool picture_has_alpha(const picture_t *target) {
+    return target->format[1] == '7';
+}
+
+/**
+ * @brief Teilt durch 255 mit Rundung, exakt für x <= 255 * 255 (ohne Division, auch in SIMD-Kerneln)
+ */
+static inline uint8_t div255(uint32_t x) {
+    x += 128;
+    return (uint8_t)((x + (x >> 8)) >> 8);
+}
+
+/**
+ * @brief Ein Kanal von "Overlay über Zielbild" mit vormultipliziertem Overlay-Wert: premultiplied + target * (1 - alpha)
+ */
+static inline uint8_t composite_channel(uint8_t target, uint8_t premultiplied, uint8_t alpha) {
+    return (uint8_t)(premultiplied + div255((uint32_t)target * (255u - alpha)));
+}
+
+/**
+ * @brief `composite_channel()` für 16-Bit-Zielbilder, `premultiplied` ist bereits auf 0..maxValue gestreckt
+ */
+static inline uint16_t composite_channel16(uint16_t target, uint16_t premultiplied, uint8_t alpha, uint32_t maxValue) {
+    uint32_t value = premultiplied + ((uint32_t)target * (255u - alpha) + 127) / 255;
+    return (uint16_t)(value < maxValue ? value : maxValue);
+}
+
+/**
+ * @brief Größe eines Pixels des Bildes in Bytes (`color_t` oder `color16_t`)
+ */
+static inline size_t picture_pixel_size(const picture_t *target) {
+    return picture_is_16bit(target) ? sizeof(color16_t) : sizeof(color_t);
+}
+
+/**
+ * @brief Größe des Pixelpuffers eines Bildes in `color_t`-Einheiten (für `pixel_buffer_alloc()`)
+ */
+static inline size_t picture_buffer_size(const picture_t *target) {
+    return (size_t)target->x * target->y * (picture_pixel_size(target) / sizeof(color_t));
+}
+
+/**
+ * @brief Gibt einen Zeiger auf das erste Pixel der Zeile y eines 16-Bit-Bildes zurück
+ *
+ * Ohne Prüfungen wie `picture_row()`, das Bild muss `picture_is_16bit()` erfüllen.
+ */
+static inline color16_t *picture_row16(const picture_t *target, uint32_t y) {
+    return (color16_t *)target->pixels + (size_t)y * target->x;
+}
+
+/**
+ * @brief Gibt die Zeile y unabhängig von der Farbtiefe als Bytezeiger zurück (zum Kopieren ganzer Zeilen)
+ */
+static inline uint8_t *picture_row_bytes(const picture_t *target, uint32_t y) {
+    return (uint8_t *)target->pixels + (size_t)y * target->x * picture_pixel_size(target);
+}
+
+/**
+ * @brief Bytes pro Zeile einer Ebene eines planaren Bildes (auf 64 Bytes aufgerundet)
+ */
+static inline size_t planar_stride(uint32_t width) {
+    return ((size_t)width + 63) / 64 * 64;
+}
+
+/**
+ * @brief Gibt Zeile `y` der Ebene `channel` (0 Rot, 1 Grün, 2 Blau) eines planaren Bildes zurück
+ */
+static inline uint8_t *planar_row(const planar_t *target, unsigned channel, uint32_t y) {
+    return target->planes[channel] + (size_t)y * target->stride;
+}
+
+/**
+ * @brief Berechnet die Größe des Puffers für ein planares Bild mit Überlaufprüfung
+ *
+ * @param width Breite
+ * @param height Höhe
+ * @param count Erhält die Größe in `color_t`-Einheiten (für `pixel_buffer_alloc()`)
+ * @return int 0 bei Erfolg, -1 wenn das Bild leer oder zu groß ist
+ */
+int planar_buffer_size(uint32_t width, uint32_t height, size_t *count);
+
+/**
+ * @brief Setzt `stride` & die Ebenenzeiger eines planaren Bildes auf den Puffer `buffer`
+ *
+ * `target->x` & `target->y` müssen gesetzt sein, der Puffer muss `planar_buffer_size()` Einheiten fassen.
+ *
+ * @param target Das Bild
+ * @param buffer Der Puffer, wird zu `target->buffer`
+ */
+void planar_attach(planar_t *target, color_t *buffer);
+
+/**
+ * @brief Lädt ein PPM-Bild mit 8 Bit pro Kanal direkt in getrennte Farbebenen
+ *
+ * P6-Daten werden blockweise gelesen & ohne Umweg über `color_t` auf die Ebenen verteilt, 
+ * P3-Bilder werden über `load_picture_from_path()` geladen & danach umgewandelt.
+ *
+ * @param path Der Dateipfad zum Bild
+ * @param target Erhält Format, Abmessungen & den Puffer (mit `pixel_buffer_free()` freigeben)
+ * @return int 0 bei Erfolg, -1 bei einem Fehler, -2 bei Bildern mit 16 Bit pro Kanal oder Alphakanal (PAM)
+ */
+int load_planar_from_path(const char *path, planar_t *target);
+
+/**
+ * @brief Schreibt ein planares Bild wie `generate_file_from_picture()` als PPM-Datei
+ *
+ * @param path Der Dateipfad
+ * @param target Das Bild
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben, -2 beim Öffnen der Datei, -3 beim Schreiben
+ */
+int generate_file_from_planar(const char *path, const planar_t *target);
+
 /**
  * @brief Generiert eine Bilddatei im PPM-Format (P3 oder P6) aus den Bilddaten und speichert sie unter dem angegebenen Pfad.
  * 
  * Schreibt die Bilddaten aus der target Struktur in eine Datei im PPM-Format. 
  * Je nach dem Bildformat (P3/P6) werden die Pixel entweder im ASCII- oder im Binärformat gespeichert.
+ * Die Pixel werden blockweise in einen Zwischenpuffer gepackt und mit wenigen großen `fwrite`-Aufrufen geschrieben.
  *
  * @param path Der Dateipfad, unter dem das Bild gespeichert werden soll
  * @param target Die Struktur, die das Bild enthält und die in die Datei geschrieben wird
  * @return int 0 bei Erfolg, andernfalls ein Fehlercode:
  *            -1: Ungültige Eingabedaten 
  *            -2: Fehler beim Öffnen der Datei
+ *            -3: Fehler beim Schreiben der Pixeldaten
  */
 int generate_file_from_picture(const char *path, picture_t *target);
 
+/**
+ * @brief Schreibt ein Bild wie `generate_file_from_picture()` in eine bereits geöffnete Datei
+ *
+ * Auch für Speicherdateien von `open_memstream()` (Bibliothek, `imagefilter_encode()`). Die Datei wird 
+ * nicht geschlossen, aber geleert.
+ *
+ * @param file Die zum Schreiben geöffnete Datei
+ * @param target Das Bild
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben oder unbekanntem Format (weder P3, P6 noch PAM
+ *             mit Alpha), -3 bei Speicher- oder Schreibfehlern
+ */
+int write_picture_to_file(FILE *file, const picture_t *target);
+
 /**
  * @brief Lädt ein Bild von einem angegebenen Dateipfad und speichert es im target
  *
- * lädt ein Bild im PPM-Format (P3 oder P6) aus einer Datei. 
+ * lädt ein Bild im PPM-Format (P3 oder P6) oder als PAM (P7, RGB oder RGB_ALPHA mit 8 Bit) aus einer Datei. 
  Es werden die Bilddimensionen, der maximal mögliche Farbwert und die Pixeldaten aus der Datei gelesen.
+ * Bei einem maximalen Farbwert > 255 werden die Pixel als `color16_t` gespeichert (siehe `picture_is_16bit()`).
  *
  * @param path Der Dateipfad zum Bild, das geladen werden soll.
  * @param target Die Struktur, in der das geladene Bild gespeichert wird. 
@@ -43,16 +225,116 @@ int generate_file_from_picture(const char *path, picture_t *target);
 int load_picture_from_path(const char *path, picture_t *target);
 
 /**
- * @brief Berechnet das Skalierungsverhältnis zwischen zwei Bildern
- * 
- * Ermittelt die Skalierungsfaktoren für die x- und y-Achse, basierend auf 
- * den Abmessungen der Quell- und Zielbilder.
+ * @brief Multipliziert die Farbkanäle eines Bildes mit Alphakanal einmal mit Alpha (vormultipliziertes Alpha)
+ *
+ * Bilder ohne Alphakanal bleiben unverändert.
+ *
+ * @param target Das Bild
+ */
+void premultiply_alpha(picture_t *target);
+
+/**
+ * @brief Lädt ein Overlay-Bild: wie `load_picture_from_path()`, mit vormultipliziertem Alpha (siehe `premultiply_alpha()`)
+ *
+ * @param path Der Dateipfad
+ * @param target Erhält das Bild, bei Fehlern kann `target->pixels` trotzdem gesetzt sein
+ * @return int 0 bei Erfolg, -2 bei Overlay-Bildern mit 16 Bit pro Kanal, sonst Fehlercode von `load_picture_from_path()`
+ */
+int load_overlay_from_path(const char *path, picture_t *target);
+
+/**
+ * @brief Lädt ein Bild wie `load_picture_from_path()`, verwendet dabei aber den vorhandenen Pixelpuffer wieder
+ *
+ * Reicht der Puffer `target->pixels` mit `*capacity` Pixeln nicht aus, wird er vergrößert. 
+ * So kann derselbe Puffer für viele Bilder genutzt werden (Batch-Modus). Bei Fehlern in den
+ * Pixeldaten wird der Puffer freigegeben & `*capacity` auf 0 gesetzt.
+ *
+ * @param path Der Dateipfad zum Bild, das geladen werden soll
+ * @param target Das Bild, `target->pixels` ist NULL oder ein Puffer mit `*capacity` Pixeln
+ * @param capacity Größe des Puffers in `color_t`-Einheiten (ein 16-Bit-Pixel belegt zwei), wird bei Vergrößerung aktualisiert
+ * @return int 0 bei Erfolg, andernfalls -1 bei einem Fehler
+ */
+int load_picture_reusing(const char *path, picture_t *target, size_t *capacity);
+
+/**
+ * @brief Lädt ein Bild wie `load_picture_reusing()` aus einer bereits geöffneten Datei
  *
- * @param source Zeiger auf das Quellbild
- * @param target Zeiger auf das Zielbild
- * @return scale_t Struktur mit den berechneten Skalierungsfaktoren
+ * Auch für Speicherdateien von `fmemopen()` (Bibliothek, `imagefilter_decode()`). Die Datei wird nicht 
+ * geschlossen & steht danach hinter den Pixeldaten.
+ *
+ * @param file Die zum Lesen geöffnete Datei, Position am Anfang des Headers
+ * @param target Das Bild, `target->pixels` ist NULL oder ein Puffer mit `*capacity` Pixeln
+ * @param capacity Größe des Puffers in `color_t`-Einheiten, wird bei Vergrößerung aktualisiert
+ * @return int 0 bei Erfolg, andernfalls -1 bei einem Fehler
  */
-scale_t get_scale(picture_t *source, picture_t *target);
+int load_picture_from_file(FILE *file, picture_t *target, size_t *capacity);
+
+/**
+ * @brief Liest den Header eines PPM- oder PAM-Bildes (Format, Breite, Höhe, maximaler Farbwert)
+ *
+ * PAM-Bilder (P7) werden mit 8 Bit pro Kanal & TUPLTYPE RGB_ALPHA (Format "P7") oder RGB (Format "P6") 
+ * unterstützt. Danach steht die Datei am Anfang der Pixeldaten. Die Pixel werden nicht gelesen, `target->pixels` bleibt unverändert.
+ *
+ * @param file Die geöffnete Datei, Position am Dateianfang
+ * @param target Erhält Format & Abmessungen
+ * @return int 0 bei Erfolg, -1 bei ungültigem oder nicht unterstütztem Header (maximaler Farbwert außerhalb 1..65535)
+ */
+int read_picture_header(FILE *file, picture_t *target);
+
+/**
+ * @brief Liest `count` Pixel im Binärformat (P6) blockweise & entpackt die RGB-Tripel in `color_t`
+ *
+ * Prüft nicht vorab die Dateigröße, eine zu kurze Datei führt zu einem Lesefehler.
+ *
+ * @param file Datei, deren Position auf den nächsten Pixeldaten steht
+ * @param pixels Zielspeicher für `count` Pixel (Alpha wird auf 0xff gesetzt)
+ * @param count Anzahl der zu lesenden Pixel
+ * @return int 0 bei Erfolg, -1 bei Speicherproblemen oder Lesefehlern
+ */
+int read_binary_pixels(FILE *file, color_t *pixels, size_t count);
+
+/**
+ * @brief Liest `count` Pixel im Binärformat (P6) mit 2 Bytes pro Kanal (maxColorValue > 255)
+ *
+ * Die Kanäle stehen laut PPM-Spezifikation mit dem höchstwertigen Byte zuerst in der Datei.
+ *
+ * @param file Datei, deren Position auf den nächsten Pixeldaten steht
+ * @param pixels Zielspeicher für `count` Pixel (Alpha wird auf 0xffff gesetzt)
+ * @param count Anzahl der zu lesenden Pixel
+ * @return int 0 bei Erfolg, -1 bei Speicherproblemen oder Lesefehlern
+ */
+int read_binary_pixels16(FILE *file, color16_t *pixels, size_t count);
+
+/**
+ * @brief Schreibt den Header eines PPM-Bildes (Format, Breite, Höhe, maximaler Farbwert)
+ *
+ * Bilder mit Alphakanal erhalten einen PAM-Header (P7, TUPLTYPE RGB_ALPHA).
+ *
+ * @param file Die Zieldatei
+ * @param target Das Bild, dessen Header geschrieben wird
+ * @return int 0 bei Erfolg, -1 bei ungültigen Eingaben, -3 bei Schreibfehlern
+ */
+int write_picture_header(FILE *file, const picture_t *target);
+
+/**
+ * @brief Schreibt die Pixel als gepackte RGB-Tripel (P6) über einen Zwischenpuffer
+ *
+ * @param file Zieldatei, der Header wurde bereits geschrieben
+ * @param pixels Die zu schreibenden Pixel
+ * @param count Anzahl der Pixel
+ * @return int 0 bei Erfolg, -3 bei Speicher- oder Schreibfehlern
+ */
+int write_binary_pixels(FILE *file, const color_t *pixels, size_t count);
+
+/**
+ * @brief Schreibt 16-Bit-Pixel als RGB-Tripel mit 2 Bytes pro Kanal (höchstwertiges Byte zuerst)
+ *
+ * @param file Zieldatei, der Header wurde bereits geschrieben
+ * @param pixels Die zu schreibenden Pixel
+ * @param count Anzahl der Pixel
+ * @return int 0 bei Erfolg, -3 bei Speicher- oder Schreibfehlern
+ */
+int write_binary_pixels16(FILE *file, const color16_t *pixels, size_t count);
 
 /**
  * @brief Überprüft, ob ein Wort mit einem angegebenen Präfix beginnt
@@ -63,19 +345,6 @@ scale_t get_scale(picture_t *source, picture_t *target);
  */
 int starts_with(const char *word, const char *prefix);
 
-/**
- * @brief Skaliert ein Bild anhand eines angegebenen Skalierungsfaktors
- * 
- * Ändert die Größe eines Bildes, indem die Pixel entsprechend den 
- * Skalierungsfaktoren `scale.x` und `scale.y` neu berechnet werden. 
- * Jeder neue Pixel wird durch den entsprechenden Pixel aus dem Quellbild ersetzt 
- *
- * @param source Zeiger auf das Quellbild, das skaliert werden soll.
- * @param scale Struktur, die die Skalierungsfaktoren für x- und y-Achse enthält
- * @return int 0 bei Erfolg, -1 bei ungültigem Bild, -2 bei ungültiger Zielgröße, -3 bei Speicherproblemen
- */
-int scale_image(picture_t *source, scale_t scale);
-
 /**
  * @brief Überprüft, ob der angegebene Pfad mit "new-" beginnt und der Prefix "new-" im Pfad enthalten ist
  * 